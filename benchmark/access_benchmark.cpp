@@ -0,0 +1,222 @@
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <msp430.h>
+
+#include <msp430hal/cpu/flash_controller.h>
+#include <msp430hal/gpio/pin.h>
+#include <msp430hal/gpio/pin_group.h>
+#include <msp430hal/host/device.h>
+#include <msp430hal/peripherals/comparator.h>
+#include <msp430hal/timer/hwtimer.h>
+#include <msp430hal/timer/watchdog_timer.h>
+#include <msp430hal/usci/spi.h>
+#include <msp430hal/usci/usci.h>
+
+using namespace msp430hal;
+
+namespace
+{
+    /// \brief Register accesses performed by a single call of a HAL operation.
+    struct AccessCount
+    {
+        unsigned reads = 0;
+        unsigned writes = 0;
+        unsigned read_modify_writes = 0;
+    };
+
+    class AccessCounter : public host::AccessListener
+    {
+    public:
+        void onAccess(const host::AccessEvent& event) override
+        {
+            switch (event.kind)
+            {
+                case host::Access::read:
+                    ++m_count.reads;
+                    break;
+                case host::Access::write:
+                    ++m_count.writes;
+                    break;
+                case host::Access::read_modify_write:
+                    ++m_count.read_modify_writes;
+                    break;
+            }
+        }
+
+        [[nodiscard]]
+        const AccessCount& count() const { return m_count; }
+
+        void clear() { m_count = {}; }
+
+    private:
+        AccessCount m_count;
+    };
+
+    /// \brief A benchmarked HAL operation. Only the accesses of operation are counted, setup prepares the device state.
+    struct Benchmark
+    {
+        std::string name;
+        std::function<void()> setup;
+        std::function<void()> operation;
+    };
+
+    using Led = gpio::GPIOPins<gpio::port_1, gpio::p_0>;
+    using Leds = gpio::GPIOPins<gpio::port_1, gpio::p_0 | gpio::p_6>;
+    using Button = gpio::GPIOPins<gpio::port_1, gpio::p_3, gpio::Mode::input>;
+    using Group = gpio::PinGroup_t<Led, gpio::GPIOPins<gpio::port_2, gpio::p_1>, gpio::GPIOPins<gpio::port_2, gpio::p_5>>;
+    using UsciA0 = usci::Usci_t<usci::UsciModule::usci_a, 0>;
+    using UsciB0 = usci::Usci_t<usci::UsciModule::usci_b, 0>;
+    using Timer0 = timer::Timer_t<timer::TimerModule::timer_a, 0>;
+    using Display = usci::SPIDevice<gpio::GPIOPin<gpio::port_2, gpio::p_0>, usci::active_high_leading_edge,
+                                    usci::msb_8bit, 2>;
+    using Flash = usci::SPIDevice<gpio::GPIOPin<gpio::port_2, gpio::p_1>, usci::active_high_leading_edge,
+                                  usci::msb_8bit, 2>;
+    using Sensor = usci::SPIDevice<gpio::GPIOPin<gpio::port_2, gpio::p_2>, usci::active_high_leading_edge,
+                                   usci::msb_8bit, 16>;
+    using Adc = usci::SPIDevice<gpio::GPIOPin<gpio::port_2, gpio::p_3>, usci::active_low_trailing_edge,
+                                usci::msb_8bit, 2>;
+    using SpiBus = usci::SharedSPIBus<usci::UsciModule::usci_b, 0, usci::smclk, Display, Flash, Sensor, Adc>;
+
+    peripherals::Comparator comparator{};
+
+    std::vector<Benchmark> benchmarks()
+    {
+        auto none = [] {};
+        return {
+                {"GPIOPins::init(output)", none, [] { Led::init(); }},
+                {"GPIOPins::init(input)", none, [] { Button::init(); }},
+                {"GPIOPins::set", none, [] { Led::set(); }},
+                {"GPIOPins::clear", none, [] { Led::clear(); }},
+                {"GPIOPins::toggle", none, [] { Leds::toggle(); }},
+                {"GPIOPins::input", none, [] { Button::input(); }},
+                {"GPIOPins::switchFunction", none, [] { Led::switchFunction(gpio::PinFunction::primary_peripheral); }},
+                {"PinGroup_t::set", none, [] { Group::set(); }},
+                {"PinGroup_t::set<index>", none, [] { Group::set<2>(); }},
+                {"PinGroup_t::toggle", none, [] { Group::toggle(); }},
+                {"Usci_t::enableModule", none, [] { UsciA0::enableModule(); }},
+                {"Usci_t::disableModule", none, [] { UsciA0::disableModule(); }},
+                {"Usci_t::enableRxInterrupt", none, [] { UsciA0::enableRxInterrupt(); }},
+                {"Usci_t::enableInterrupts", none, [] { UsciB0::enableInterrupts(); }},
+                {"Usci_t::isRxInterruptPending", none, [] { UsciA0::isRxInterruptPending(); }},
+                {"SharedSPIBus::select(same settings)", [] { SpiBus::init(); }, [] { SpiBus::select<Flash>(); }},
+                {"SharedSPIBus::select(prescaler)", [] { SpiBus::init(); }, [] { SpiBus::select<Sensor>(); }},
+                {"SharedSPIBus::select(clock mode)", [] { SpiBus::init(); }, [] { SpiBus::select<Adc>(); }},
+                {"Timer_t::init", none, [] {
+                    Timer0::init(timer::TimerMode::up, timer::TimerClockSource::smclk, timer::TimerClockInputDivider::times_1);
+                }},
+                {"Timer_t::setOutputMode", none, [] { Timer0::setOutputMode<1>(timer::TimerOutputMode::reset_set); }},
+                {"Timer_t::setCompareValue", none, [] { Timer0::setCompareValue<1>(1000); }},
+                {"Timer_t::getCaptureValue", none, [] { Timer0::getCaptureValue<1>(); }},
+                {"Timer_t::enableCaptureCompareInterrupt", none, [] { Timer0::enableCaptureCompareInterrupt<0>(); }},
+                {"cpu::writeByte", [] { cpu::eraseSegment(0x1000); }, [] { cpu::writeByte(0x1000, 0x5a); }},
+                {"cpu::writeWord", [] { cpu::eraseSegment(0x1000); }, [] { cpu::writeWord(0x1002, 0x1234); }},
+                {"cpu::write<std::uint32_t>", [] { cpu::eraseSegment(0x1000); }, [] {
+                    cpu::write<std::uint32_t>(0x1004, 0xdeadbeef);
+                }},
+                {"cpu::eraseSegment", none, [] { cpu::eraseSegment(0x1000); }},
+                {"Comparator::setInvertingInput(ca_0)", none, [] {
+                    comparator.setInvertingInput(peripherals::ComparatorInput::ca_0);
+                }},
+                {"Comparator::setInvertingInput(vcc_05)", none, [] {
+                    comparator.setInvertingInput(peripherals::ComparatorInput::vcc_05);
+                }},
+                {"Comparator::setNonInvertingInput(ca_1)", none, [] {
+                    comparator.setNonInvertingInput(peripherals::ComparatorInput::ca_1);
+                }},
+                {"Comparator::enable", none, [] { comparator.enable(); }},
+        };
+    }
+
+    /// \brief Read the budget file. Each line contains the operation name followed by the allowed reads, writes and
+    /// read-modify-writes, separated by tabs. Lines starting with # are comments.
+    bool readBudgets(const char* path, std::map<std::string, AccessCount>& budgets)
+    {
+        std::ifstream file(path);
+        if (!file)
+            return false;
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (line.empty() || line[0] == '#')
+                continue;
+            std::size_t separator = line.find('\t');
+            if (separator == std::string::npos)
+                return false;
+            AccessCount budget;
+            std::istringstream counts(line.substr(separator + 1));
+            if (!(counts >> budget.reads >> budget.writes >> budget.read_modify_writes))
+                return false;
+            budgets[line.substr(0, separator)] = budget;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 2)
+    {
+        std::fprintf(stderr, "usage: %s <budget file>\n", argv[0]);
+        return 2;
+    }
+
+    std::map<std::string, AccessCount> budgets;
+    if (!readBudgets(argv[1], budgets))
+    {
+        std::fprintf(stderr, "could not read budget file %s\n", argv[1]);
+        return 2;
+    }
+
+    host::Device& device = host::device();
+    AccessCounter counter;
+    host::addAccessListener(&counter);
+
+    bool failed = false;
+    std::printf("%-44s %6s %6s %6s %8s  %s\n", "operation", "reads", "writes", "rmw", "cycles", "budget");
+    for (const Benchmark& benchmark : benchmarks())
+    {
+        device.powerOn();
+        timer::stopWatchdog();
+        benchmark.setup();
+
+        counter.clear();
+        std::uint64_t cycles = device.cycles();
+        benchmark.operation();
+        cycles = device.cycles() - cycles;
+        const AccessCount& count = counter.count();
+
+        std::string verdict;
+        auto budget = budgets.find(benchmark.name);
+        if (budget == budgets.end())
+        {
+            verdict = "MISSING";
+            failed = true;
+        }
+        else if (count.reads > budget->second.reads || count.writes > budget->second.writes ||
+                 count.read_modify_writes > budget->second.read_modify_writes)
+        {
+            verdict = "EXCEEDED (" + std::to_string(budget->second.reads) + " " + std::to_string(budget->second.writes) +
+                      " " + std::to_string(budget->second.read_modify_writes) + ")";
+            failed = true;
+        }
+        else if (count.reads < budget->second.reads || count.writes < budget->second.writes ||
+                 count.read_modify_writes < budget->second.read_modify_writes)
+            verdict = "ok, budget can be lowered";
+        else
+            verdict = "ok";
+
+        std::printf("%-44s %6u %6u %6u %8llu  %s\n", benchmark.name.c_str(), count.reads, count.writes,
+                    count.read_modify_writes, static_cast<unsigned long long>(cycles), verdict.c_str());
+    }
+
+    host::removeAccessListener(&counter);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,217 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <msp430hal/util/format.h>
+
+using namespace msp430hal;
+
+namespace
+{
+    /// \brief Collects the characters of one formatted number.
+    struct BufferSink
+    {
+        char buffer[32];
+        std::uint8_t length = 0;
+
+        void write(std::uint8_t byte)
+        {
+            buffer[length++] = static_cast<char>(byte);
+        }
+
+        [[nodiscard]]
+        std::string str() const { return std::string(buffer, length); }
+    };
+
+    /// \brief Division steps executed by the software division, one per quotient bit.
+    std::uint64_t division_steps = 0;
+
+    /// \brief Unsigned division by shifting and subtracting, as done by the libgcc runtime on MSP430 devices without
+    /// hardware multiplier or divider (__udivmodhi4 and __udivmodsi4).
+    template<typename U>
+    [[gnu::noinline]] U softDivide(U dividend, U divisor, U& remainder)
+    {
+        U quotient = 0;
+        U rest = 0;
+        for (int bit = sizeof(U) * 8 - 1; bit >= 0; --bit)
+        {
+            ++division_steps;
+            rest = static_cast<U>((rest << 1) | ((dividend >> bit) & 1));
+            if (rest >= divisor)
+            {
+                rest -= divisor;
+                quotient |= static_cast<U>(U(1) << bit);
+            }
+        }
+        remainder = rest;
+        return quotient;
+    }
+
+    /// \brief The usual conversion with one division per digit, what value / 10 compiles to on the MSP430G2.
+    template<typename U>
+    void naiveDecimal(BufferSink& sink, U value)
+    {
+        char digits[10];
+        std::uint8_t count = 0;
+        do
+        {
+            U remainder;
+            value = softDivide<U>(value, 10, remainder);
+            digits[count++] = static_cast<char>('0' + remainder);
+        } while (value != 0);
+        while (count > 0)
+            sink.write(static_cast<std::uint8_t>(digits[--count]));
+    }
+
+    /// \brief Subtraction and comparison steps of the power of ten conversion, derived from the digits written.
+    std::uint64_t subtractionSteps(const BufferSink& sink)
+    {
+        std::uint64_t steps = 0;
+        for (std::uint8_t i = 0; i < sink.length; ++i)
+            steps += static_cast<std::uint64_t>(sink.buffer[i] - '0') + 1;
+        return steps;
+    }
+
+    template<typename Function>
+    double nanosecondsPerCall(const std::vector<std::uint32_t>& values, Function function)
+    {
+        auto start = std::chrono::steady_clock::now();
+        constexpr int rounds = 20;
+        for (int round = 0; round < rounds; ++round)
+        {
+            for (std::uint32_t value : values)
+                function(value);
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / (rounds * values.size());
+    }
+
+    template<typename U>
+    bool compare(const char* name, const std::vector<std::uint32_t>& values)
+    {
+        bool success = true;
+        std::uint64_t subtraction_steps = 0;
+        division_steps = 0;
+        for (std::uint32_t value : values)
+        {
+            BufferSink expected;
+            naiveDecimal<U>(expected, static_cast<U>(value));
+            BufferSink actual;
+            format::writeDecimal(actual, static_cast<U>(value));
+            subtraction_steps += subtractionSteps(actual);
+            if (actual.str() != expected.str())
+            {
+                std::printf("FAIL %s: %s instead of %s\n", name, actual.str().c_str(), expected.str().c_str());
+                success = false;
+            }
+        }
+
+        std::uint64_t naive_steps = division_steps;
+
+        volatile std::uint8_t sink_length = 0;
+        double naive = nanosecondsPerCall(values, [&](std::uint32_t value)
+        {
+            BufferSink sink;
+            naiveDecimal<U>(sink, static_cast<U>(value));
+            sink_length = sink.length;
+        });
+        double subtraction = nanosecondsPerCall(values, [&](std::uint32_t value)
+        {
+            BufferSink sink;
+            format::writeDecimal(sink, static_cast<U>(value));
+            sink_length = sink.length;
+        });
+        std::printf("%-8s naive /10: %6.1f ns, %5.1f division steps per number | powers of ten: %6.1f ns, "
+                    "%5.1f subtraction steps per number\n", name, naive,
+                    static_cast<double>(naive_steps) / values.size(), subtraction,
+                    static_cast<double>(subtraction_steps) / values.size());
+        return success;
+    }
+
+    bool checkFormats()
+    {
+        struct Case
+        {
+            std::string actual;
+            const char* expected;
+        };
+        auto formatted = [](auto function)
+        {
+            BufferSink sink;
+            function(sink);
+            return sink.str();
+        };
+        const Case cases[] = {
+                {formatted([](BufferSink& s) { format::writeDecimal(s, std::int16_t(-32768)); }), "-32768"},
+                {formatted([](BufferSink& s) { format::writeDecimal(s, std::int32_t(-2147483647 - 1)); }), "-2147483648"},
+                {formatted([](BufferSink& s) { format::writeDecimal(s, std::uint32_t(4294967295u)); }), "4294967295"},
+                {formatted([](BufferSink& s) { format::writeDecimal(s, std::uint8_t(0)); }), "0"},
+                {formatted([](BufferSink& s) { format::writeDecimal(s, std::int16_t(-42), 6); }), "   -42"},
+                {formatted([](BufferSink& s) { format::writeDecimal(s, std::int16_t(-42), 6, '0'); }), "-00042"},
+                {formatted([](BufferSink& s) { format::writeHex(s, std::uint16_t(0xbeef)); }), "BEEF"},
+                {formatted([](BufferSink& s) { format::writeHex(s, std::int8_t(-1)); }), "FF"},
+                {formatted([](BufferSink& s) { format::writeHex(s, std::uint32_t(0x2a), 3); }), "02A"},
+                {formatted([](BufferSink& s) { format::writeFixed<15, 4>(s, std::int16_t(-32768)); }), "-1.0000"},
+                {formatted([](BufferSink& s) { format::writeFixed<15, 3>(s, std::int16_t(16384)); }), "0.500"},
+                {formatted([](BufferSink& s) { format::writeFixed<8, 2>(s, std::int16_t(0x7fff)); }), "128.00"},
+                {formatted([](BufferSink& s) { format::writeFixed<8, 1>(s, std::int16_t(-0x0180), 6); }), "  -1.5"},
+                {formatted([](BufferSink& s) { format::writeFixed<8, 0>(s, std::uint16_t(0x0280)); }), "3"},
+                {formatted([](BufferSink& s) { format::writeFixed<8, 1>(s, std::int16_t(-0x000c), 5); }), "  0.0"},
+                {formatted([](BufferSink& s) { format::writeFixed<8, 1>(s, std::int16_t(-0x000d), 5); }), " -0.1"},
+                {formatted([](BufferSink& s) { format::writeFixed<8, 0>(s, std::int16_t(-0x0080)); }), "-1"},
+        };
+
+        bool success = true;
+        for (const Case& c : cases)
+        {
+            if (c.actual != c.expected)
+            {
+                std::printf("FAIL format: %s instead of %s\n", c.actual.c_str(), c.expected);
+                success = false;
+            }
+        }
+
+        // Fixed point against an exact reference, rounded half away from zero and without a sign on zero
+        for (std::int32_t raw = -32768; raw <= 32767; ++raw)
+        {
+            BufferSink actual;
+            format::writeFixed<15, 4>(actual, static_cast<std::int16_t>(raw));
+            std::uint64_t magnitude = static_cast<std::uint64_t>(raw < 0 ? -raw : raw);
+            std::uint64_t scaled = (magnitude * 10000 * 2 + (1u << 15)) >> 16;
+            char expected[32];
+            std::snprintf(expected, sizeof(expected), "%s%llu.%04llu", (raw < 0 && scaled != 0) ? "-" : "",
+                          static_cast<unsigned long long>(scaled / 10000), static_cast<unsigned long long>(scaled % 10000));
+            if (actual.str() != expected)
+            {
+                std::printf("FAIL Q15: %s instead of %s\n", actual.str().c_str(), expected);
+                success = false;
+                break;
+            }
+        }
+        return success;
+    }
+}
+
+/// Compares the division free formatting with the conversion using a software division per digit, which is what
+/// printf and value / 10 cost on the MSP430G2. Both produce the same text; the step counts are independent of the
+/// host, the times only show the relation on the host. Fails if any output differs.
+int main()
+{
+    std::vector<std::uint32_t> values16;
+    for (std::uint32_t value = 0; value <= 0xffff; value += 7)
+        values16.push_back(value);
+
+    std::mt19937 random(430);
+    std::vector<std::uint32_t> values32;
+    for (int i = 0; i < 10000; ++i)
+        values32.push_back(random() >> (random() % 32));
+
+    bool success = compare<std::uint16_t>("uint16", values16);
+    success &= compare<std::uint32_t>("uint32", values32);
+    success &= checkFormats();
+    std::puts(success ? "All formatted numbers match" : "Formatting mismatch");
+    return success ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+#include <msp430.h>
+
+#include <msp430hal/host/device.h>
+#include <msp430hal/timer/watchdog_timer.h>
+#include <msp430hal/usci/spi.h>
+
+using namespace msp430hal;
+
+namespace
+{
+    /// \brief Answers every character with its complement, so the received data can be checked.
+    struct ComplementDevice : host::SpiDevice
+    {
+        std::vector<std::uint8_t> received;
+
+        std::uint8_t exchange(std::uint8_t mosi) override
+        {
+            received.push_back(mosi);
+            return static_cast<std::uint8_t>(~mosi);
+        }
+    };
+
+    constexpr std::size_t block_length = 512;
+
+    template<std::uint16_t prescaler>
+    using Spi = usci::SPI_t<usci::UsciModule::usci_b, 0, usci::master_3pin, usci::msb_8bit,
+                            usci::active_high_leading_edge, usci::smclk, prescaler>;
+
+    struct Result
+    {
+        double utilisation;
+        bool correct;
+    };
+
+    /// \brief Run a block operation and relate the time the bus clock was running to the elapsed time.
+    template<typename SPI>
+    Result measure(const std::function<bool(const std::vector<std::uint8_t>&, std::vector<std::uint8_t>&)>& operation)
+    {
+        host::Device& device = host::device();
+        device.powerOn();
+        timer::stopWatchdog();
+        ComplementDevice slave;
+        device.usciB0().attachSpiDevice(&slave);
+        SPI::init();
+
+        std::vector<std::uint8_t> tx(block_length);
+        for (std::size_t i = 0; i < tx.size(); ++i)
+            tx[i] = static_cast<std::uint8_t>(i * 7 + 3);
+        std::vector<std::uint8_t> rx(block_length);
+
+        host::Time start = device.now();
+        bool correct = operation(tx, rx);
+        host::Time elapsed = device.now() - start;
+        correct &= slave.received.size() == block_length && !SPI::readOverrunError();
+
+        host::Time character_time = static_cast<host::Time>(8) * SPI::pre_scale_factor_value * host::picoseconds_per_second /
+                                    device.usciB0().brclk();
+        device.usciB0().attachSpiDevice(nullptr);
+        return {static_cast<double>(character_time * block_length) / elapsed, correct};
+    }
+
+    bool complemented(const std::vector<std::uint8_t>& tx, const std::vector<std::uint8_t>& rx)
+    {
+        for (std::size_t i = 0; i < tx.size(); ++i)
+        {
+            if (rx[i] != static_cast<std::uint8_t>(~tx[i]))
+                return false;
+        }
+        return true;
+    }
+
+    template<std::uint16_t prescaler>
+    bool compare()
+    {
+        using SPI = Spi<prescaler>;
+        Result single = measure<SPI>([](const auto& tx, auto& rx)
+        {
+            for (std::size_t i = 0; i < tx.size(); ++i)
+                rx[i] = SPI::transfer(tx[i]);
+            return complemented(tx, rx);
+        });
+        Result transfer = measure<SPI>([](const auto& tx, auto& rx)
+        {
+            SPI::transfer(tx.data(), rx.data(), tx.size());
+            return complemented(tx, rx);
+        });
+        Result read = measure<SPI>([](const auto&, auto& rx)
+        {
+            SPI::read(rx.data(), rx.size(), 0x5a);
+            for (std::uint8_t byte : rx)
+            {
+                if (byte != 0xa5)
+                    return false;
+            }
+            return true;
+        });
+        Result write = measure<SPI>([](const auto& tx, auto&)
+        {
+            SPI::write(tx.data(), tx.size());
+            return !SPI::readOverrunError();
+        });
+
+        std::printf("prescaler %3u  single: %5.1f %%  transfer: %5.1f %%  read: %5.1f %%  write: %5.1f %%\n", prescaler,
+                    single.utilisation * 100, transfer.utilisation * 100, read.utilisation * 100,
+                    write.utilisation * 100);
+        bool success = single.correct && write.correct && transfer.correct && read.correct;
+        if (!success)
+            std::printf("FAIL prescaler %u: wrong data or overrun\n", prescaler);
+        // The write-only path additionally waits for the last character at the end
+        if (transfer.utilisation < single.utilisation || write.utilisation + 0.01 < transfer.utilisation)
+        {
+            std::printf("FAIL prescaler %u: the block transfer is slower than the single character transfer\n", prescaler);
+            success = false;
+        }
+        return success;
+    }
+}
+
+/// Measures the bus utilisation of the SPI block transfers on the simulated device, i.e. the share of the time in
+/// which the bus clock is running. The single character transfer waits for every character before it loads the next
+/// one, the block transfers keep the transmit buffer loaded. At prescaler 1 a character takes less time than reading
+/// it, the full duplex block transfers fall back to single characters there and only the write-only path keeps up.
+/// Fails if data is corrupted or lost at any prescaler, or if a block transfer is slower.
+int main()
+{
+    bool success = compare<1>();
+    success &= compare<2>();
+    success &= compare<4>();
+    success &= compare<16>();
+    success &= compare<64>();
+    std::puts(success ? "All SPI transfers correct" : "SPI transfer failure");
+    return success ? 0 : 1;
+}
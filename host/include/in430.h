@@ -0,0 +1,33 @@
+#ifndef MSP430HAL_HOST_IN430_H
+#define MSP430HAL_HOST_IN430_H
+
+/*
+ * Host stand-in for the intrinsics of the MSP430 compilers.
+ *
+ * The status register is part of the simulated device, so enabling interrupts, entering a low power mode or
+ * burning cycles has the same observable effect on the simulated peripherals as it has on the real CPU.
+ */
+
+void __enable_interrupt();
+void __disable_interrupt();
+unsigned short __get_interrupt_state();
+void __set_interrupt_state(unsigned short state);
+
+unsigned short __get_SR_register();
+void __bis_SR_register(unsigned short bits);
+void __bic_SR_register(unsigned short bits);
+void __bis_SR_register_on_exit(unsigned short bits);
+void __bic_SR_register_on_exit(unsigned short bits);
+
+void __no_operation();
+void __delay_cycles(unsigned long cycles);
+
+#define _EINT() __enable_interrupt()
+#define _DINT() __disable_interrupt()
+#define _NOP() __no_operation()
+#define _BIS_SR(x) __bis_SR_register(x)
+#define _BIC_SR(x) __bic_SR_register(x)
+#define _BIS_SR_IRQ(x) __bis_SR_register_on_exit(x)
+#define _BIC_SR_IRQ(x) __bic_SR_register_on_exit(x)
+
+#endif //MSP430HAL_HOST_IN430_H
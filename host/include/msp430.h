@@ -0,0 +1,540 @@
+#ifndef MSP430HAL_HOST_MSP430_H
+#define MSP430HAL_HOST_MSP430_H
+
+/*
+ * Host stand-in for the device header of the MSP430 compilers.
+ *
+ * It describes a MSP430G2553 whose peripheral registers are objects of the simulated register file instead of
+ * fixed addresses. Every access to them goes through msp430hal::host::Register, which allows the peripheral models
+ * to react on reads and writes and allows tools to observe the register traffic.
+ */
+
+#include <cstdint>
+
+#include "in430.h"
+#include "msp430hal/host/register.h"
+
+#define __MSP430G2553__ 1
+#define __MSP430_HAS_SFR__
+#define __MSP430_HAS_BC2__
+#define __MSP430_HAS_FLASH2__
+#define __MSP430_HAS_WDT__
+#define __MSP430_HAS_PORT1_R__
+#define __MSP430_HAS_PORT2_R__
+#define __MSP430_HAS_PORT3_R__
+#define __MSP430_HAS_TA3__
+#define __MSP430_HAS_T1A3__
+#define __MSP430_HAS_CAPLUS__
+#define __MSP430_HAS_USCI__
+
+#define sfr_b(name) extern msp430hal::host::Register<std::uint8_t> name
+#define sfr_w(name) extern msp430hal::host::Register<std::uint16_t> name
+
+/************************************************************
+* STATUS REGISTER BITS
+************************************************************/
+#define C                      (0x0001)
+#define Z                      (0x0002)
+#define N                      (0x0004)
+#define V                      (0x0100)
+#define GIE                    (0x0008)
+#define CPUOFF                 (0x0010)
+#define OSCOFF                 (0x0020)
+#define SCG0                   (0x0040)
+#define SCG1                   (0x0080)
+
+#define LPM0_bits              (CPUOFF)
+#define LPM1_bits              (SCG0+CPUOFF)
+#define LPM2_bits              (SCG1+CPUOFF)
+#define LPM3_bits              (SCG1+SCG0+CPUOFF)
+#define LPM4_bits              (SCG1+SCG0+OSCOFF+CPUOFF)
+
+#define LPM0      __bis_SR_register(LPM0_bits)
+#define LPM0_EXIT __bic_SR_register_on_exit(LPM0_bits)
+#define LPM1      __bis_SR_register(LPM1_bits)
+#define LPM1_EXIT __bic_SR_register_on_exit(LPM1_bits)
+#define LPM2      __bis_SR_register(LPM2_bits)
+#define LPM2_EXIT __bic_SR_register_on_exit(LPM2_bits)
+#define LPM3      __bis_SR_register(LPM3_bits)
+#define LPM3_EXIT __bic_SR_register_on_exit(LPM3_bits)
+#define LPM4      __bis_SR_register(LPM4_bits)
+#define LPM4_EXIT __bic_SR_register_on_exit(LPM4_bits)
+
+/************************************************************
+* SPECIAL FUNCTION REGISTER ADDRESSES + CONTROL BITS
+************************************************************/
+sfr_b(IE1);
+#define WDTIE                  (0x01)
+#define OFIE                   (0x02)
+#define NMIIE                  (0x10)
+#define ACCVIE                 (0x20)
+
+sfr_b(IFG1);
+#define WDTIFG                 (0x01)
+#define OFIFG                  (0x02)
+#define PORIFG                 (0x04)
+#define RSTIFG                 (0x08)
+#define NMIIFG                 (0x10)
+
+sfr_b(IE2);
+#define UC0IE                  IE2
+#define UCA0RXIE               (0x01)
+#define UCA0TXIE               (0x02)
+#define UCB0RXIE               (0x04)
+#define UCB0TXIE               (0x08)
+
+sfr_b(IFG2);
+#define UC0IFG                 IFG2
+#define UCA0RXIFG              (0x01)
+#define UCA0TXIFG              (0x02)
+#define UCB0RXIFG              (0x04)
+#define UCB0TXIFG              (0x08)
+
+/************************************************************
+* Basic Clock Module
+************************************************************/
+sfr_b(DCOCTL);
+sfr_b(BCSCTL1);
+sfr_b(BCSCTL2);
+sfr_b(BCSCTL3);
+
+#define MOD0                   (0x01)
+#define MOD1                   (0x02)
+#define MOD2                   (0x04)
+#define MOD3                   (0x08)
+#define MOD4                   (0x10)
+#define DCO0                   (0x20)
+#define DCO1                   (0x40)
+#define DCO2                   (0x80)
+
+#define RSEL0                  (0x01)
+#define RSEL1                  (0x02)
+#define RSEL2                  (0x04)
+#define RSEL3                  (0x08)
+#define DIVA0                  (0x10)
+#define DIVA1                  (0x20)
+#define XTS                    (0x40)
+#define XT2OFF                 (0x80)
+
+#define DIVA_0                 (0x00)
+#define DIVA_1                 (0x10)
+#define DIVA_2                 (0x20)
+#define DIVA_3                 (0x30)
+
+#define DIVS0                  (0x02)
+#define DIVS1                  (0x04)
+#define SELS                   (0x08)
+#define DIVM0                  (0x10)
+#define DIVM1                  (0x20)
+#define SELM0                  (0x40)
+#define SELM1                  (0x80)
+
+#define DIVM_0                 (0x00)
+#define DIVM_1                 (0x10)
+#define DIVM_2                 (0x20)
+#define DIVM_3                 (0x30)
+
+#define DIVS_0                 (0x00)
+#define DIVS_1                 (0x02)
+#define DIVS_2                 (0x04)
+#define DIVS_3                 (0x06)
+
+#define SELM_0                 (0x00)
+#define SELM_1                 (0x40)
+#define SELM_2                 (0x80)
+#define SELM_3                 (0xC0)
+
+#define LFXT1OF                (0x01)
+#define XT2OF                  (0x02)
+#define XCAP0                  (0x04)
+#define XCAP1                  (0x08)
+#define LFXT1S0                (0x10)
+#define LFXT1S1                (0x20)
+#define XT2S0                  (0x40)
+#define XT2S1                  (0x80)
+
+#define LFXT1S_0               (0x00)
+#define LFXT1S_1               (0x10)
+#define LFXT1S_2               (0x20)
+#define LFXT1S_3               (0x30)
+
+/************************************************************
+* Comparator A
+************************************************************/
+sfr_b(CACTL1);
+sfr_b(CACTL2);
+sfr_b(CAPD);
+
+#define CAIFG                  (0x01)
+#define CAIE                   (0x02)
+#define CAIES                  (0x04)
+#define CAON                   (0x08)
+#define CAREF0                 (0x10)
+#define CAREF1                 (0x20)
+#define CARSEL                 (0x40)
+#define CAEX                   (0x80)
+
+#define CAREF_0                (0x00)
+#define CAREF_1                (0x10)
+#define CAREF_2                (0x20)
+#define CAREF_3                (0x30)
+
+#define CAOUT                  (0x01)
+#define CAF                    (0x02)
+#define P2CA0                  (0x04)
+#define P2CA1                  (0x08)
+#define P2CA2                  (0x10)
+#define P2CA3                  (0x20)
+#define P2CA4                  (0x40)
+#define CASHORT                (0x80)
+
+/*************************************************************
+* Flash Memory
+*************************************************************/
+sfr_w(FCTL1);
+sfr_w(FCTL2);
+sfr_w(FCTL3);
+
+#define FRKEY                  (0x9600)
+#define FWKEY                  (0xA500)
+#define FXKEY                  (0x3300)
+
+#define ERASE                  (0x0002)
+#define MERAS                  (0x0004)
+#define WRT                    (0x0040)
+#define BLKWRT                 (0x0080)
+#define SEGWRT                 (0x0080)
+
+#define FN0                    (0x0001)
+#define FN1                    (0x0002)
+#define FN2                    (0x0004)
+#define FN3                    (0x0008)
+#define FN4                    (0x0010)
+#define FN5                    (0x0020)
+#define FSSEL0                 (0x0040)
+#define FSSEL1                 (0x0080)
+
+#define FSSEL_0                (0x0000)
+#define FSSEL_1                (0x0040)
+#define FSSEL_2                (0x0080)
+#define FSSEL_3                (0x00C0)
+
+#define BUSY                   (0x0001)
+#define KEYV                   (0x0002)
+#define ACCVIFG                (0x0004)
+#define WAIT                   (0x0008)
+#define LOCK                   (0x0010)
+#define EMEX                   (0x0020)
+#define LOCKA                  (0x0040)
+#define FAIL                   (0x0080)
+
+/************************************************************
+* DIGITAL I/O Port1/2 Pull up / Pull down Resistors
+************************************************************/
+sfr_b(P1IN);
+sfr_b(P1OUT);
+sfr_b(P1DIR);
+sfr_b(P1IFG);
+sfr_b(P1IES);
+sfr_b(P1IE);
+sfr_b(P1SEL);
+sfr_b(P1SEL2);
+sfr_b(P1REN);
+
+sfr_b(P2IN);
+sfr_b(P2OUT);
+sfr_b(P2DIR);
+sfr_b(P2IFG);
+sfr_b(P2IES);
+sfr_b(P2IE);
+sfr_b(P2SEL);
+sfr_b(P2SEL2);
+sfr_b(P2REN);
+
+/************************************************************
+* DIGITAL I/O Port3 Pull up / Pull down Resistors
+************************************************************/
+sfr_b(P3IN);
+sfr_b(P3OUT);
+sfr_b(P3DIR);
+sfr_b(P3SEL);
+sfr_b(P3SEL2);
+sfr_b(P3REN);
+
+#define BIT0                   (0x0001)
+#define BIT1                   (0x0002)
+#define BIT2                   (0x0004)
+#define BIT3                   (0x0008)
+#define BIT4                   (0x0010)
+#define BIT5                   (0x0020)
+#define BIT6                   (0x0040)
+#define BIT7                   (0x0080)
+#define BIT8                   (0x0100)
+#define BIT9                   (0x0200)
+#define BITA                   (0x0400)
+#define BITB                   (0x0800)
+#define BITC                   (0x1000)
+#define BITD                   (0x2000)
+#define BITE                   (0x4000)
+#define BITF                   (0x8000)
+
+/************************************************************
+* Timer0_A3
+************************************************************/
+sfr_w(TA0IV);
+sfr_w(TA0CTL);
+sfr_w(TA0CCTL0);
+sfr_w(TA0CCTL1);
+sfr_w(TA0CCTL2);
+sfr_w(TA0R);
+sfr_w(TA0CCR0);
+sfr_w(TA0CCR1);
+sfr_w(TA0CCR2);
+
+#define TAIV                   TA0IV
+#define TACTL                  TA0CTL
+#define TACCTL0                TA0CCTL0
+#define TACCTL1                TA0CCTL1
+#define TACCTL2                TA0CCTL2
+#define TAR                    TA0R
+#define TACCR0                 TA0CCR0
+#define TACCR1                 TA0CCR1
+#define TACCR2                 TA0CCR2
+
+#define TASSEL1                (0x0200)
+#define TASSEL0                (0x0100)
+#define ID1                    (0x0080)
+#define ID0                    (0x0040)
+#define MC1                    (0x0020)
+#define MC0                    (0x0010)
+#define TACLR                  (0x0004)
+#define TAIE                   (0x0002)
+#define TAIFG                  (0x0001)
+
+#define MC_0                   (0x0000)
+#define MC_1                   (0x0010)
+#define MC_2                   (0x0020)
+#define MC_3                   (0x0030)
+#define ID_0                   (0x0000)
+#define ID_1                   (0x0040)
+#define ID_2                   (0x0080)
+#define ID_3                   (0x00C0)
+#define TASSEL_0               (0x0000)
+#define TASSEL_1               (0x0100)
+#define TASSEL_2               (0x0200)
+#define TASSEL_3               (0x0300)
+
+#define CM1                    (0x8000)
+#define CM0                    (0x4000)
+#define CCIS1                  (0x2000)
+#define CCIS0                  (0x1000)
+#define SCS                    (0x0800)
+#define SCCI                   (0x0400)
+#define CAP                    (0x0100)
+#define OUTMOD2                (0x0080)
+#define OUTMOD1                (0x0040)
+#define OUTMOD0                (0x0020)
+#define CCIE                   (0x0010)
+#define CCI                    (0x0008)
+#define OUT                    (0x0004)
+#define COV                    (0x0002)
+#define CCIFG                  (0x0001)
+
+#define OUTMOD_0               (0x0000)
+#define OUTMOD_1               (0x0020)
+#define OUTMOD_2               (0x0040)
+#define OUTMOD_3               (0x0060)
+#define OUTMOD_4               (0x0080)
+#define OUTMOD_5               (0x00A0)
+#define OUTMOD_6               (0x00C0)
+#define OUTMOD_7               (0x00E0)
+#define CCIS_0                 (0x0000)
+#define CCIS_1                 (0x1000)
+#define CCIS_2                 (0x2000)
+#define CCIS_3                 (0x3000)
+#define CM_0                   (0x0000)
+#define CM_1                   (0x4000)
+#define CM_2                   (0x8000)
+#define CM_3                   (0xC000)
+
+#define TA0IV_NONE             (0x0000)
+#define TA0IV_TACCR1           (0x0002)
+#define TA0IV_TACCR2           (0x0004)
+#define TA0IV_6                (0x0006)
+#define TA0IV_8                (0x0008)
+#define TA0IV_TAIFG            (0x000A)
+
+/************************************************************
+* Timer1_A3
+************************************************************/
+sfr_w(TA1IV);
+sfr_w(TA1CTL);
+sfr_w(TA1CCTL0);
+sfr_w(TA1CCTL1);
+sfr_w(TA1CCTL2);
+sfr_w(TA1R);
+sfr_w(TA1CCR0);
+sfr_w(TA1CCR1);
+sfr_w(TA1CCR2);
+
+#define TA1IV_NONE             (0x0000)
+#define TA1IV_TACCR1           (0x0002)
+#define TA1IV_TACCR2           (0x0004)
+#define TA1IV_TAIFG            (0x000A)
+
+/************************************************************
+* USCI
+************************************************************/
+#define UCPEN                  (0x80)
+#define UCPAR                  (0x40)
+#define UCMSB                  (0x20)
+#define UC7BIT                 (0x10)
+#define UCSPB                  (0x08)
+#define UCMODE1                (0x04)
+#define UCMODE0                (0x02)
+#define UCSYNC                 (0x01)
+
+#define UCCKPH                 (0x80)
+#define UCCKPL                 (0x40)
+#define UCMST                  (0x08)
+
+#define UCA10                  (0x80)
+#define UCSLA10                (0x40)
+#define UCMM                   (0x20)
+
+#define UCMODE_0               (0x00)
+#define UCMODE_1               (0x02)
+#define UCMODE_2               (0x04)
+#define UCMODE_3               (0x06)
+
+#define UCSSEL1                (0x80)
+#define UCSSEL0                (0x40)
+#define UCRXEIE                (0x20)
+#define UCBRKIE                (0x10)
+#define UCDORM                 (0x08)
+#define UCTXADDR               (0x04)
+#define UCTXBRK                (0x02)
+#define UCSWRST                (0x01)
+
+#define UCSSEL_0               (0x00)
+#define UCSSEL_1               (0x40)
+#define UCSSEL_2               (0x80)
+#define UCSSEL_3               (0xC0)
+
+#define UCTR                   (0x10)
+#define UCTXNACK               (0x08)
+#define UCTXSTP                (0x04)
+#define UCTXSTT                (0x02)
+
+#define UCBRF3                 (0x80)
+#define UCBRF2                 (0x40)
+#define UCBRF1                 (0x20)
+#define UCBRF0                 (0x10)
+#define UCBRS2                 (0x08)
+#define UCBRS1                 (0x04)
+#define UCBRS0                 (0x02)
+#define UCOS16                 (0x01)
+
+#define UCLISTEN               (0x80)
+#define UCFE                   (0x40)
+#define UCOE                   (0x20)
+#define UCPE                   (0x10)
+#define UCBRK                  (0x08)
+#define UCRXERR                (0x04)
+#define UCADDR                 (0x02)
+#define UCBUSY                 (0x01)
+#define UCIDLE                 (0x02)
+
+#define UCSCLLOW               (0x40)
+#define UCGC                   (0x20)
+#define UCBBUSY                (0x10)
+#define UCNACKIFG              (0x08)
+#define UCSTPIFG               (0x04)
+#define UCSTTIFG               (0x02)
+#define UCALIFG                (0x01)
+
+#define UCNACKIE               (0x08)
+#define UCSTPIE                (0x04)
+#define UCSTTIE                (0x02)
+#define UCALIE                 (0x01)
+
+#define UCGCEN                 (0x8000)
+
+#define UCDELIM1               (0x20)
+#define UCDELIM0               (0x10)
+#define UCSTOE                 (0x08)
+#define UCBTOE                 (0x04)
+#define UCABDEN                (0x01)
+
+sfr_b(UCA0ABCTL);
+sfr_b(UCA0IRTCTL);
+sfr_b(UCA0IRRCTL);
+sfr_b(UCA0CTL0);
+sfr_b(UCA0CTL1);
+sfr_b(UCA0BR0);
+sfr_b(UCA0BR1);
+sfr_b(UCA0MCTL);
+sfr_b(UCA0STAT);
+sfr_b(UCA0RXBUF);
+sfr_b(UCA0TXBUF);
+
+sfr_b(UCB0CTL0);
+sfr_b(UCB0CTL1);
+sfr_b(UCB0BR0);
+sfr_b(UCB0BR1);
+sfr_b(UCB0I2CIE);
+sfr_b(UCB0STAT);
+sfr_b(UCB0RXBUF);
+sfr_b(UCB0TXBUF);
+sfr_w(UCB0I2COA);
+sfr_w(UCB0I2CSA);
+
+/************************************************************
+* WATCHDOG TIMER
+************************************************************/
+sfr_w(WDTCTL);
+
+#define WDTIS0                 (0x0001)
+#define WDTIS1                 (0x0002)
+#define WDTSSEL                (0x0004)
+#define WDTCNTCL               (0x0008)
+#define WDTTMSEL               (0x0010)
+#define WDTNMI                 (0x0020)
+#define WDTNMIES               (0x0040)
+#define WDTHOLD                (0x0080)
+
+#define WDTPW                  (0x5A00)
+
+/************************************************************
+* Calibration Data in Info Mem
+************************************************************/
+sfr_b(CALDCO_16MHZ);
+sfr_b(CALBC1_16MHZ);
+sfr_b(CALDCO_12MHZ);
+sfr_b(CALBC1_12MHZ);
+sfr_b(CALDCO_8MHZ);
+sfr_b(CALBC1_8MHZ);
+sfr_b(CALDCO_1MHZ);
+sfr_b(CALBC1_1MHZ);
+
+/************************************************************
+* Interrupt Vectors (offset from 0xFFE0)
+************************************************************/
+#define PORT1_VECTOR           (3)
+#define PORT2_VECTOR           (4)
+#define ADC10_VECTOR           (6)
+#define USCIAB0TX_VECTOR       (7)
+#define USCIAB0RX_VECTOR       (8)
+#define TIMER0_A1_VECTOR       (9)
+#define TIMER0_A0_VECTOR       (10)
+#define WDT_VECTOR             (11)
+#define COMPARATORA_VECTOR     (12)
+#define TIMER1_A1_VECTOR       (13)
+#define TIMER1_A0_VECTOR       (14)
+#define NMI_VECTOR             (15)
+#define RESET_VECTOR           (16)
+
+#undef sfr_b
+#undef sfr_w
+
+#endif //MSP430HAL_HOST_MSP430_H
@@ -0,0 +1,60 @@
+#ifndef MSP430HAL_HOST_CLOCK_H
+#define MSP430HAL_HOST_CLOCK_H
+
+#include <cstdint>
+
+#include "peripheral.h"
+
+namespace msp430hal
+{
+    namespace host
+    {
+        /// \brief Frequencies of the clock sources that are not generated inside the basic clock module.
+        struct Oscillators
+        {
+            std::uint32_t lfxt1_hz = 32768; ///< Crystal or external clock at XIN/XOUT.
+            std::uint32_t vlo_hz = 12000; ///< Internal very low power oscillator.
+            std::uint32_t taclk_hz = 0; ///< External timer clock input TACLK.
+            std::uint32_t uclk_hz = 0; ///< External USCI clock input UCLK.
+        };
+
+        /// \brief Model of the basic clock module+.
+        ///
+        /// The DCO frequency is derived from the DCOCTL/BCSCTL1 settings. The factory calibration values map exactly
+        /// to their nominal frequency, all other settings are approximated.
+        class ClockSystem : public Peripheral
+        {
+        public:
+            void reset() override;
+            void afterWrite(RegisterBase& reg) override;
+
+            Oscillators& oscillators() { return m_oscillators; }
+            [[nodiscard]]
+            const Oscillators& oscillators() const { return m_oscillators; }
+
+            [[nodiscard]]
+            std::uint32_t dco() const { return m_dco_hz; }
+
+            [[nodiscard]]
+            std::uint32_t mclk() const;
+
+            [[nodiscard]]
+            std::uint32_t smclk() const;
+
+            [[nodiscard]]
+            std::uint32_t aclk() const;
+
+            /// \brief Frequency of the low frequency oscillator path (LFXT1 or VLO).
+            [[nodiscard]]
+            std::uint32_t lfxt1() const;
+
+        private:
+            void updateDco();
+
+            Oscillators m_oscillators;
+            std::uint32_t m_dco_hz = 1100000;
+        };
+    }
+}
+
+#endif //MSP430HAL_HOST_CLOCK_H
@@ -0,0 +1,36 @@
+#ifndef MSP430HAL_HOST_COMPARATOR_H
+#define MSP430HAL_HOST_COMPARATOR_H
+
+#include <cstdint>
+
+#include "peripheral.h"
+
+namespace msp430hal
+{
+    namespace host
+    {
+        /// \brief Model of the Comparator_A+.
+        ///
+        /// The analog inputs are not simulated, instead the result of the comparison is set from outside.
+        class Comparator : public Peripheral
+        {
+        public:
+            void reset() override;
+            std::uint16_t write(RegisterBase& reg, std::uint16_t value) override;
+            void afterWrite(RegisterBase& reg) override;
+            [[nodiscard]]
+            bool interruptPending(unsigned vector) const override;
+            void acknowledgeInterrupt(unsigned vector) override;
+
+            /// \brief Set the result of the comparison, true if the non-inverting input is above the inverting input.
+            void setResult(bool result);
+
+        private:
+            void update();
+
+            bool m_result = false;
+        };
+    }
+}
+
+#endif //MSP430HAL_HOST_COMPARATOR_H
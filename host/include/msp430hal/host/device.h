@@ -0,0 +1,166 @@
+#ifndef MSP430HAL_HOST_DEVICE_H
+#define MSP430HAL_HOST_DEVICE_H
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <vector>
+
+#include "clock.h"
+#include "comparator.h"
+#include "flash.h"
+#include "gpio.h"
+#include "peripheral.h"
+#include "register.h"
+#include "timer.h"
+#include "usci.h"
+#include "watchdog.h"
+
+namespace msp430hal
+{
+    namespace host
+    {
+        /// \brief Thrown when the simulated device performs a power up clear (watchdog, key violation).
+        struct DeviceReset : std::runtime_error
+        {
+            using std::runtime_error::runtime_error;
+        };
+
+        /// \brief Thrown when the CPU sleeps without any chance to get woken up or a interrupt without handler is taken.
+        struct SimulationError : std::logic_error
+        {
+            using std::logic_error::logic_error;
+        };
+
+        /// \brief CPU cycles consumed by a single register access.
+        ///
+        /// The defaults correspond to MOV.B &reg,Rn / MOV.B Rn,&reg / BIS.B #n,&reg with absolute addressing.
+        struct AccessTiming
+        {
+            std::uint8_t read = 3;
+            std::uint8_t write = 4;
+            std::uint8_t read_modify_write = 5;
+        };
+
+        /// \brief The simulated MSP430G2553: CPU status register, simulated time, interrupts and all peripheral models.
+        ///
+        /// Time advances with every register access by the cycles given in AccessTiming and with the intrinsics
+        /// __delay_cycles and __bis_SR_register (low power modes). Pending interrupts are dispatched to the handlers attached
+        /// with attachInterrupt() whenever GIE is set, in the same priority order as on the real device.
+        class Device
+        {
+        public:
+            static Device& instance();
+
+            Device(const Device&) = delete;
+            Device& operator=(const Device&) = delete;
+
+            /// \brief Restore the power on state: registers, peripherals, time, interrupt handlers and connected devices.
+            void powerOn();
+
+            /// \brief Perform a power up clear and throw DeviceReset.
+            [[noreturn]]
+            void reset(const char* cause);
+
+            /// \brief Simulated time since power on in picoseconds.
+            [[nodiscard]]
+            Time now() const { return m_now; }
+
+            /// \brief CPU cycles executed since power on.
+            [[nodiscard]]
+            std::uint64_t cycles() const { return m_cycles; }
+
+            /// \brief Let the simulated time pass without executing instructions, e.g. while the CPU is stalled.
+            void advance(Time duration);
+
+            /// \brief Let the simulated time pass while the CPU is held, e.g. by the flash controller. No interrupts are taken.
+            void stall(Time duration);
+
+            /// \brief Execute CPU cycles at the current MCLK frequency and dispatch pending interrupts afterwards.
+            void execute(std::uint32_t cycles);
+
+            /// \brief Let the time pass until the CPU leaves the low power mode or the timeout elapsed.
+            void sleep();
+
+            void attachInterrupt(unsigned vector, std::function<void()> handler);
+            void detachInterrupt(unsigned vector);
+
+            /// \brief Dispatch all pending interrupts if GIE is set.
+            void serviceInterrupts();
+
+            [[nodiscard]]
+            std::uint16_t statusRegister() const { return m_status_register; }
+            void setStatusRegister(std::uint16_t value);
+            void modifyStatusRegisterOnExit(std::uint16_t set, std::uint16_t clear);
+
+            [[nodiscard]]
+            bool inInterrupt() const { return !m_saved_status_registers.empty(); }
+
+            /// \brief Maximum simulated time the CPU may sleep without getting woken up before a SimulationError is thrown.
+            void setSleepTimeout(Time timeout) { m_sleep_timeout = timeout; }
+
+            AccessTiming& timing() { return m_timing; }
+
+            ClockSystem& clocks() { return m_clocks; }
+            GpioPort& port(unsigned number);
+            TimerA& timerA(unsigned instance);
+            UsciA& usciA0() { return m_usci_a0; }
+            UsciB& usciB0() { return m_usci_b0; }
+            Comparator& comparator() { return m_comparator; }
+            FlashController& flash() { return m_flash; }
+            Watchdog& watchdog() { return m_watchdog; }
+
+            /// \brief The peripheral owning the address or nullptr.
+            [[nodiscard]]
+            Peripheral* owner(std::uint16_t address) const { return m_owners[address]; }
+
+            void addAccessListener(AccessListener* listener);
+            void removeAccessListener(AccessListener* listener);
+            void notify(const AccessEvent& event);
+
+            void writeMemory(std::uint16_t address, const void* data, std::size_t size);
+            void readMemory(std::uint16_t address, void* data, std::size_t size);
+
+        private:
+            Device();
+
+            void own(Peripheral& peripheral, std::initializer_list<RegisterBase*> registers);
+            void resetState();
+            void step(Time duration);
+
+            Time m_now = 0;
+            std::uint64_t m_cycles = 0;
+            std::uint16_t m_status_register = 0;
+            std::vector<std::uint16_t> m_saved_status_registers;
+            Time m_sleep_timeout = 10 * picoseconds_per_second;
+            AccessTiming m_timing;
+            std::array<std::function<void()>, 16> m_handlers;
+            std::vector<AccessListener*> m_listeners;
+            std::array<Peripheral*, 0x10000> m_owners = {};
+            std::array<std::uint8_t, 0x10000> m_ram = {};
+
+            ClockSystem m_clocks;
+            GpioPort m_port1;
+            GpioPort m_port2;
+            GpioPort m_port3;
+            TimerA m_timer_a0;
+            TimerA m_timer_a1;
+            UsciA m_usci_a0;
+            UsciB m_usci_b0;
+            Comparator m_comparator;
+            FlashController m_flash;
+            Watchdog m_watchdog;
+            std::vector<Peripheral*> m_peripherals;
+        };
+
+        /// \brief Shortcut for Device::instance().
+        inline Device& device()
+        {
+            return Device::instance();
+        }
+    }
+}
+
+#endif //MSP430HAL_HOST_DEVICE_H
@@ -0,0 +1,74 @@
+#ifndef MSP430HAL_HOST_FLASH_H
+#define MSP430HAL_HOST_FLASH_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "peripheral.h"
+
+namespace msp430hal
+{
+    namespace host
+    {
+        class ClockSystem;
+        class Device;
+
+        /// \brief Model of the flash memory and its controller.
+        ///
+        /// Programming only clears bits, erasing sets a whole segment to 0xff. Writes are only accepted while the
+        /// controller is unlocked and in write or erase mode, otherwise ACCVIFG is set. The CPU is stalled for the
+        /// duration of the programming/erase operation derived from the flash timing generator.
+        class FlashController : public Peripheral
+        {
+        public:
+            static constexpr std::uint16_t info_start = 0x1000;
+            static constexpr std::uint16_t info_end = 0x1100;
+            static constexpr std::uint16_t info_segment_size = 64;
+            static constexpr std::uint16_t main_start = 0xc000;
+            static constexpr std::uint32_t main_end = 0x10000;
+            static constexpr std::uint16_t main_segment_size = 512;
+
+            FlashController(Device& device, const ClockSystem& clocks);
+
+            void reset() override;
+            void beforeRead(RegisterBase& reg) override;
+            std::uint16_t write(RegisterBase& reg, std::uint16_t value) override;
+
+            [[nodiscard]]
+            static bool isFlash(std::uint32_t address);
+
+            /// \brief Access the flash content from the CPU.
+            void program(std::uint16_t address, const std::uint8_t* data, std::size_t size);
+
+            /// \brief Read the flash content.
+            [[nodiscard]]
+            std::uint8_t read(std::uint16_t address) const;
+
+            /// \brief Erase the whole flash and restore the calibration data, as it comes from the factory.
+            void restoreFactoryState();
+
+            /// \brief Number of completed program operations since power on.
+            [[nodiscard]]
+            std::uint32_t programCount() const { return m_program_count; }
+
+            /// \brief Number of completed erase operations since power on.
+            [[nodiscard]]
+            std::uint32_t eraseCount() const { return m_erase_count; }
+
+        private:
+            [[nodiscard]]
+            std::uint32_t timingGeneratorFrequency() const;
+            void stall(std::uint32_t timing_generator_cycles);
+            void eraseSegment(std::uint16_t address);
+
+            Device& m_device;
+            const ClockSystem& m_clocks;
+            std::array<std::uint8_t, main_end - info_start> m_memory;
+            std::uint32_t m_program_count = 0;
+            std::uint32_t m_erase_count = 0;
+        };
+    }
+}
+
+#endif //MSP430HAL_HOST_FLASH_H
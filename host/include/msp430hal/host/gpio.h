@@ -0,0 +1,67 @@
+#ifndef MSP430HAL_HOST_GPIO_H
+#define MSP430HAL_HOST_GPIO_H
+
+#include <cstdint>
+
+#include "peripheral.h"
+
+namespace msp430hal
+{
+    namespace host
+    {
+        /// \brief The registers of a digital I/O port. Ports without interrupt capability have no ifg, ies and ie register.
+        struct GpioPortRegisters
+        {
+            Register<std::uint8_t>& in;
+            Register<std::uint8_t>& out;
+            Register<std::uint8_t>& dir;
+            Register<std::uint8_t>* ifg;
+            Register<std::uint8_t>* ies;
+            Register<std::uint8_t>* ie;
+            Register<std::uint8_t>& sel;
+            Register<std::uint8_t>& sel2;
+            Register<std::uint8_t>& ren;
+        };
+
+        /// \brief Model of a digital I/O port including the outside world connected to the pins.
+        ///
+        /// The level of an input pin is the level driven from outside. Pins that are not driven follow their pull
+        /// resistor or keep their last level. Output pins follow PxOUT. Edges on input pins set PxIFG according to PxIES.
+        class GpioPort : public Peripheral
+        {
+        public:
+            GpioPort(GpioPortRegisters registers, unsigned vector);
+
+            void reset() override;
+            void beforeRead(RegisterBase& reg) override;
+            void afterWrite(RegisterBase& reg) override;
+            [[nodiscard]]
+            bool interruptPending(unsigned vector) const override;
+
+            /// \brief Drive pins from outside.
+            void drive(std::uint8_t pins, bool high);
+
+            /// \brief Stop driving pins from outside.
+            void release(std::uint8_t pins);
+
+            /// \brief The current level of all pins.
+            [[nodiscard]]
+            std::uint8_t level() const { return m_level; }
+
+            /// \brief Pins currently driven by the MCU.
+            [[nodiscard]]
+            std::uint8_t outputs() const;
+
+        private:
+            void update();
+
+            GpioPortRegisters m_registers;
+            unsigned m_vector;
+            std::uint8_t m_level = 0;
+            std::uint8_t m_driven = 0;
+            std::uint8_t m_driven_level = 0;
+        };
+    }
+}
+
+#endif //MSP430HAL_HOST_GPIO_H
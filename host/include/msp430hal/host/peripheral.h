@@ -0,0 +1,86 @@
+#ifndef MSP430HAL_HOST_PERIPHERAL_H
+#define MSP430HAL_HOST_PERIPHERAL_H
+
+#include <cstdint>
+
+#include "register.h"
+
+namespace msp430hal
+{
+    namespace host
+    {
+        /// \brief Simulated time in picoseconds since power on.
+        using Time = std::uint64_t;
+
+        constexpr Time picoseconds_per_second = 1000000000000ull;
+
+        /// \brief Base class of all peripheral models.
+        ///
+        /// A peripheral owns a set of registers. Every access to one of them is reported to the owner, which can update the
+        /// register value before it is read, react after it was read (e.g. clearing a flag) and decide which value is
+        /// stored by a write. Additionally the peripheral is advanced in time and asked for pending interrupts.
+        class Peripheral
+        {
+        public:
+            virtual ~Peripheral() = default;
+
+            /// \brief Restore the state after a power up clear. The registers are already reset when this is called.
+            virtual void reset() {}
+
+            /// \brief Called before the value of reg is read.
+            virtual void beforeRead(RegisterBase&) {}
+
+            /// \brief Called after the value of reg was read.
+            virtual void afterRead(RegisterBase&) {}
+
+            /// \brief Called on every write to reg.
+            ///
+            /// \param reg The written register, it still contains the old value.
+            /// \param value The value written by the CPU.
+            /// \return The value which will be stored in the register.
+            virtual std::uint16_t write([[maybe_unused]] RegisterBase& reg, std::uint16_t value) { return value; }
+
+            /// \brief Called after the value returned by write() was stored.
+            virtual void afterWrite(RegisterBase&) {}
+
+            /// \brief Advance the peripheral from time from to time to.
+            virtual void advance(Time, Time) {}
+
+            /// \brief Check if the peripheral requests the interrupt vector.
+            [[nodiscard]]
+            virtual bool interruptPending(unsigned) const { return false; }
+
+            /// \brief Called when the CPU accepts a interrupt of the peripheral, single source flags are cleared here.
+            virtual void acknowledgeInterrupt(unsigned) {}
+        };
+
+        /// \brief Helper that converts elapsed simulated time in the number of clock edges of a clock with variable frequency.
+        class ClockEdges
+        {
+        public:
+            /// \brief Number of edges of a clock with frequency hz within the duration.
+            std::uint64_t count(Time duration, std::uint32_t hz)
+            {
+                unsigned __int128 total = static_cast<unsigned __int128>(duration) * hz + m_accumulator;
+                m_accumulator = static_cast<std::uint64_t>(total % picoseconds_per_second);
+                return static_cast<std::uint64_t>(total / picoseconds_per_second);
+            }
+
+            void clear()
+            {
+                m_accumulator = 0;
+            }
+
+        private:
+            std::uint64_t m_accumulator = 0;
+        };
+
+        /// \brief Duration of a number of clock cycles of a clock with frequency hz.
+        constexpr Time cyclesToTime(std::uint64_t cycles, std::uint32_t hz)
+        {
+            return (hz == 0) ? 0 : static_cast<Time>((static_cast<unsigned __int128>(cycles) * picoseconds_per_second + hz - 1) / hz);
+        }
+    }
+}
+
+#endif //MSP430HAL_HOST_PERIPHERAL_H
@@ -0,0 +1,161 @@
+#ifndef MSP430HAL_HOST_REGISTER_H
+#define MSP430HAL_HOST_REGISTER_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace msp430hal
+{
+    namespace host
+    {
+        /// \brief The kind of bus access that was performed on a register or memory location.
+        enum class Access : std::uint8_t
+        {
+            read, ///< The value was read.
+            write, ///< The value was written.
+            read_modify_write ///< The value was read, modified and written back by a single operation (BIS, BIC, XOR).
+        };
+
+        /// \brief Describes a single bus access performed by the code under test.
+        struct AccessEvent
+        {
+            std::uint16_t address; ///< Address of the accessed register or memory location.
+            std::uint8_t width; ///< Width of the access in bytes.
+            Access kind; ///< Kind of the access.
+        };
+
+        /// \brief Interface for observers that want to be notified about every bus access.
+        struct AccessListener
+        {
+            virtual ~AccessListener() = default;
+            virtual void onAccess(const AccessEvent& event) = 0;
+        };
+
+        /// \brief Add a listener that is notified about every access performed through a Register or the memory helpers.
+        void addAccessListener(AccessListener* listener);
+
+        /// \brief Remove a previously added access listener.
+        void removeAccessListener(AccessListener* listener);
+
+        /// \brief Untyped storage of a simulated peripheral register.
+        ///
+        /// The value is always stored as 16 bit word, the width decides how many bits are significant.
+        class RegisterBase
+        {
+        public:
+            RegisterBase(const RegisterBase&) = delete;
+
+            [[nodiscard]]
+            std::uint16_t address() const { return m_address; }
+
+            [[nodiscard]]
+            std::uint8_t width() const { return m_width; }
+
+            /// \brief Read the stored value without triggering any side effect or access notification.
+            [[nodiscard]]
+            std::uint16_t peek() const { return m_value; }
+
+            /// \brief Write the stored value without triggering any side effect or access notification.
+            void poke(std::uint16_t value) { m_value = value & mask(); }
+
+            /// \brief Restore the value the register has after a power up clear.
+            void reset() { m_value = m_reset_value; }
+
+            [[nodiscard]]
+            std::uint16_t mask() const { return (m_width == 1) ? 0x00ff : 0xffff; }
+
+        protected:
+            constexpr RegisterBase(std::uint16_t address, std::uint8_t width, std::uint16_t reset_value) noexcept
+                : m_address(address), m_width(width), m_reset_value(reset_value), m_value(reset_value)
+            {}
+
+            ~RegisterBase() = default;
+
+        private:
+            std::uint16_t m_address;
+            std::uint8_t m_width;
+            std::uint16_t m_reset_value;
+            std::uint16_t m_value;
+        };
+
+        /// \brief The modification performed by a read-modify-write access.
+        enum class Modification : std::uint8_t
+        {
+            set_bits, ///< BIS
+            clear_bits, ///< AND/BIC
+            toggle_bits ///< XOR
+        };
+
+        /// \brief Perform a read access including side effects of the owning peripheral and simulated time.
+        std::uint16_t busRead(const RegisterBase& reg);
+
+        /// \brief Perform a write access including side effects of the owning peripheral and simulated time.
+        void busWrite(RegisterBase& reg, std::uint16_t value);
+
+        /// \brief Perform a read-modify-write access including side effects of the owning peripheral and simulated time.
+        void busModify(RegisterBase& reg, Modification modification, std::uint16_t operand);
+
+        /// \brief Write a block of bytes to an absolute memory address (e.g. to flash memory).
+        void writeMemory(std::uint16_t address, const void* data, std::size_t size);
+
+        /// \brief Read a block of bytes from an absolute memory address.
+        void readMemory(std::uint16_t address, void* data, std::size_t size);
+
+        /// \brief A simulated memory mapped peripheral register.
+        ///
+        /// All operators the HAL uses on device registers are provided, every one of them is forwarded to the bus model,
+        /// which notifies the peripheral that owns the address, advances the simulated time and dispatches pending interrupts.
+        ///
+        /// \tparam T std::uint8_t for byte registers, std::uint16_t for word registers.
+        template<typename T>
+        class Register : public RegisterBase
+        {
+            static_assert(sizeof(T) <= 2, "MSP430 registers are either 8 or 16 bit wide");
+        public:
+            using value_type = T;
+
+            constexpr explicit Register(std::uint16_t address, T reset_value = 0) noexcept
+                : RegisterBase(address, sizeof(T), reset_value)
+            {}
+
+            operator T() const
+            {
+                return static_cast<T>(busRead(*this));
+            }
+
+            Register& operator=(T value)
+            {
+                busWrite(*this, value);
+                return *this;
+            }
+
+            /// \brief Register to register transfer, e.g. loading calibration data into a control register.
+            Register& operator=(const Register& other)
+            {
+                return *this = static_cast<T>(other);
+            }
+
+            /// The operand of the compound assignments is promoted like on the target, e.g. reg &= ~BIT7, and only the bits
+            /// of the register are used.
+            Register& operator|=(unsigned value)
+            {
+                busModify(*this, Modification::set_bits, static_cast<T>(value));
+                return *this;
+            }
+
+            Register& operator&=(unsigned value)
+            {
+                busModify(*this, Modification::clear_bits, static_cast<T>(value));
+                return *this;
+            }
+
+            Register& operator^=(unsigned value)
+            {
+                busModify(*this, Modification::toggle_bits, static_cast<T>(value));
+                return *this;
+            }
+        };
+    }
+}
+
+#endif //MSP430HAL_HOST_REGISTER_H
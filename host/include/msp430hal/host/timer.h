@@ -0,0 +1,74 @@
+#ifndef MSP430HAL_HOST_TIMER_H
+#define MSP430HAL_HOST_TIMER_H
+
+#include <cstdint>
+
+#include "peripheral.h"
+
+namespace msp430hal
+{
+    namespace host
+    {
+        class ClockSystem;
+
+        /// \brief The registers of a Timer_A3 instance.
+        struct TimerARegisters
+        {
+            Register<std::uint16_t>& ctl;
+            Register<std::uint16_t>& counter;
+            Register<std::uint16_t>& iv;
+            Register<std::uint16_t>* cctl[3];
+            Register<std::uint16_t>* ccr[3];
+        };
+
+        /// \brief Model of a Timer_A3 with up, continuous and up/down mode, compare outputs and capture inputs.
+        class TimerA : public Peripheral
+        {
+        public:
+            static constexpr std::uint8_t units = 3;
+
+            TimerA(TimerARegisters registers, const ClockSystem& clocks, unsigned vector_ccr0, unsigned vector_other);
+
+            void reset() override;
+            void beforeRead(RegisterBase& reg) override;
+            void afterRead(RegisterBase& reg) override;
+            std::uint16_t write(RegisterBase& reg, std::uint16_t value) override;
+            void afterWrite(RegisterBase& reg) override;
+            void advance(Time from, Time to) override;
+            [[nodiscard]]
+            bool interruptPending(unsigned vector) const override;
+            void acknowledgeInterrupt(unsigned vector) override;
+
+            /// \brief Drive the capture input CCIxA or CCIxB of a capture/compare unit from outside.
+            void setCaptureInput(std::uint8_t unit, bool ccixb, bool level);
+
+            /// \brief The level of the output signal OUTx of a capture/compare unit.
+            [[nodiscard]]
+            bool output(std::uint8_t unit) const { return m_output[unit]; }
+
+        private:
+            [[nodiscard]]
+            std::uint32_t tickFrequency() const;
+            [[nodiscard]]
+            bool captureInput(std::uint8_t unit) const;
+            [[nodiscard]]
+            std::uint16_t pendingVector() const;
+            void tick();
+            void equal(std::uint8_t unit);
+            void updateCaptureInput(std::uint8_t unit);
+
+            TimerARegisters m_registers;
+            const ClockSystem& m_clocks;
+            unsigned m_vector_ccr0;
+            unsigned m_vector_other;
+            ClockEdges m_edges;
+            bool m_counting_down = false;
+            bool m_output[units] = {};
+            bool m_input[units][2] = {};
+            bool m_cci[units] = {};
+            bool m_capture_unread[units] = {};
+        };
+    }
+}
+
+#endif //MSP430HAL_HOST_TIMER_H
@@ -0,0 +1,422 @@
+#ifndef MSP430HAL_HOST_USCI_H
+#define MSP430HAL_HOST_USCI_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "peripheral.h"
+
+namespace msp430hal
+{
+    namespace host
+    {
+        class ClockSystem;
+
+        /// \brief A character on a UART line.
+        struct UartFrame
+        {
+            std::uint8_t data = 0;
+            bool address = false; ///< Address bit set (address-bit mode) or preceded by an idle period (idle-line mode).
+            bool break_condition = false; ///< The frame is a break.
+            bool framing_error = false; ///< The frame has an invalid stop bit.
+            bool parity_error = false; ///< The frame has a wrong parity bit.
+        };
+
+        /// \brief A device connected to a SPI bus driven by the simulated USCI in master mode.
+        struct SpiDevice
+        {
+            virtual ~SpiDevice() = default;
+
+            /// \brief Exchange one character, called when the last bit is shifted.
+            ///
+            /// \param mosi The character sent by the master.
+            /// \return The character sent to the master.
+            virtual std::uint8_t exchange(std::uint8_t mosi) = 0;
+        };
+
+        /// \brief A slave connected to the I2C bus driven by the simulated USCI in master mode.
+        struct I2CDevice
+        {
+            virtual ~I2CDevice() = default;
+
+            /// \brief The slave got addressed after a (repeated) start condition.
+            ///
+            /// \param read True if the master wants to read.
+            /// \return True to acknowledge the address.
+            virtual bool start([[maybe_unused]] bool read) { return true; }
+
+            /// \brief The master sent a byte.
+            ///
+            /// \return True to acknowledge the byte.
+            virtual bool write(std::uint8_t) { return true; }
+
+            /// \brief The master reads a byte.
+            virtual std::uint8_t read() { return 0xff; }
+
+            /// \brief The master generated a stop condition.
+            virtual void stop() {}
+
+            /// \brief How long the slave holds SCL low after each acknowledge, e.g. while it is busy or hung.
+            virtual Time holdScl() { return 0; }
+        };
+
+        /// \brief The registers of a USCI module.
+        struct UsciRegisters
+        {
+            Register<std::uint8_t>& ctl0;
+            Register<std::uint8_t>& ctl1;
+            Register<std::uint8_t>& br0;
+            Register<std::uint8_t>& br1;
+            Register<std::uint8_t>* mctl;
+            Register<std::uint8_t>& stat;
+            Register<std::uint8_t>& rx_buf;
+            Register<std::uint8_t>& tx_buf;
+            Register<std::uint8_t>& ie;
+            Register<std::uint8_t>& ifg;
+            std::uint8_t rx_flag;
+            std::uint8_t tx_flag;
+        };
+
+        /// \brief Common part of the USCI_A and USCI_B models: double buffered transmitter, SPI master and
+        /// SPI slave mode.
+        class Usci : public Peripheral
+        {
+        public:
+            Usci(UsciRegisters registers, const ClockSystem& clocks, unsigned rx_vector, unsigned tx_vector);
+
+            void reset() override;
+            void afterRead(RegisterBase& reg) override;
+            std::uint16_t write(RegisterBase& reg, std::uint16_t value) override;
+            void afterWrite(RegisterBase& reg) override;
+            void advance(Time from, Time to) override;
+            [[nodiscard]]
+            bool interruptPending(unsigned vector) const override;
+
+            /// \brief Connect a device to the SPI bus, nullptr disconnects it.
+            void attachSpiDevice(SpiDevice* device) { m_spi_device = device; }
+
+            /// \brief All bytes shifted out since power on or the last call of clearTransmitted().
+            [[nodiscard]]
+            const std::vector<std::uint8_t>& transmitted() const { return m_transmitted; }
+
+            void clearTransmitted() { m_transmitted.clear(); m_slave_responses.clear(); }
+
+            /// \brief An external SPI master selects the module in SPI slave mode and exchanges characters with it.
+            ///
+            /// STE (P1.5 for USCI_A0, P1.4 for USCI_B0) is driven low one bit time before the first character and
+            /// released one bit time after the last one; the characters are clocked back to back at the given bit rate,
+            /// after the exchanges that are still pending. Like on the device, TXBUF moves into the shift register and
+            /// sets TXIFG as soon as the shift register is free: right when TXBUF is written between characters,
+            /// otherwise at the end of the character. So two characters can be loaded before the first clock. If
+            /// nothing was loaded, the old content of TXBUF is sent again. The received character is stored in RXBUF at
+            /// the end of the character.
+            ///
+            /// \param data The characters sent by the master (SIMO).
+            /// \param bit_rate The SPI clock frequency of the master.
+            void slaveTransfer(const std::uint8_t* data, std::size_t size, std::uint32_t bit_rate);
+
+            /// \brief All characters the module sent to an external master (SOMI) since power on or the last call of
+            /// clearTransmitted().
+            [[nodiscard]]
+            const std::vector<std::uint8_t>& slaveResponses() const { return m_slave_responses; }
+
+            /// \brief Are exchanges with an external master still pending?
+            [[nodiscard]]
+            bool slaveTransferPending() const { return !m_slave_events.empty(); }
+
+            /// \brief Frequency of the bit clock source BRCLK.
+            [[nodiscard]]
+            std::uint32_t brclk() const;
+
+            [[nodiscard]]
+            std::uint16_t prescaler() const;
+
+        protected:
+            [[nodiscard]]
+            bool inReset() const { return m_registers.ctl1.peek() & 0x01; }
+            [[nodiscard]]
+            bool synchronous() const { return m_registers.ctl0.peek() & 0x01; }
+            [[nodiscard]]
+            std::uint8_t mode() const { return m_registers.ctl0.peek() & 0x06; }
+
+            void setFlag(std::uint8_t flag);
+            void clearFlag(std::uint8_t flag);
+            [[nodiscard]]
+            bool flag(std::uint8_t flag) const { return m_registers.ifg.peek() & flag; }
+            void setStatus(std::uint8_t bits);
+            void clearStatus(std::uint8_t bits);
+
+            /// \brief Called when the module enters the reset state.
+            virtual void enterReset();
+
+            /// \brief Try to move TXBUF into the shift register. Handles the synchronous (SPI) case.
+            virtual void startTransfer(Time now);
+
+            /// \brief Called when the shift register was shifted out completely.
+            virtual void finishTransfer(Time now);
+
+            /// \brief Store a received character in RXBUF, sets the overrun error if RXBUF was not read.
+            void receiveCharacter(std::uint8_t data);
+
+            /// \brief Called for character specific timing events, returns the next event time or 0.
+            virtual void process(Time) {}
+            [[nodiscard]]
+            virtual Time nextEvent() const { return 0; }
+
+            [[nodiscard]]
+            Time spiCharacterTime() const;
+
+            /// \brief The STE pin on port 1.
+            [[nodiscard]]
+            virtual std::uint8_t stePin() const = 0;
+
+            /// \brief Handle the next step of an exchange with an external master.
+            virtual void processSlave();
+
+            /// \brief Move TXBUF into the shift register of the SPI slave if it is free.
+            void loadSlaveShift();
+
+            /// \brief An external master waits until the module released SCL, all its pending steps are delayed.
+            void holdSlave();
+
+            /// \brief The module released SCL, the external master continues.
+            void releaseSlave();
+
+            struct SlaveEvent
+            {
+                enum class Kind
+                {
+                    select,
+                    start,
+                    finish,
+                    release,
+                    i2c_start, ///< (Repeated) start condition.
+                    i2c_address, ///< The address and R/W bit were sent, data holds both.
+                    i2c_write, ///< The master sent data, the slave acknowledges.
+                    i2c_read, ///< The master starts reading a byte.
+                    i2c_stop ///< Stop condition.
+                };
+
+                Time time;
+                Kind kind;
+                std::uint8_t data = 0;
+            };
+
+            UsciRegisters m_registers;
+            const ClockSystem& m_clocks;
+            unsigned m_rx_vector;
+            unsigned m_tx_vector;
+            SpiDevice* m_spi_device = nullptr;
+            std::vector<std::uint8_t> m_transmitted;
+
+            bool m_tx_pending = false;
+            std::uint8_t m_tx_data = 0;
+            bool m_shifting = false;
+            std::uint8_t m_shift_data = 0;
+            Time m_shift_done = 0;
+            bool m_slave_loaded = false;
+            std::uint8_t m_slave_shift = 0;
+            std::deque<SlaveEvent> m_slave_events;
+            std::vector<std::uint8_t> m_slave_responses;
+            bool m_slave_held = false;
+            Time m_slave_held_since = 0;
+        };
+
+        /// \brief Model of USCI_A in UART or SPI mode.
+        class UsciA : public Usci
+        {
+        public:
+            UsciA(UsciRegisters registers, Register<std::uint8_t>& ab_ctl, const ClockSystem& clocks, unsigned rx_vector, unsigned tx_vector);
+
+            void reset() override;
+
+            /// \brief A character arrives at UCAxRXD after the characters that are already on the line.
+            void receive(const UartFrame& frame);
+
+            void receive(std::uint8_t data);
+
+            void receive(const std::uint8_t* data, std::size_t size);
+
+            /// \brief A break, a break delimiter and a synch field (0x55) sent at the given baud rate arrive at UCAxRXD.
+            ///
+            /// With automatic baud rate detection the synch field is measured and the result is written into UCAxBRx
+            /// and UCAxMCTL, otherwise the break and the synch character are received as usual. The length of the
+            /// delimiter is not checked against UCDELIMx.
+            ///
+            /// \param baud_rate The baud rate of the sender.
+            /// \param break_bits The length of the break in bits of the sender.
+            /// \param delimiter_bits The length of the break delimiter in bits of the sender.
+            void receiveBreakSync(std::uint32_t baud_rate, unsigned break_bits = 13, unsigned delimiter_bits = 1);
+
+            /// \brief All frames sent in UART mode since power on or the last call of clearTransmitted().
+            [[nodiscard]]
+            const std::vector<UartFrame>& transmittedFrames() const { return m_frames; }
+
+            void clearTransmitted() { Usci::clearTransmitted(); m_frames.clear(); }
+
+            /// \brief Duration of a single UART character with the current configuration.
+            [[nodiscard]]
+            Time characterTime() const;
+
+            /// \brief The number of characters that are still on the way to UCAxRXD.
+            [[nodiscard]]
+            std::size_t pendingReceive() const { return m_rx_queue.size(); }
+
+        protected:
+            void enterReset() override;
+            void startTransfer(Time now) override;
+            void finishTransfer(Time now) override;
+            void process(Time now) override;
+            [[nodiscard]]
+            Time nextEvent() const override;
+            [[nodiscard]]
+            std::uint8_t stePin() const override;
+
+            /// \param idle_line The line was idle for at least ten bits before the character.
+            void deliver(const UartFrame& frame, bool idle_line = false);
+
+            [[nodiscard]]
+            std::uint8_t frameBits() const;
+            [[nodiscard]]
+            bool automaticBaudRate() const;
+
+            /// \brief The break of a break/synch sequence ended.
+            void detectBreak(Time length);
+
+            /// \brief The synch field of a break/synch sequence was received.
+            void synchronize(std::uint32_t baud_rate);
+
+            struct PendingFrame
+            {
+                Time arrival;
+                UartFrame frame;
+                Time break_length = 0; ///< Nonzero for the break of a break/synch sequence.
+                std::uint32_t sync_baud_rate = 0; ///< Nonzero for the synch field of a break/synch sequence.
+            };
+
+            Register<std::uint8_t>& m_ab_ctl;
+            bool m_break_detected = false;
+            bool m_sync_received = false;
+            Time m_last_receive = 0;
+            std::deque<PendingFrame> m_rx_queue;
+            std::vector<UartFrame> m_frames;
+            UartFrame m_shift_frame;
+        };
+
+        /// \brief Model of USCI_B in SPI or I2C master mode and SPI or I2C slave mode.
+        class UsciB : public Usci
+        {
+        public:
+            UsciB(UsciRegisters registers, Register<std::uint8_t>& i2c_ie, Register<std::uint16_t>& i2c_oa,
+                  Register<std::uint16_t>& i2c_sa, const ClockSystem& clocks, unsigned rx_vector, unsigned tx_vector);
+
+            void reset() override;
+            void afterRead(RegisterBase& reg) override;
+            std::uint16_t write(RegisterBase& reg, std::uint16_t value) override;
+            void afterWrite(RegisterBase& reg) override;
+            [[nodiscard]]
+            bool interruptPending(unsigned vector) const override;
+
+            /// \brief Connect a slave with the given 7 bit address to the I2C bus, nullptr disconnects it.
+            void attachI2CDevice(std::uint16_t address, I2CDevice* device);
+
+            /// \brief An external master addresses the module in I2C slave mode.
+            ///
+            /// The master writes size bytes, then reads read_size bytes after a repeated start (or a start if nothing
+            /// is written) and generates a stop condition, at the given SCL frequency and after the transfers that are
+            /// still pending. It acknowledges every byte it reads except for the last one.
+            ///
+            /// The module holds SCL low while a received byte waits for RXBUF to be read, or while TXBUF is empty when
+            /// the master reads the next byte; the master waits for it (see i2cStretchTime()). A byte which is left in
+            /// TXBUF at a start or stop condition is discarded. If the module does not acknowledge the address, the
+            /// master generates the stop condition right away. The bytes read by the master are appended to
+            /// slaveResponses().
+            ///
+            /// \param address The 7 bit address the master sends.
+            /// \param bit_rate The SCL frequency of the master.
+            void i2cMasterTransfer(std::uint8_t address, const std::uint8_t* data, std::size_t size,
+                                   std::size_t read_size, std::uint32_t bit_rate);
+
+            /// \brief Another master wins the arbitration against the current transfer of the module in master mode.
+            ///
+            /// Like on the device, the module switches to slave mode and sets UCALIFG. The other master occupies the bus,
+            /// UCBBUSY stays set until releaseI2CBus().
+            void loseArbitration();
+
+            /// \brief The other master generates its stop condition after loseArbitration().
+            void releaseI2CBus();
+
+            /// \brief How long the module held SCL low in slave mode since power on.
+            [[nodiscard]]
+            Time i2cStretchTime() const { return m_i2c_stretch_time; }
+
+            /// \brief The number of addresses sent by an external master which were not acknowledged.
+            [[nodiscard]]
+            std::size_t i2cAddressNacks() const { return m_i2c_address_nacks; }
+
+            [[nodiscard]]
+            bool i2cMode() const { return synchronous() && mode() == 0x06; }
+
+            /// \brief Duration of one SCL period.
+            [[nodiscard]]
+            Time sclPeriod() const;
+
+        protected:
+            enum class I2CState
+            {
+                idle,
+                address,
+                transmit,
+                wait_transmit,
+                receive,
+                wait_receive,
+                wait_nack,
+                stop
+            };
+
+            void enterReset() override;
+            void startTransfer(Time now) override;
+            void finishTransfer(Time now) override;
+            void process(Time now) override;
+            [[nodiscard]]
+            Time nextEvent() const override;
+            [[nodiscard]]
+            std::uint8_t stePin() const override;
+            void processSlave() override;
+
+            /// \brief Does the own address (or the general call with UCGCEN) match?
+            [[nodiscard]]
+            bool i2cOwnAddress(std::uint8_t address) const;
+
+            void i2cStart(Time now);
+            void i2cAddressDone(Time now);
+            void i2cTransmitDone(Time now);
+            void i2cReceiveDone(Time now);
+            void i2cDeliver(Time now);
+            void i2cAfterAcknowledge(Time now);
+            void i2cStop(Time now);
+            /// \brief SCL was released in slave mode.
+            void i2cRelease();
+            void i2cSchedule(Time now, std::uint32_t scl_periods);
+
+            Register<std::uint8_t>& m_i2c_ie;
+            Register<std::uint16_t>& m_i2c_oa;
+            Register<std::uint16_t>& m_i2c_sa;
+            std::map<std::uint16_t, I2CDevice*> m_i2c_devices;
+            I2CDevice* m_i2c_slave = nullptr;
+            I2CState m_i2c_state = I2CState::idle;
+            Time m_i2c_event = 0;
+            bool m_i2c_read = false;
+            std::uint8_t m_i2c_received = 0;
+            bool m_i2c_addressed = false;
+            Time m_i2c_stretch_time = 0;
+            std::size_t m_i2c_address_nacks = 0;
+            bool m_i2c_foreign_busy = false;
+        };
+    }
+}
+
+#endif //MSP430HAL_HOST_USCI_H
@@ -0,0 +1,42 @@
+#ifndef MSP430HAL_HOST_WATCHDOG_H
+#define MSP430HAL_HOST_WATCHDOG_H
+
+#include <cstdint>
+
+#include "peripheral.h"
+
+namespace msp430hal
+{
+    namespace host
+    {
+        class ClockSystem;
+        class Device;
+
+        /// \brief Model of the watchdog timer+.
+        ///
+        /// A write without the password or the expiration of the interval in watchdog mode triggers a power up clear.
+        class Watchdog : public Peripheral
+        {
+        public:
+            Watchdog(Device& device, const ClockSystem& clocks);
+
+            void reset() override;
+            std::uint16_t write(RegisterBase& reg, std::uint16_t value) override;
+            void advance(Time from, Time to) override;
+            [[nodiscard]]
+            bool interruptPending(unsigned vector) const override;
+            void acknowledgeInterrupt(unsigned vector) override;
+
+            [[nodiscard]]
+            std::uint16_t counter() const { return m_counter; }
+
+        private:
+            Device& m_device;
+            const ClockSystem& m_clocks;
+            ClockEdges m_edges;
+            std::uint16_t m_counter = 0;
+        };
+    }
+}
+
+#endif //MSP430HAL_HOST_WATCHDOG_H
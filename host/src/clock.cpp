@@ -0,0 +1,77 @@
+#include "msp430hal/host/clock.h"
+
+#include <cmath>
+
+#include <msp430.h>
+
+namespace msp430hal
+{
+    namespace host
+    {
+        void ClockSystem::reset()
+        {
+            updateDco();
+        }
+
+        void ClockSystem::afterWrite(RegisterBase& reg)
+        {
+            if (&reg == &DCOCTL || &reg == &BCSCTL1)
+                updateDco();
+        }
+
+        void ClockSystem::updateDco()
+        {
+            std::uint8_t rsel = BCSCTL1.peek() & 0x0f;
+            std::uint8_t dcoctl = DCOCTL.peek();
+
+            // The factory calibrated settings map to their nominal frequency.
+            const struct
+            {
+                const Register<std::uint8_t>& bcsctl1;
+                const Register<std::uint8_t>& dcoctl;
+                std::uint32_t hz;
+            } calibrations[] = {
+                    {CALBC1_1MHZ, CALDCO_1MHZ, 1000000},
+                    {CALBC1_8MHZ, CALDCO_8MHZ, 8000000},
+                    {CALBC1_12MHZ, CALDCO_12MHZ, 12000000},
+                    {CALBC1_16MHZ, CALDCO_16MHZ, 16000000},
+            };
+            for (const auto& calibration : calibrations)
+            {
+                if ((calibration.bcsctl1.peek() & 0x0f) == rsel && calibration.dcoctl.peek() == dcoctl)
+                {
+                    m_dco_hz = calibration.hz;
+                    return;
+                }
+            }
+
+            // Typical values of the datasheet: ~1.1 MHz at RSEL=7 DCO=3, RSEL steps by 1.35, DCO steps by 1.08.
+            double dco = (dcoctl >> 5) + (dcoctl & 0x1f) / 32.;
+            m_dco_hz = static_cast<std::uint32_t>(1100000. * std::pow(1.35, rsel - 7.) * std::pow(1.08, dco - 3.));
+        }
+
+        std::uint32_t ClockSystem::lfxt1() const
+        {
+            return ((BCSCTL3.peek() & 0x30) == LFXT1S_2) ? m_oscillators.vlo_hz : m_oscillators.lfxt1_hz;
+        }
+
+        std::uint32_t ClockSystem::mclk() const
+        {
+            std::uint8_t bcsctl2 = BCSCTL2.peek();
+            std::uint32_t source = (bcsctl2 & 0x80) ? lfxt1() : m_dco_hz;
+            return source >> ((bcsctl2 & 0x30) >> 4);
+        }
+
+        std::uint32_t ClockSystem::smclk() const
+        {
+            std::uint8_t bcsctl2 = BCSCTL2.peek();
+            std::uint32_t source = (bcsctl2 & SELS) ? lfxt1() : m_dco_hz;
+            return source >> ((bcsctl2 & 0x06) >> 1);
+        }
+
+        std::uint32_t ClockSystem::aclk() const
+        {
+            return lfxt1() >> ((BCSCTL1.peek() & 0x30) >> 4);
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#include "msp430hal/host/comparator.h"
+
+#include <msp430.h>
+
+namespace msp430hal
+{
+    namespace host
+    {
+        void Comparator::reset()
+        {
+            m_result = false;
+        }
+
+        std::uint16_t Comparator::write(RegisterBase& reg, std::uint16_t value)
+        {
+            // CAOUT is read only
+            if (&reg == &CACTL2)
+                return (value & ~CAOUT) | (reg.peek() & CAOUT);
+            return value;
+        }
+
+        void Comparator::afterWrite(RegisterBase&)
+        {
+            update();
+        }
+
+        void Comparator::setResult(bool result)
+        {
+            m_result = result;
+            update();
+        }
+
+        void Comparator::update()
+        {
+            bool previous = CACTL2.peek() & CAOUT;
+            bool output = (CACTL1.peek() & CAON) && m_result;
+            if (output == previous)
+                return;
+
+            CACTL2.poke(output ? (CACTL2.peek() | CAOUT) : (CACTL2.peek() & ~CAOUT));
+            bool falling_edge = CACTL1.peek() & CAIES;
+            if (output != falling_edge)
+                CACTL1.poke(CACTL1.peek() | CAIFG);
+        }
+
+        bool Comparator::interruptPending(unsigned vector) const
+        {
+            return vector == COMPARATORA_VECTOR && (CACTL1.peek() & CAIFG) && (CACTL1.peek() & CAIE);
+        }
+
+        void Comparator::acknowledgeInterrupt(unsigned)
+        {
+            CACTL1.poke(CACTL1.peek() & ~CAIFG);
+        }
+    }
+}
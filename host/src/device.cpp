@@ -0,0 +1,425 @@
+#include "msp430hal/host/device.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include <msp430.h>
+
+#include "device_registers.h"
+
+namespace msp430hal
+{
+    namespace host
+    {
+        namespace
+        {
+            /// Longest time span a peripheral is advanced at once, keeps interrupt latency during delays and sleep low.
+            constexpr Time time_quantum = 1000000;
+        }
+
+        Device& Device::instance()
+        {
+            static Device device;
+            return device;
+        }
+
+        Device::Device()
+            : m_port1({P1IN, P1OUT, P1DIR, &P1IFG, &P1IES, &P1IE, P1SEL, P1SEL2, P1REN}, PORT1_VECTOR),
+              m_port2({P2IN, P2OUT, P2DIR, &P2IFG, &P2IES, &P2IE, P2SEL, P2SEL2, P2REN}, PORT2_VECTOR),
+              m_port3({P3IN, P3OUT, P3DIR, nullptr, nullptr, nullptr, P3SEL, P3SEL2, P3REN}, 0),
+              m_timer_a0({TA0CTL, TA0R, TA0IV, {&TA0CCTL0, &TA0CCTL1, &TA0CCTL2}, {&TA0CCR0, &TA0CCR1, &TA0CCR2}},
+                         m_clocks, TIMER0_A0_VECTOR, TIMER0_A1_VECTOR),
+              m_timer_a1({TA1CTL, TA1R, TA1IV, {&TA1CCTL0, &TA1CCTL1, &TA1CCTL2}, {&TA1CCR0, &TA1CCR1, &TA1CCR2}},
+                         m_clocks, TIMER1_A0_VECTOR, TIMER1_A1_VECTOR),
+              m_usci_a0({UCA0CTL0, UCA0CTL1, UCA0BR0, UCA0BR1, &UCA0MCTL, UCA0STAT, UCA0RXBUF, UCA0TXBUF, IE2, IFG2,
+                         UCA0RXIFG, UCA0TXIFG}, UCA0ABCTL, m_clocks, USCIAB0RX_VECTOR, USCIAB0TX_VECTOR),
+              m_usci_b0({UCB0CTL0, UCB0CTL1, UCB0BR0, UCB0BR1, nullptr, UCB0STAT, UCB0RXBUF, UCB0TXBUF, IE2, IFG2,
+                         UCB0RXIFG, UCB0TXIFG}, UCB0I2CIE, UCB0I2COA, UCB0I2CSA, m_clocks, USCIAB0RX_VECTOR, USCIAB0TX_VECTOR),
+              m_flash(*this, m_clocks),
+              m_watchdog(*this, m_clocks)
+        {
+            m_peripherals = {&m_clocks, &m_port1, &m_port2, &m_port3, &m_timer_a0, &m_timer_a1, &m_usci_a0, &m_usci_b0,
+                             &m_comparator, &m_flash, &m_watchdog};
+
+            own(m_clocks, {&DCOCTL, &BCSCTL1, &BCSCTL2, &BCSCTL3});
+            own(m_port1, {&P1IN, &P1OUT, &P1DIR, &P1IFG, &P1IES, &P1IE, &P1SEL, &P1SEL2, &P1REN});
+            own(m_port2, {&P2IN, &P2OUT, &P2DIR, &P2IFG, &P2IES, &P2IE, &P2SEL, &P2SEL2, &P2REN});
+            own(m_port3, {&P3IN, &P3OUT, &P3DIR, &P3SEL, &P3SEL2, &P3REN});
+            own(m_timer_a0, {&TA0CTL, &TA0R, &TA0IV, &TA0CCTL0, &TA0CCTL1, &TA0CCTL2, &TA0CCR0, &TA0CCR1, &TA0CCR2});
+            own(m_timer_a1, {&TA1CTL, &TA1R, &TA1IV, &TA1CCTL0, &TA1CCTL1, &TA1CCTL2, &TA1CCR0, &TA1CCR1, &TA1CCR2});
+            own(m_usci_a0, {&UCA0CTL0, &UCA0CTL1, &UCA0BR0, &UCA0BR1, &UCA0MCTL, &UCA0STAT, &UCA0RXBUF,
+                            &UCA0TXBUF, &UCA0ABCTL, &UCA0IRTCTL, &UCA0IRRCTL});
+            own(m_usci_b0, {&UCB0CTL0, &UCB0CTL1, &UCB0BR0, &UCB0BR1, &UCB0I2CIE, &UCB0STAT, &UCB0RXBUF,
+                            &UCB0TXBUF, &UCB0I2COA, &UCB0I2CSA});
+            own(m_comparator, {&CACTL1, &CACTL2, &CAPD});
+            own(m_flash, {&FCTL1, &FCTL2, &FCTL3, &CALDCO_16MHZ, &CALBC1_16MHZ, &CALDCO_12MHZ,
+                         &CALBC1_12MHZ, &CALDCO_8MHZ, &CALBC1_8MHZ, &CALDCO_1MHZ, &CALBC1_1MHZ});
+            own(m_watchdog, {&WDTCTL});
+
+            powerOn();
+        }
+
+        void Device::own(Peripheral& peripheral, std::initializer_list<RegisterBase*> registers)
+        {
+            for (RegisterBase* reg : registers)
+            {
+                m_owners[reg->address()] = &peripheral;
+                if (reg->width() == 2)
+                    m_owners[reg->address() + 1] = &peripheral;
+            }
+        }
+
+        void Device::powerOn()
+        {
+            m_now = 0;
+            m_cycles = 0;
+            m_handlers = {};
+            m_ram = {};
+            m_clocks.oscillators() = Oscillators{};
+            m_usci_a0.attachSpiDevice(nullptr);
+            m_usci_a0.clearTransmitted();
+            m_usci_b0.attachSpiDevice(nullptr);
+            m_usci_b0.clearTransmitted();
+            for (std::uint16_t address = 0; address < 0x80; ++address)
+                m_usci_b0.attachI2CDevice(address, nullptr);
+            m_flash.restoreFactoryState();
+            resetState();
+        }
+
+        void Device::resetState()
+        {
+            m_status_register = 0;
+            m_saved_status_registers.clear();
+            for (RegisterBase* reg : deviceRegisters())
+                reg->reset();
+            for (Peripheral* peripheral : m_peripherals)
+                peripheral->reset();
+        }
+
+        void Device::reset(const char* cause)
+        {
+            resetState();
+            throw DeviceReset(std::string("power up clear: ") + cause);
+        }
+
+        void Device::step(Time duration)
+        {
+            Time to = m_now + duration;
+            for (Peripheral* peripheral : m_peripherals)
+                peripheral->advance(m_now, to);
+            m_now = to;
+        }
+
+        void Device::advance(Time duration)
+        {
+            while (duration > 0)
+            {
+                Time quantum = std::min(duration, time_quantum);
+                step(quantum);
+                duration -= quantum;
+                serviceInterrupts();
+            }
+        }
+
+        void Device::stall(Time duration)
+        {
+            while (duration > 0)
+            {
+                Time quantum = std::min(duration, time_quantum);
+                step(quantum);
+                duration -= quantum;
+            }
+        }
+
+        void Device::execute(std::uint32_t cycles)
+        {
+            m_cycles += cycles;
+            advance(cyclesToTime(cycles, m_clocks.mclk()));
+        }
+
+        void Device::sleep()
+        {
+            Time slept = 0;
+            while (m_status_register & CPUOFF)
+            {
+                if (slept >= m_sleep_timeout)
+                    throw SimulationError("CPU was not woken up from low power mode");
+                step(time_quantum);
+                slept += time_quantum;
+                serviceInterrupts();
+            }
+        }
+
+        void Device::attachInterrupt(unsigned vector, std::function<void()> handler)
+        {
+            m_handlers.at(vector) = std::move(handler);
+        }
+
+        void Device::detachInterrupt(unsigned vector)
+        {
+            m_handlers.at(vector) = nullptr;
+        }
+
+        void Device::serviceInterrupts()
+        {
+            while (m_status_register & GIE)
+            {
+                unsigned vector = m_handlers.size();
+                Peripheral* source = nullptr;
+                for (unsigned candidate = m_handlers.size() - 1; candidate > 0 && !source; --candidate)
+                {
+                    for (Peripheral* peripheral : m_peripherals)
+                    {
+                        if (peripheral->interruptPending(candidate))
+                        {
+                            vector = candidate;
+                            source = peripheral;
+                            break;
+                        }
+                    }
+                }
+                if (!source)
+                    return;
+                if (!m_handlers[vector])
+                    throw SimulationError("interrupt " + std::to_string(vector) + " is pending but has no handler");
+
+                source->acknowledgeInterrupt(vector);
+                m_saved_status_registers.push_back(m_status_register);
+                m_status_register = 0;
+                // Interrupt latency: push PC and SR, load vector
+                execute(6);
+                m_handlers[vector]();
+                // RETI
+                execute(5);
+                m_status_register = m_saved_status_registers.back();
+                m_saved_status_registers.pop_back();
+            }
+        }
+
+        void Device::setStatusRegister(std::uint16_t value)
+        {
+            bool enable = !(m_status_register & GIE) && (value & GIE);
+            m_status_register = value;
+            if (m_status_register & CPUOFF)
+                sleep();
+            else if (enable)
+                serviceInterrupts();
+        }
+
+        void Device::modifyStatusRegisterOnExit(std::uint16_t set, std::uint16_t clear)
+        {
+            if (m_saved_status_registers.empty())
+            {
+                m_status_register = (m_status_register | set) & ~clear;
+                return;
+            }
+            m_saved_status_registers.back() = (m_saved_status_registers.back() | set) & ~clear;
+        }
+
+        GpioPort& Device::port(unsigned number)
+        {
+            switch (number)
+            {
+                case 1:
+                    return m_port1;
+                case 2:
+                    return m_port2;
+                case 3:
+                    return m_port3;
+                default:
+                    throw std::out_of_range("the simulated device has the ports 1 to 3");
+            }
+        }
+
+        TimerA& Device::timerA(unsigned instance)
+        {
+            switch (instance)
+            {
+                case 0:
+                    return m_timer_a0;
+                case 1:
+                    return m_timer_a1;
+                default:
+                    throw std::out_of_range("the simulated device has the timers A0 and A1");
+            }
+        }
+
+        void Device::addAccessListener(AccessListener* listener)
+        {
+            m_listeners.push_back(listener);
+        }
+
+        void Device::removeAccessListener(AccessListener* listener)
+        {
+            m_listeners.erase(std::remove(m_listeners.begin(), m_listeners.end(), listener), m_listeners.end());
+        }
+
+        void Device::notify(const AccessEvent& event)
+        {
+            for (AccessListener* listener : m_listeners)
+                listener->onAccess(event);
+        }
+
+        void Device::writeMemory(std::uint16_t address, const void* data, std::size_t size)
+        {
+            notify({address, static_cast<std::uint8_t>(size), Access::write});
+            if (FlashController::isFlash(address))
+                m_flash.program(address, static_cast<const std::uint8_t*>(data), size);
+            else
+                std::memcpy(&m_ram[address], data, std::min<std::size_t>(size, m_ram.size() - address));
+            execute(m_timing.write);
+        }
+
+        void Device::readMemory(std::uint16_t address, void* data, std::size_t size)
+        {
+            notify({address, static_cast<std::uint8_t>(size), Access::read});
+            auto* bytes = static_cast<std::uint8_t*>(data);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                std::uint16_t location = address + i;
+                bytes[i] = FlashController::isFlash(location) ? m_flash.read(location) : m_ram[location];
+            }
+            execute(m_timing.read);
+        }
+
+        void addAccessListener(AccessListener* listener)
+        {
+            Device::instance().addAccessListener(listener);
+        }
+
+        void removeAccessListener(AccessListener* listener)
+        {
+            Device::instance().removeAccessListener(listener);
+        }
+
+        std::uint16_t busRead(const RegisterBase& const_reg)
+        {
+            Device& device = Device::instance();
+            auto& reg = const_cast<RegisterBase&>(const_reg);
+            Peripheral* owner = device.owner(reg.address());
+            if (owner)
+                owner->beforeRead(reg);
+            std::uint16_t value = reg.peek();
+            if (owner)
+                owner->afterRead(reg);
+            device.notify({reg.address(), reg.width(), Access::read});
+            device.execute(device.timing().read);
+            return value;
+        }
+
+        void busWrite(RegisterBase& reg, std::uint16_t value)
+        {
+            Device& device = Device::instance();
+            Peripheral* owner = device.owner(reg.address());
+            value &= reg.mask();
+            if (owner)
+            {
+                reg.poke(owner->write(reg, value));
+                owner->afterWrite(reg);
+            }
+            else
+                reg.poke(value);
+            device.notify({reg.address(), reg.width(), Access::write});
+            device.execute(device.timing().write);
+        }
+
+        void busModify(RegisterBase& reg, Modification modification, std::uint16_t operand)
+        {
+            Device& device = Device::instance();
+            Peripheral* owner = device.owner(reg.address());
+            if (owner)
+                owner->beforeRead(reg);
+            std::uint16_t value = reg.peek();
+            switch (modification)
+            {
+                case Modification::set_bits:
+                    value |= operand;
+                    break;
+                case Modification::clear_bits:
+                    value &= operand;
+                    break;
+                case Modification::toggle_bits:
+                    value ^= operand;
+                    break;
+            }
+            value &= reg.mask();
+            if (owner)
+            {
+                reg.poke(owner->write(reg, value));
+                owner->afterWrite(reg);
+            }
+            else
+                reg.poke(value);
+            device.notify({reg.address(), reg.width(), Access::read_modify_write});
+            device.execute(device.timing().read_modify_write);
+        }
+
+        void writeMemory(std::uint16_t address, const void* data, std::size_t size)
+        {
+            Device::instance().writeMemory(address, data, size);
+        }
+
+        void readMemory(std::uint16_t address, void* data, std::size_t size)
+        {
+            Device::instance().readMemory(address, data, size);
+        }
+    }
+}
+
+using msp430hal::host::Device;
+
+void __enable_interrupt()
+{
+    Device::instance().setStatusRegister(Device::instance().statusRegister() | GIE);
+}
+
+void __disable_interrupt()
+{
+    Device::instance().setStatusRegister(Device::instance().statusRegister() & ~GIE);
+}
+
+unsigned short __get_interrupt_state()
+{
+    return Device::instance().statusRegister() & GIE;
+}
+
+void __set_interrupt_state(unsigned short state)
+{
+    Device::instance().setStatusRegister((Device::instance().statusRegister() & ~GIE) | (state & GIE));
+}
+
+unsigned short __get_SR_register()
+{
+    return Device::instance().statusRegister();
+}
+
+void __bis_SR_register(unsigned short bits)
+{
+    Device::instance().setStatusRegister(Device::instance().statusRegister() | bits);
+}
+
+void __bic_SR_register(unsigned short bits)
+{
+    Device::instance().setStatusRegister(Device::instance().statusRegister() & ~bits);
+}
+
+void __bis_SR_register_on_exit(unsigned short bits)
+{
+    Device::instance().modifyStatusRegisterOnExit(bits, 0);
+}
+
+void __bic_SR_register_on_exit(unsigned short bits)
+{
+    Device::instance().modifyStatusRegisterOnExit(0, bits);
+}
+
+void __no_operation()
+{
+    Device::instance().execute(1);
+}
+
+void __delay_cycles(unsigned long cycles)
+{
+    Device::instance().execute(cycles);
+}
@@ -0,0 +1,17 @@
+#ifndef MSP430HAL_HOST_DEVICE_REGISTERS_H
+#define MSP430HAL_HOST_DEVICE_REGISTERS_H
+
+#include <vector>
+
+#include "msp430hal/host/register.h"
+
+namespace msp430hal
+{
+    namespace host
+    {
+        /// \brief All registers of the simulated device.
+        const std::vector<RegisterBase*>& deviceRegisters();
+    }
+}
+
+#endif //MSP430HAL_HOST_DEVICE_REGISTERS_H
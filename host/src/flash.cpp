@@ -0,0 +1,162 @@
+#include "msp430hal/host/flash.h"
+
+#include <algorithm>
+
+#include <msp430.h>
+
+#include "msp430hal/host/clock.h"
+#include "msp430hal/host/device.h"
+
+namespace msp430hal
+{
+    namespace host
+    {
+        namespace
+        {
+            // Program/erase times in cycles of the flash timing generator (datasheet tWord, tErase, tMassErase)
+            constexpr std::uint32_t word_program_cycles = 30;
+            constexpr std::uint32_t segment_erase_cycles = 4819;
+            constexpr std::uint32_t mass_erase_cycles = 10593;
+
+            constexpr std::uint16_t segment_a_start = 0x10c0;
+        }
+
+        FlashController::FlashController(Device& device, const ClockSystem& clocks)
+            : m_device(device), m_clocks(clocks)
+        {
+            restoreFactoryState();
+        }
+
+        void FlashController::restoreFactoryState()
+        {
+            m_memory.fill(0xff);
+            m_program_count = 0;
+            m_erase_count = 0;
+            const std::uint8_t calibration[] = {0x95, 0x8f, 0x7e, 0x8e, 0x86, 0x8d, 0xc5, 0x86};
+            std::copy(std::begin(calibration), std::end(calibration), m_memory.begin() + (0x10f8 - info_start));
+        }
+
+        void FlashController::reset()
+        {}
+
+        bool FlashController::isFlash(std::uint32_t address)
+        {
+            return (address >= info_start && address < info_end) || (address >= main_start && address < main_end);
+        }
+
+        std::uint8_t FlashController::read(std::uint16_t address) const
+        {
+            return m_memory[address - info_start];
+        }
+
+        void FlashController::beforeRead(RegisterBase& reg)
+        {
+            if (isFlash(reg.address()))
+                reg.poke(read(reg.address()));
+        }
+
+        std::uint16_t FlashController::write(RegisterBase& reg, std::uint16_t value)
+        {
+            if (isFlash(reg.address()))
+            {
+                auto byte = static_cast<std::uint8_t>(value);
+                program(reg.address(), &byte, 1);
+                return read(reg.address());
+            }
+
+            if ((value & 0xff00) != FWKEY)
+            {
+                FCTL3.poke(FCTL3.peek() | KEYV);
+                m_device.reset("flash controller password violation");
+            }
+            std::uint16_t old_value = reg.peek();
+            value = FRKEY | (value & 0x00ff);
+            if (&reg == &FCTL3)
+            {
+                // BUSY and WAIT are read only, writing 1 to LOCKA toggles it
+                std::uint16_t locka = (old_value ^ value) & LOCKA;
+                value = (value & ~(BUSY | WAIT | LOCKA)) | (old_value & (BUSY | WAIT)) | locka;
+            }
+            return value;
+        }
+
+        std::uint32_t FlashController::timingGeneratorFrequency() const
+        {
+            std::uint16_t fctl2 = FCTL2.peek();
+            std::uint32_t hz;
+            switch (fctl2 & 0x00c0)
+            {
+                case FSSEL_0:
+                    hz = m_clocks.aclk();
+                    break;
+                case FSSEL_1:
+                    hz = m_clocks.mclk();
+                    break;
+                default:
+                    hz = m_clocks.smclk();
+                    break;
+            }
+            return hz / ((fctl2 & 0x003f) + 1);
+        }
+
+        void FlashController::stall(std::uint32_t timing_generator_cycles)
+        {
+            m_device.stall(cyclesToTime(timing_generator_cycles, timingGeneratorFrequency()));
+        }
+
+        void FlashController::eraseSegment(std::uint16_t address)
+        {
+            std::uint16_t size = (address >= main_start) ? main_segment_size : info_segment_size;
+            std::uint16_t start = address & ~(size - 1);
+            if (start == segment_a_start && (FCTL3.peek() & LOCKA))
+                return;
+            std::fill_n(m_memory.begin() + (start - info_start), size, 0xff);
+        }
+
+        void FlashController::program(std::uint16_t address, const std::uint8_t* data, std::size_t size)
+        {
+            std::uint16_t fctl1 = FCTL1.peek();
+            std::uint16_t fctl3 = FCTL3.peek();
+
+            if ((fctl3 & LOCK) || !(fctl1 & (WRT | ERASE | MERAS)))
+            {
+                FCTL3.poke(fctl3 | ACCVIFG);
+                return;
+            }
+
+            if (fctl1 & (ERASE | MERAS))
+            {
+                if (fctl1 & MERAS)
+                {
+                    for (std::uint32_t segment = main_start; segment < main_end; segment += main_segment_size)
+                        eraseSegment(segment);
+                    if (fctl1 & ERASE)
+                    {
+                        for (std::uint16_t segment = info_start; segment < info_end; segment += info_segment_size)
+                            eraseSegment(segment);
+                    }
+                    stall(mass_erase_cycles);
+                }
+                else
+                {
+                    eraseSegment(address);
+                    stall(segment_erase_cycles);
+                }
+                FCTL1.poke(fctl1 & ~(ERASE | MERAS));
+                ++m_erase_count;
+                return;
+            }
+
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                std::uint16_t location = address + i;
+                if (!isFlash(location) || (location >= segment_a_start && location < info_end && (fctl3 & LOCKA)))
+                    continue;
+                // Programming can only clear bits
+                m_memory[location - info_start] &= data[i];
+            }
+            stall(word_program_cycles * static_cast<std::uint32_t>((size + 1) / 2));
+            ++m_program_count;
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#include "msp430hal/host/gpio.h"
+
+namespace msp430hal
+{
+    namespace host
+    {
+        GpioPort::GpioPort(GpioPortRegisters registers, unsigned vector)
+            : m_registers(registers), m_vector(vector)
+        {}
+
+        void GpioPort::reset()
+        {
+            m_level = m_driven & m_driven_level;
+            m_registers.in.poke(m_level);
+        }
+
+        void GpioPort::beforeRead(RegisterBase& reg)
+        {
+            if (&reg == &m_registers.in)
+                m_registers.in.poke(m_level);
+        }
+
+        void GpioPort::afterWrite(RegisterBase&)
+        {
+            update();
+        }
+
+        bool GpioPort::interruptPending(unsigned vector) const
+        {
+            return m_registers.ifg && vector == m_vector && (m_registers.ifg->peek() & m_registers.ie->peek());
+        }
+
+        void GpioPort::drive(std::uint8_t pins, bool high)
+        {
+            m_driven |= pins;
+            if (high)
+                m_driven_level |= pins;
+            else
+                m_driven_level &= ~pins;
+            update();
+        }
+
+        void GpioPort::release(std::uint8_t pins)
+        {
+            m_driven &= ~pins;
+            update();
+        }
+
+        std::uint8_t GpioPort::outputs() const
+        {
+            return m_registers.dir.peek() & ~(m_registers.sel.peek() | m_registers.sel2.peek());
+        }
+
+        void GpioPort::update()
+        {
+            std::uint8_t out = m_registers.out.peek();
+            std::uint8_t outputs = this->outputs();
+            std::uint8_t pulled = m_registers.ren.peek() & ~outputs & ~m_driven;
+
+            std::uint8_t level = m_level;
+            level = (level & ~m_driven) | (m_driven_level & m_driven);
+            level = (level & ~pulled) | (out & pulled);
+            level = (level & ~outputs) | (out & outputs);
+
+            if (m_registers.ifg)
+            {
+                std::uint8_t ies = m_registers.ies->peek();
+                std::uint8_t rising = level & ~m_level;
+                std::uint8_t falling = ~level & m_level;
+                std::uint8_t edges = (rising & ~ies) | (falling & ies);
+                m_registers.ifg->poke(m_registers.ifg->peek() | edges);
+            }
+            m_level = level;
+        }
+    }
+}
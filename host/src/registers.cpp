@@ -0,0 +1,145 @@
+#include <msp430.h>
+
+#include "device_registers.h"
+
+using msp430hal::host::Register;
+
+// Special function registers
+Register<std::uint8_t> IE1{0x0000};
+Register<std::uint8_t> IFG1{0x0002};
+Register<std::uint8_t> IE2{0x0001};
+Register<std::uint8_t> IFG2{0x0003, UCA0TXIFG | UCB0TXIFG};
+
+// Basic clock module+
+Register<std::uint8_t> DCOCTL{0x0056, 0x60};
+Register<std::uint8_t> BCSCTL1{0x0057, 0x87};
+Register<std::uint8_t> BCSCTL2{0x0058};
+Register<std::uint8_t> BCSCTL3{0x0053, 0x05};
+
+// Comparator_A+
+Register<std::uint8_t> CACTL1{0x0059};
+Register<std::uint8_t> CACTL2{0x005a};
+Register<std::uint8_t> CAPD{0x005b};
+
+// Flash controller
+Register<std::uint16_t> FCTL1{0x0128, 0x9600};
+Register<std::uint16_t> FCTL2{0x012a, 0x9642};
+Register<std::uint16_t> FCTL3{0x012c, 0x9658};
+
+// Port 1
+Register<std::uint8_t> P1IN{0x0020};
+Register<std::uint8_t> P1OUT{0x0021};
+Register<std::uint8_t> P1DIR{0x0022};
+Register<std::uint8_t> P1IFG{0x0023};
+Register<std::uint8_t> P1IES{0x0024};
+Register<std::uint8_t> P1IE{0x0025};
+Register<std::uint8_t> P1SEL{0x0026};
+Register<std::uint8_t> P1SEL2{0x0041};
+Register<std::uint8_t> P1REN{0x0027};
+
+// Port 2
+Register<std::uint8_t> P2IN{0x0028};
+Register<std::uint8_t> P2OUT{0x0029};
+Register<std::uint8_t> P2DIR{0x002a};
+Register<std::uint8_t> P2IFG{0x002b};
+Register<std::uint8_t> P2IES{0x002c};
+Register<std::uint8_t> P2IE{0x002d};
+Register<std::uint8_t> P2SEL{0x002e, 0xc0};
+Register<std::uint8_t> P2SEL2{0x0042};
+Register<std::uint8_t> P2REN{0x002f};
+
+// Port 3
+Register<std::uint8_t> P3IN{0x0018};
+Register<std::uint8_t> P3OUT{0x0019};
+Register<std::uint8_t> P3DIR{0x001a};
+Register<std::uint8_t> P3SEL{0x001b};
+Register<std::uint8_t> P3SEL2{0x0043};
+Register<std::uint8_t> P3REN{0x0010};
+
+// Timer0_A3
+Register<std::uint16_t> TA0IV{0x012e};
+Register<std::uint16_t> TA0CTL{0x0160};
+Register<std::uint16_t> TA0CCTL0{0x0162};
+Register<std::uint16_t> TA0CCTL1{0x0164};
+Register<std::uint16_t> TA0CCTL2{0x0166};
+Register<std::uint16_t> TA0R{0x0170};
+Register<std::uint16_t> TA0CCR0{0x0172};
+Register<std::uint16_t> TA0CCR1{0x0174};
+Register<std::uint16_t> TA0CCR2{0x0176};
+
+// Timer1_A3
+Register<std::uint16_t> TA1IV{0x011e};
+Register<std::uint16_t> TA1CTL{0x0180};
+Register<std::uint16_t> TA1CCTL0{0x0182};
+Register<std::uint16_t> TA1CCTL1{0x0184};
+Register<std::uint16_t> TA1CCTL2{0x0186};
+Register<std::uint16_t> TA1R{0x0190};
+Register<std::uint16_t> TA1CCR0{0x0192};
+Register<std::uint16_t> TA1CCR1{0x0194};
+Register<std::uint16_t> TA1CCR2{0x0196};
+
+// USCI_A0
+Register<std::uint8_t> UCA0ABCTL{0x005d};
+Register<std::uint8_t> UCA0IRTCTL{0x005e};
+Register<std::uint8_t> UCA0IRRCTL{0x005f};
+Register<std::uint8_t> UCA0CTL0{0x0060};
+Register<std::uint8_t> UCA0CTL1{0x0061, UCSWRST};
+Register<std::uint8_t> UCA0BR0{0x0062};
+Register<std::uint8_t> UCA0BR1{0x0063};
+Register<std::uint8_t> UCA0MCTL{0x0064};
+Register<std::uint8_t> UCA0STAT{0x0065};
+Register<std::uint8_t> UCA0RXBUF{0x0066};
+Register<std::uint8_t> UCA0TXBUF{0x0067};
+
+// USCI_B0
+Register<std::uint8_t> UCB0CTL0{0x0068, UCSYNC};
+Register<std::uint8_t> UCB0CTL1{0x0069, UCSWRST};
+Register<std::uint8_t> UCB0BR0{0x006a};
+Register<std::uint8_t> UCB0BR1{0x006b};
+Register<std::uint8_t> UCB0I2CIE{0x006c};
+Register<std::uint8_t> UCB0STAT{0x006d};
+Register<std::uint8_t> UCB0RXBUF{0x006e};
+Register<std::uint8_t> UCB0TXBUF{0x006f};
+Register<std::uint16_t> UCB0I2COA{0x0118};
+Register<std::uint16_t> UCB0I2CSA{0x011a};
+
+// Watchdog timer+
+Register<std::uint16_t> WDTCTL{0x0120, 0x6900};
+
+// Calibration data in information memory segment A
+Register<std::uint8_t> CALDCO_16MHZ{0x10f8};
+Register<std::uint8_t> CALBC1_16MHZ{0x10f9};
+Register<std::uint8_t> CALDCO_12MHZ{0x10fa};
+Register<std::uint8_t> CALBC1_12MHZ{0x10fb};
+Register<std::uint8_t> CALDCO_8MHZ{0x10fc};
+Register<std::uint8_t> CALBC1_8MHZ{0x10fd};
+Register<std::uint8_t> CALDCO_1MHZ{0x10fe};
+Register<std::uint8_t> CALBC1_1MHZ{0x10ff};
+
+namespace msp430hal
+{
+    namespace host
+    {
+        const std::vector<RegisterBase*>& deviceRegisters()
+        {
+            static const std::vector<RegisterBase*> registers = {
+                    &IE1, &IFG1, &IE2, &IFG2, &DCOCTL, &BCSCTL1,
+                    &BCSCTL2, &BCSCTL3, &CACTL1, &CACTL2, &CAPD, &FCTL1,
+                    &FCTL2, &FCTL3, &P1IN, &P1OUT, &P1DIR, &P1IFG,
+                    &P1IES, &P1IE, &P1SEL, &P1SEL2, &P1REN, &P2IN,
+                    &P2OUT, &P2DIR, &P2IFG, &P2IES, &P2IE, &P2SEL,
+                    &P2SEL2, &P2REN, &P3IN, &P3OUT, &P3DIR, &P3SEL,
+                    &P3SEL2, &P3REN, &TA0IV, &TA0CTL, &TA0CCTL0, &TA0CCTL1,
+                    &TA0CCTL2, &TA0R, &TA0CCR0, &TA0CCR1, &TA0CCR2, &TA1IV,
+                    &TA1CTL, &TA1CCTL0, &TA1CCTL1, &TA1CCTL2, &TA1R, &TA1CCR0,
+                    &TA1CCR1, &TA1CCR2, &UCA0ABCTL, &UCA0IRTCTL, &UCA0IRRCTL, &UCA0CTL0,
+                    &UCA0CTL1, &UCA0BR0, &UCA0BR1, &UCA0MCTL, &UCA0STAT, &UCA0RXBUF,
+                    &UCA0TXBUF, &UCB0CTL0, &UCB0CTL1, &UCB0BR0, &UCB0BR1, &UCB0I2CIE,
+                    &UCB0STAT, &UCB0RXBUF, &UCB0TXBUF, &UCB0I2COA, &UCB0I2CSA, &WDTCTL,
+                    &CALDCO_16MHZ, &CALBC1_16MHZ, &CALDCO_12MHZ, &CALBC1_12MHZ, &CALDCO_8MHZ, &CALBC1_8MHZ,
+                    &CALDCO_1MHZ, &CALBC1_1MHZ
+            };
+            return registers;
+        }
+    }
+}
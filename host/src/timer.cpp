@@ -0,0 +1,307 @@
+#include "msp430hal/host/timer.h"
+
+#include <msp430.h>
+
+#include "msp430hal/host/clock.h"
+
+namespace msp430hal
+{
+    namespace host
+    {
+        TimerA::TimerA(TimerARegisters registers, const ClockSystem& clocks, unsigned vector_ccr0, unsigned vector_other)
+            : m_registers(registers), m_clocks(clocks), m_vector_ccr0(vector_ccr0), m_vector_other(vector_other)
+        {}
+
+        void TimerA::reset()
+        {
+            m_edges.clear();
+            m_counting_down = false;
+            for (std::uint8_t unit = 0; unit < units; ++unit)
+            {
+                m_output[unit] = false;
+                m_capture_unread[unit] = false;
+                m_cci[unit] = captureInput(unit);
+            }
+        }
+
+        std::uint32_t TimerA::tickFrequency() const
+        {
+            std::uint16_t ctl = m_registers.ctl.peek();
+            std::uint32_t hz;
+            switch (ctl & 0x0300)
+            {
+                case TASSEL_0:
+                    hz = m_clocks.oscillators().taclk_hz;
+                    break;
+                case TASSEL_1:
+                    hz = m_clocks.aclk();
+                    break;
+                case TASSEL_2:
+                    hz = m_clocks.smclk();
+                    break;
+                default:
+                    // INCLK is the inverted TACLK
+                    hz = m_clocks.oscillators().taclk_hz;
+                    break;
+            }
+            return hz >> ((ctl & 0x00c0) >> 6);
+        }
+
+        bool TimerA::captureInput(std::uint8_t unit) const
+        {
+            switch (m_registers.cctl[unit]->peek() & 0x3000)
+            {
+                case CCIS_0:
+                    return m_input[unit][0];
+                case CCIS_1:
+                    return m_input[unit][1];
+                case CCIS_2:
+                    return false;
+                default:
+                    return true;
+            }
+        }
+
+        std::uint16_t TimerA::pendingVector() const
+        {
+            for (std::uint8_t unit = 1; unit < units; ++unit)
+            {
+                std::uint16_t cctl = m_registers.cctl[unit]->peek();
+                if ((cctl & CCIFG) && (cctl & CCIE))
+                    return unit * 2;
+            }
+            std::uint16_t ctl = m_registers.ctl.peek();
+            if ((ctl & TAIFG) && (ctl & TAIE))
+                return 0x0a;
+            return 0;
+        }
+
+        void TimerA::beforeRead(RegisterBase& reg)
+        {
+            if (&reg == &m_registers.iv)
+                m_registers.iv.poke(pendingVector());
+        }
+
+        void TimerA::afterRead(RegisterBase& reg)
+        {
+            if (&reg == &m_registers.iv)
+            {
+                // Reading TAIV resets the flag of the highest pending interrupt
+                std::uint16_t iv = m_registers.iv.peek();
+                if (iv == 0x0a)
+                    m_registers.ctl.poke(m_registers.ctl.peek() & ~TAIFG);
+                else if (iv != 0)
+                    m_registers.cctl[iv / 2]->poke(m_registers.cctl[iv / 2]->peek() & ~CCIFG);
+                return;
+            }
+            for (std::uint8_t unit = 0; unit < units; ++unit)
+            {
+                if (&reg == m_registers.ccr[unit])
+                    m_capture_unread[unit] = false;
+            }
+        }
+
+        std::uint16_t TimerA::write(RegisterBase& reg, std::uint16_t value)
+        {
+            if (&reg == &m_registers.ctl && (value & TACLR))
+            {
+                m_registers.counter.poke(0);
+                m_edges.clear();
+                m_counting_down = false;
+                return value & ~TACLR;
+            }
+            if (&reg == &m_registers.iv)
+                return reg.peek();
+            for (std::uint8_t unit = 0; unit < units; ++unit)
+            {
+                if (&reg == m_registers.cctl[unit])
+                {
+                    // CCI and SCCI are read only
+                    return (value & ~(CCI | SCCI)) | (reg.peek() & (CCI | SCCI));
+                }
+            }
+            return value;
+        }
+
+        void TimerA::afterWrite(RegisterBase& reg)
+        {
+            for (std::uint8_t unit = 0; unit < units; ++unit)
+            {
+                if (&reg == m_registers.cctl[unit])
+                {
+                    std::uint16_t cctl = m_registers.cctl[unit]->peek();
+                    if ((cctl & 0x00e0) == OUTMOD_0)
+                        m_output[unit] = cctl & OUT;
+                    updateCaptureInput(unit);
+                }
+            }
+        }
+
+        void TimerA::advance(Time from, Time to)
+        {
+            if ((m_registers.ctl.peek() & 0x0030) == MC_0)
+                return;
+            std::uint64_t ticks = m_edges.count(to - from, tickFrequency());
+            while (ticks-- > 0)
+                tick();
+        }
+
+        void TimerA::tick()
+        {
+            std::uint16_t ctl = m_registers.ctl.peek();
+            std::uint16_t counter = m_registers.counter.peek();
+            std::uint16_t ccr0 = m_registers.ccr[0]->peek();
+            bool overflow = false;
+
+            switch (ctl & 0x0030)
+            {
+                case MC_1:
+                    if (ccr0 == 0)
+                        return;
+                    if (counter >= ccr0)
+                    {
+                        counter = 0;
+                        overflow = true;
+                    }
+                    else
+                        ++counter;
+                    break;
+                case MC_2:
+                    ++counter;
+                    overflow = counter == 0;
+                    break;
+                case MC_3:
+                    if (ccr0 == 0)
+                        return;
+                    if (m_counting_down)
+                    {
+                        --counter;
+                        if (counter == 0)
+                        {
+                            overflow = true;
+                            m_counting_down = false;
+                        }
+                    }
+                    else
+                    {
+                        ++counter;
+                        if (counter >= ccr0)
+                            m_counting_down = true;
+                    }
+                    break;
+                default:
+                    return;
+            }
+
+            m_registers.counter.poke(counter);
+            if (overflow)
+                m_registers.ctl.poke(m_registers.ctl.peek() | TAIFG);
+            for (std::uint8_t unit = 0; unit < units; ++unit)
+            {
+                std::uint16_t cctl = m_registers.cctl[unit]->peek();
+                if (!(cctl & CAP) && counter == m_registers.ccr[unit]->peek())
+                    equal(unit);
+            }
+        }
+
+        void TimerA::equal(std::uint8_t unit)
+        {
+            m_registers.cctl[unit]->poke(m_registers.cctl[unit]->peek() | CCIFG);
+
+            // Output unit: EQUx affects the own output, EQU0 the second action of all outputs
+            for (std::uint8_t output = 0; output < units; ++output)
+            {
+                std::uint16_t mode = m_registers.cctl[output]->peek() & 0x00e0;
+                if (output == unit)
+                {
+                    switch (mode)
+                    {
+                        case OUTMOD_1:
+                        case OUTMOD_3:
+                            m_output[output] = true;
+                            break;
+                        case OUTMOD_2:
+                        case OUTMOD_4:
+                        case OUTMOD_6:
+                            m_output[output] = !m_output[output];
+                            break;
+                        case OUTMOD_5:
+                        case OUTMOD_7:
+                            m_output[output] = false;
+                            break;
+                        default:
+                            break;
+                    }
+                }
+                else if (unit == 0)
+                {
+                    switch (mode)
+                    {
+                        case OUTMOD_2:
+                        case OUTMOD_3:
+                            m_output[output] = false;
+                            break;
+                        case OUTMOD_6:
+                        case OUTMOD_7:
+                            m_output[output] = true;
+                            break;
+                        default:
+                            break;
+                    }
+                }
+            }
+        }
+
+        void TimerA::setCaptureInput(std::uint8_t unit, bool ccixb, bool level)
+        {
+            m_input[unit][ccixb] = level;
+            updateCaptureInput(unit);
+        }
+
+        void TimerA::updateCaptureInput(std::uint8_t unit)
+        {
+            bool level = captureInput(unit);
+            bool previous = m_cci[unit];
+            m_cci[unit] = level;
+
+            Register<std::uint16_t>& cctl = *m_registers.cctl[unit];
+            std::uint16_t value = cctl.peek();
+            value = level ? (value | CCI) : (value & ~CCI);
+            cctl.poke(value);
+
+            if (!(value & CAP) || level == previous)
+                return;
+            std::uint16_t mode = value & 0xc000;
+            bool capture = (mode == CM_3) || (mode == CM_1 && level) || (mode == CM_2 && !level);
+            if (!capture)
+                return;
+
+            if (m_capture_unread[unit])
+                value |= COV;
+            m_registers.ccr[unit]->poke(m_registers.counter.peek());
+            value |= CCIFG;
+            value = level ? (value | SCCI) : (value & ~SCCI);
+            cctl.poke(value);
+            m_capture_unread[unit] = true;
+        }
+
+        bool TimerA::interruptPending(unsigned vector) const
+        {
+            if (vector == m_vector_ccr0)
+            {
+                std::uint16_t cctl = m_registers.cctl[0]->peek();
+                return (cctl & CCIFG) && (cctl & CCIE);
+            }
+            if (vector == m_vector_other)
+                return pendingVector() != 0;
+            return false;
+        }
+
+        void TimerA::acknowledgeInterrupt(unsigned vector)
+        {
+            // TACCR0 CCIFG is a single source flag and gets reset automatically
+            if (vector == m_vector_ccr0)
+                m_registers.cctl[0]->poke(m_registers.cctl[0]->peek() & ~CCIFG);
+        }
+    }
+}
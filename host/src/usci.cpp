@@ -0,0 +1,1037 @@
+#include "msp430hal/host/usci.h"
+
+#include <algorithm>
+
+#include <msp430.h>
+
+#include "msp430hal/host/clock.h"
+#include "msp430hal/host/device.h"
+
+namespace msp430hal
+{
+    namespace host
+    {
+        namespace
+        {
+            Time now()
+            {
+                return Device::instance().now();
+            }
+
+            constexpr std::uint8_t uart_receive_errors = UCFE | UCOE | UCPE | UCBRK | UCRXERR | UCADDR;
+            constexpr std::uint8_t i2c_read_only_status = UCSCLLOW | UCBBUSY;
+        }
+
+        Usci::Usci(UsciRegisters registers, const ClockSystem& clocks, unsigned rx_vector, unsigned tx_vector)
+            : m_registers(registers), m_clocks(clocks), m_rx_vector(rx_vector), m_tx_vector(tx_vector)
+        {}
+
+        void Usci::reset()
+        {
+            m_tx_pending = false;
+            m_shifting = false;
+            m_slave_loaded = false;
+            m_slave_events.clear();
+            m_slave_held = false;
+        }
+
+        std::uint32_t Usci::brclk() const
+        {
+            switch (m_registers.ctl1.peek() & 0xc0)
+            {
+                case UCSSEL_0:
+                    return m_clocks.oscillators().uclk_hz;
+                case UCSSEL_1:
+                    return m_clocks.aclk();
+                default:
+                    return m_clocks.smclk();
+            }
+        }
+
+        std::uint16_t Usci::prescaler() const
+        {
+            std::uint16_t prescaler = m_registers.br0.peek() | (m_registers.br1.peek() << 8);
+            return std::max<std::uint16_t>(prescaler, 1);
+        }
+
+        void Usci::setFlag(std::uint8_t flag)
+        {
+            m_registers.ifg.poke(m_registers.ifg.peek() | flag);
+        }
+
+        void Usci::clearFlag(std::uint8_t flag)
+        {
+            m_registers.ifg.poke(m_registers.ifg.peek() & ~flag);
+        }
+
+        void Usci::setStatus(std::uint8_t bits)
+        {
+            m_registers.stat.poke(m_registers.stat.peek() | bits);
+        }
+
+        void Usci::clearStatus(std::uint8_t bits)
+        {
+            m_registers.stat.poke(m_registers.stat.peek() & ~bits);
+        }
+
+        void Usci::afterRead(RegisterBase& reg)
+        {
+            // Reading RXBUF resets the receive interrupt flag and the receive errors
+            if (&reg == &m_registers.rx_buf)
+            {
+                clearFlag(m_registers.rx_flag);
+                clearStatus(uart_receive_errors);
+            }
+        }
+
+        std::uint16_t Usci::write(RegisterBase& reg, std::uint16_t value)
+        {
+            if (&reg == &m_registers.ctl1)
+            {
+                if (!(reg.peek() & UCSWRST) && (value & UCSWRST))
+                    enterReset();
+                return value;
+            }
+            if (&reg == &m_registers.stat)
+                return (value & ~UCBUSY) | (reg.peek() & UCBUSY);
+            if (&reg == &m_registers.rx_buf)
+                return reg.peek();
+            if (&reg == &m_registers.tx_buf && !inReset())
+            {
+                // Writing TXBUF resets the transmit interrupt flag until the character moved into the shift register
+                clearFlag(m_registers.tx_flag);
+                m_tx_pending = true;
+                m_tx_data = static_cast<std::uint8_t>(value);
+            }
+            return value;
+        }
+
+        void Usci::afterWrite(RegisterBase& reg)
+        {
+            if (&reg == &m_registers.tx_buf && m_tx_pending)
+                startTransfer(now());
+        }
+
+        void Usci::enterReset()
+        {
+            m_tx_pending = false;
+            m_shifting = false;
+            m_slave_loaded = false;
+            clearFlag(m_registers.rx_flag);
+            setFlag(m_registers.tx_flag);
+            m_registers.ie.poke(m_registers.ie.peek() & ~(m_registers.rx_flag | m_registers.tx_flag));
+            clearStatus(uart_receive_errors | UCBUSY);
+        }
+
+        void Usci::advance(Time, Time to)
+        {
+            for (;;)
+            {
+                Time event = nextEvent();
+                Time slave = (m_slave_events.empty() || m_slave_held) ? 0 : m_slave_events.front().time;
+                bool timed = event != 0 && event <= to;
+                bool external = slave != 0 && slave <= to;
+                bool shift = m_shifting && m_shift_done <= to && (!timed || m_shift_done <= event) &&
+                             (!external || m_shift_done <= slave);
+                if (shift)
+                    finishTransfer(m_shift_done);
+                else if (timed && (!external || event <= slave))
+                    process(event);
+                else if (external)
+                    processSlave();
+                else
+                    return;
+            }
+        }
+
+        void Usci::slaveTransfer(const std::uint8_t* data, std::size_t size, std::uint32_t bit_rate)
+        {
+            Time bit = cyclesToTime(1, bit_rate);
+            Time character = ((m_registers.ctl0.peek() & UC7BIT) ? 7 : 8) * bit;
+            Time time = m_slave_events.empty() ? now() : std::max(now(), m_slave_events.back().time);
+
+            time += bit;
+            m_slave_events.push_back({time, SlaveEvent::Kind::select});
+            time += bit;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                m_slave_events.push_back({time, SlaveEvent::Kind::start});
+                time += character;
+                m_slave_events.push_back({time, SlaveEvent::Kind::finish, data[i]});
+            }
+            m_slave_events.push_back({time + bit, SlaveEvent::Kind::release});
+        }
+
+        void Usci::processSlave()
+        {
+            SlaveEvent event = m_slave_events.front();
+            m_slave_events.pop_front();
+
+            bool selected = synchronous() && !(m_registers.ctl0.peek() & UCMST) && !inReset();
+            // STE is active high in 4-pin mode with UCMODE_1, otherwise active low
+            bool active_level = mode() == UCMODE_1;
+            switch (event.kind)
+            {
+                case SlaveEvent::Kind::select:
+                    Device::instance().port(1).drive(stePin(), active_level);
+                    break;
+                case SlaveEvent::Kind::release:
+                    Device::instance().port(1).drive(stePin(), !active_level);
+                    break;
+                case SlaveEvent::Kind::start:
+                    if (!selected)
+                    {
+                        m_shift_data = 0xff;
+                        break;
+                    }
+                    // TXBUF written too late for the previous character's end is still taken
+                    loadSlaveShift();
+                    m_shift_data = m_slave_loaded ? m_slave_shift : m_tx_data;
+                    m_slave_loaded = false;
+                    setStatus(UCBUSY);
+                    break;
+                case SlaveEvent::Kind::finish:
+                    m_slave_responses.push_back(m_shift_data);
+                    if (selected)
+                    {
+                        receiveCharacter(event.data);
+                        clearStatus(UCBUSY);
+                        loadSlaveShift();
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        void Usci::loadSlaveShift()
+        {
+            if (m_slave_loaded || !m_tx_pending)
+                return;
+            m_slave_shift = m_tx_data;
+            m_slave_loaded = true;
+            m_tx_pending = false;
+            setFlag(m_registers.tx_flag);
+        }
+
+        void Usci::holdSlave()
+        {
+            m_slave_held = true;
+            m_slave_held_since = m_slave_events.front().time;
+        }
+
+        void Usci::releaseSlave()
+        {
+            if (!m_slave_held)
+                return;
+            m_slave_held = false;
+            Time delay = now() > m_slave_held_since ? now() - m_slave_held_since : 0;
+            for (SlaveEvent& event : m_slave_events)
+                event.time += delay;
+        }
+
+        Time Usci::spiCharacterTime() const
+        {
+            std::uint8_t bits = (m_registers.ctl0.peek() & UC7BIT) ? 7 : 8;
+            return cyclesToTime(static_cast<std::uint64_t>(bits) * prescaler(), brclk());
+        }
+
+        void Usci::startTransfer(Time now)
+        {
+            // A slave only shifts with the clock of the master, but its idle shift register takes TXBUF right away
+            if (!(m_registers.ctl0.peek() & UCMST))
+            {
+                if (!(m_registers.stat.peek() & UCBUSY))
+                    loadSlaveShift();
+                return;
+            }
+            if (m_shifting || !m_tx_pending)
+                return;
+            m_shifting = true;
+            m_shift_data = m_tx_data;
+            m_tx_pending = false;
+            setFlag(m_registers.tx_flag);
+            setStatus(UCBUSY);
+            m_shift_done = now + spiCharacterTime();
+        }
+
+        void Usci::finishTransfer(Time now)
+        {
+            m_shifting = false;
+            m_transmitted.push_back(m_shift_data);
+            std::uint8_t miso = 0xff;
+            if (m_registers.stat.peek() & UCLISTEN)
+                miso = m_shift_data;
+            else if (m_spi_device)
+                miso = m_spi_device->exchange(m_shift_data);
+            receiveCharacter(miso);
+            startTransfer(now);
+            if (!m_shifting)
+                clearStatus(UCBUSY);
+        }
+
+        void Usci::receiveCharacter(std::uint8_t data)
+        {
+            if (flag(m_registers.rx_flag))
+                setStatus(UCOE);
+            m_registers.rx_buf.poke(data);
+            setFlag(m_registers.rx_flag);
+        }
+
+        bool Usci::interruptPending(unsigned vector) const
+        {
+            std::uint8_t pending = m_registers.ifg.peek() & m_registers.ie.peek();
+            if (vector == m_rx_vector)
+                return pending & m_registers.rx_flag;
+            if (vector == m_tx_vector)
+                return pending & m_registers.tx_flag;
+            return false;
+        }
+
+        UsciA::UsciA(UsciRegisters registers, Register<std::uint8_t>& ab_ctl, const ClockSystem& clocks,
+                     unsigned rx_vector, unsigned tx_vector)
+            : Usci(registers, clocks, rx_vector, tx_vector), m_ab_ctl(ab_ctl)
+        {}
+
+        void UsciA::reset()
+        {
+            Usci::reset();
+            m_rx_queue.clear();
+            m_break_detected = false;
+            m_sync_received = false;
+            m_last_receive = 0;
+        }
+
+        void UsciA::enterReset()
+        {
+            Usci::enterReset();
+            m_ab_ctl.poke(m_ab_ctl.peek() & ~(UCSTOE | UCBTOE));
+            m_break_detected = false;
+            m_sync_received = false;
+        }
+
+        std::uint8_t UsciA::frameBits() const
+        {
+            std::uint8_t ctl0 = m_registers.ctl0.peek();
+            return 1 + ((ctl0 & UC7BIT) ? 7 : 8) + ((ctl0 & UCPEN) ? 1 : 0) +
+                   (((ctl0 & 0x06) == UCMODE_2) ? 1 : 0) + ((ctl0 & UCSPB) ? 2 : 1);
+        }
+
+        bool UsciA::automaticBaudRate() const
+        {
+            return mode() == UCMODE_3 && (m_ab_ctl.peek() & UCABDEN);
+        }
+
+        Time UsciA::characterTime() const
+        {
+            std::uint8_t mctl = m_registers.mctl->peek();
+            std::uint64_t bits = frameBits();
+            // Bit length in eighths of BRCLK periods
+            std::uint64_t bit_length;
+            if (mctl & UCOS16)
+                bit_length = (16ull * prescaler() + ((mctl & 0xf0) >> 4)) * 8;
+            else
+                bit_length = 8ull * prescaler() + ((mctl & 0x0e) >> 1);
+            return cyclesToTime(bits * bit_length, brclk() * 8);
+        }
+
+        void UsciA::startTransfer(Time now)
+        {
+            if (synchronous())
+            {
+                Usci::startTransfer(now);
+                return;
+            }
+            if (m_shifting || !m_tx_pending)
+                return;
+
+            std::uint8_t ctl1 = m_registers.ctl1.peek();
+            m_shift_frame = UartFrame{m_tx_data};
+            m_shift_frame.address = ctl1 & UCTXADDR;
+            m_shift_frame.break_condition = ctl1 & UCTXBRK;
+            // UCTXADDR and UCTXBRK are reset automatically when the start bit is generated
+            m_registers.ctl1.poke(ctl1 & ~(UCTXADDR | UCTXBRK));
+
+            m_shifting = true;
+            m_shift_data = m_tx_data;
+            m_tx_pending = false;
+            setFlag(m_registers.tx_flag);
+            setStatus(UCBUSY);
+            m_shift_done = now + characterTime();
+            // In idle-line multiprocessor mode an address character is marked by an idle period of 11 bits before it
+            if (m_shift_frame.address && mode() == UCMODE_1)
+                m_shift_done += 11 * characterTime() / frameBits();
+        }
+
+        void UsciA::finishTransfer(Time now)
+        {
+            if (synchronous())
+            {
+                Usci::finishTransfer(now);
+                return;
+            }
+            m_shifting = false;
+            m_transmitted.push_back(m_shift_data);
+            m_frames.push_back(m_shift_frame);
+            if (m_registers.stat.peek() & UCLISTEN)
+                deliver(m_shift_frame);
+            startTransfer(now);
+            if (!m_shifting)
+                clearStatus(UCBUSY);
+        }
+
+        void UsciA::receive(const UartFrame& frame)
+        {
+            Time start = m_rx_queue.empty() ? now() : std::max(now(), m_rx_queue.back().arrival);
+            m_rx_queue.push_back({start + characterTime(), frame});
+        }
+
+        void UsciA::receive(std::uint8_t data)
+        {
+            receive(UartFrame{data});
+        }
+
+        void UsciA::receive(const std::uint8_t* data, std::size_t size)
+        {
+            for (std::size_t i = 0; i < size; ++i)
+                receive(data[i]);
+        }
+
+        void UsciA::receiveBreakSync(std::uint32_t baud_rate, unsigned break_bits, unsigned delimiter_bits)
+        {
+            Time start = m_rx_queue.empty() ? now() : std::max(now(), m_rx_queue.back().arrival);
+            UartFrame break_frame;
+            break_frame.break_condition = true;
+            Time break_end = start + cyclesToTime(break_bits + delimiter_bits, baud_rate);
+            m_rx_queue.push_back({break_end, break_frame, cyclesToTime(break_bits, baud_rate)});
+            // Start, eight data and stop bit of the synch character
+            m_rx_queue.push_back({break_end + cyclesToTime(10, baud_rate), UartFrame{0x55}, 0, baud_rate});
+        }
+
+        std::uint8_t UsciA::stePin() const
+        {
+            return BIT5;
+        }
+
+        Time UsciA::nextEvent() const
+        {
+            return m_rx_queue.empty() ? 0 : m_rx_queue.front().arrival;
+        }
+
+        void UsciA::process(Time now)
+        {
+            PendingFrame pending = m_rx_queue.front();
+            m_rx_queue.pop_front();
+            if (pending.sync_baud_rate != 0)
+                synchronize(pending.sync_baud_rate);
+            else if (pending.break_length != 0 && automaticBaudRate())
+                detectBreak(pending.break_length);
+            else
+            {
+                // The line was idle for at least ten bits before the start bit of the character
+                Time bit_time = characterTime() / frameBits();
+                bool idle_line = now >= m_last_receive + characterTime() + 10 * bit_time;
+                deliver(pending.frame, idle_line);
+            }
+            m_last_receive = now;
+        }
+
+        void UsciA::detectBreak(Time length)
+        {
+            if (inReset())
+                return;
+            // The break timeout error is set for breaks longer than 22 bit times
+            if (length > 22 * characterTime() / frameBits())
+                m_ab_ctl.poke(m_ab_ctl.peek() | UCBTOE);
+            m_break_detected = true;
+        }
+
+        void UsciA::synchronize(std::uint32_t baud_rate)
+        {
+            if (inReset() || synchronous())
+                return;
+            if (!automaticBaudRate() || !m_break_detected)
+            {
+                deliver(UartFrame{0x55});
+                return;
+            }
+            m_break_detected = false;
+
+            // The synch field spans eight bits from the falling edge of the start bit to the falling edge of bit 7
+            std::uint64_t eighths = (8ull * brclk() + baud_rate / 2) / baud_rate;
+            bool oversampling = m_registers.mctl->peek() & UCOS16;
+            std::uint64_t ucbr = oversampling ? eighths / 128 : eighths / 8;
+            if (ucbr == 0 || ucbr > 0xffff)
+            {
+                m_ab_ctl.poke(m_ab_ctl.peek() | UCSTOE);
+                return;
+            }
+            m_registers.br0.poke(static_cast<std::uint8_t>(ucbr));
+            m_registers.br1.poke(static_cast<std::uint8_t>(ucbr >> 8));
+            if (oversampling)
+                m_registers.mctl->poke(static_cast<std::uint8_t>((((eighths / 8) & 0x0f) << 4) | UCOS16));
+            else
+                m_registers.mctl->poke(static_cast<std::uint8_t>((eighths & 0x07) << 1));
+
+            // The character following the break/synch field is received even if UCDORM is set
+            m_sync_received = true;
+            setStatus(UCBRK | UCRXERR);
+            if (m_registers.ctl1.peek() & UCBRKIE)
+                receiveCharacter(0);
+        }
+
+        void UsciA::deliver(const UartFrame& frame, bool idle_line)
+        {
+            if (inReset() || synchronous())
+                return;
+
+            std::uint8_t ctl0 = m_registers.ctl0.peek();
+            std::uint8_t ctl1 = m_registers.ctl1.peek();
+            if (automaticBaudRate())
+            {
+                bool after_sync = m_sync_received;
+                m_sync_received = false;
+                // While dormant only the character after a break/synch field is received
+                if ((ctl1 & UCDORM) && !after_sync)
+                    return;
+            }
+            bool address = false;
+            if (mode() == UCMODE_1)
+                address = frame.address || idle_line;
+            else if (mode() == UCMODE_2)
+                address = frame.address;
+            // While dormant only address characters are received in the multiprocessor modes
+            if ((ctl1 & UCDORM) && (mode() == UCMODE_1 || mode() == UCMODE_2) && !address)
+                return;
+            std::uint8_t errors = 0;
+            if (frame.framing_error)
+                errors |= UCFE;
+            if (frame.parity_error && (ctl0 & UCPEN))
+                errors |= UCPE;
+            if (frame.break_condition)
+                errors |= UCBRK;
+            if (errors)
+                errors |= UCRXERR;
+            if (address)
+                errors |= UCADDR;
+            setStatus(errors);
+
+            bool store = true;
+            if ((errors & (UCFE | UCPE)) && !(ctl1 & UCRXEIE))
+                store = false;
+            if (frame.break_condition && !(ctl1 & UCBRKIE))
+                store = false;
+            if (store)
+                receiveCharacter(frame.break_condition ? 0 : frame.data);
+        }
+
+        UsciB::UsciB(UsciRegisters registers, Register<std::uint8_t>& i2c_ie, Register<std::uint16_t>& i2c_oa,
+                     Register<std::uint16_t>& i2c_sa, const ClockSystem& clocks, unsigned rx_vector, unsigned tx_vector)
+            : Usci(registers, clocks, rx_vector, tx_vector), m_i2c_ie(i2c_ie), m_i2c_oa(i2c_oa), m_i2c_sa(i2c_sa)
+        {}
+
+        void UsciB::reset()
+        {
+            Usci::reset();
+            m_i2c_state = I2CState::idle;
+            m_i2c_slave = nullptr;
+            m_i2c_addressed = false;
+            m_i2c_stretch_time = 0;
+            m_i2c_address_nacks = 0;
+            m_i2c_foreign_busy = false;
+        }
+
+        void UsciB::enterReset()
+        {
+            Usci::enterReset();
+            m_i2c_state = I2CState::idle;
+            m_i2c_slave = nullptr;
+            m_i2c_addressed = false;
+            // The bus detector still sees the other master
+            m_registers.stat.poke(m_i2c_foreign_busy ? UCBBUSY : 0);
+        }
+
+        void UsciB::loseArbitration()
+        {
+            if (!i2cMode() || inReset() || !(m_registers.ctl0.peek() & UCMST))
+                return;
+            m_i2c_slave = nullptr;
+            m_i2c_state = I2CState::idle;
+            m_tx_pending = false;
+            clearFlag(m_registers.tx_flag);
+            m_registers.ctl1.poke(m_registers.ctl1.peek() & ~(UCTXSTT | UCTXSTP));
+            m_registers.ctl0.poke(m_registers.ctl0.peek() & ~UCMST);
+            m_i2c_foreign_busy = true;
+            clearStatus(UCSCLLOW);
+            setStatus(UCALIFG | UCBBUSY);
+        }
+
+        void UsciB::releaseI2CBus()
+        {
+            if (!m_i2c_foreign_busy)
+                return;
+            m_i2c_foreign_busy = false;
+            clearStatus(UCBBUSY);
+        }
+
+        void UsciB::attachI2CDevice(std::uint16_t address, I2CDevice* device)
+        {
+            if (device)
+                m_i2c_devices[address] = device;
+            else
+                m_i2c_devices.erase(address);
+        }
+
+        void UsciB::i2cMasterTransfer(std::uint8_t address, const std::uint8_t* data, std::size_t size,
+                                      std::size_t read_size, std::uint32_t bit_rate)
+        {
+            Time scl = cyclesToTime(1, bit_rate);
+            Time time = m_slave_events.empty() ? now() : std::max(now(), m_slave_events.back().time);
+            auto address_byte = [address](bool read)
+            {
+                return static_cast<std::uint8_t>((address << 1) | (read ? 1 : 0));
+            };
+
+            if (size > 0 || read_size == 0)
+            {
+                time += scl;
+                m_slave_events.push_back({time, SlaveEvent::Kind::i2c_start});
+                // The address bits, the slave acknowledges with the ninth clock
+                time += 8 * scl;
+                m_slave_events.push_back({time, SlaveEvent::Kind::i2c_address, address_byte(false)});
+                time += scl;
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    time += 8 * scl;
+                    m_slave_events.push_back({time, SlaveEvent::Kind::i2c_write, data[i]});
+                    time += scl;
+                }
+            }
+            if (read_size > 0)
+            {
+                time += scl;
+                m_slave_events.push_back({time, SlaveEvent::Kind::i2c_start});
+                time += 8 * scl;
+                m_slave_events.push_back({time, SlaveEvent::Kind::i2c_address, address_byte(true)});
+                time += scl;
+                for (std::size_t i = 0; i < read_size; ++i)
+                {
+                    m_slave_events.push_back({time, SlaveEvent::Kind::i2c_read});
+                    time += 9 * scl;
+                }
+            }
+            m_slave_events.push_back({time + scl, SlaveEvent::Kind::i2c_stop});
+        }
+
+        bool UsciB::i2cOwnAddress(std::uint8_t address) const
+        {
+            std::uint16_t own_address = m_i2c_oa.peek();
+            if (address == 0 && (own_address & UCGCEN))
+                return true;
+            if (m_registers.ctl0.peek() & UCA10)
+                return false;
+            return (own_address & 0x7f) == address;
+        }
+
+        void UsciB::processSlave()
+        {
+            SlaveEvent event = m_slave_events.front();
+            bool slave = i2cMode() && !inReset() && !(m_registers.ctl0.peek() & UCMST);
+            switch (event.kind)
+            {
+                case SlaveEvent::Kind::i2c_start:
+                    if (slave)
+                    {
+                        setStatus(UCBBUSY);
+                        m_tx_pending = false;
+                    }
+                    m_i2c_addressed = false;
+                    break;
+                case SlaveEvent::Kind::i2c_address:
+                {
+                    std::uint8_t address = event.data >> 1;
+                    bool read = event.data & 0x01;
+                    if (!slave || !i2cOwnAddress(address))
+                    {
+                        // The master gives up and generates the stop condition
+                        ++m_i2c_address_nacks;
+                        m_slave_events.pop_front();
+                        while (!m_slave_events.empty() && m_slave_events.front().kind != SlaveEvent::Kind::i2c_stop)
+                            m_slave_events.pop_front();
+                        if (!m_slave_events.empty())
+                            m_slave_events.front().time = event.time + sclPeriod();
+                        return;
+                    }
+                    m_i2c_addressed = true;
+                    std::uint8_t ctl1 = m_registers.ctl1.peek();
+                    m_registers.ctl1.poke(read ? (ctl1 | UCTR) : (ctl1 & ~UCTR));
+                    setStatus(UCSTTIFG);
+                    if (read)
+                        setFlag(m_registers.tx_flag);
+                    break;
+                }
+                case SlaveEvent::Kind::i2c_write:
+                    if (!m_i2c_addressed)
+                        break;
+                    if (flag(m_registers.rx_flag))
+                    {
+                        // SCL is held low before the acknowledge until RXBUF was read
+                        holdSlave();
+                        setStatus(UCSCLLOW);
+                        return;
+                    }
+                    m_registers.rx_buf.poke(event.data);
+                    setFlag(m_registers.rx_flag);
+                    break;
+                case SlaveEvent::Kind::i2c_read:
+                    if (!m_i2c_addressed)
+                    {
+                        m_slave_responses.push_back(0xff);
+                        break;
+                    }
+                    if (!m_tx_pending)
+                    {
+                        // SCL is held low until the next byte was written into TXBUF
+                        holdSlave();
+                        setStatus(UCSCLLOW);
+                        return;
+                    }
+                    m_tx_pending = false;
+                    m_slave_responses.push_back(m_tx_data);
+                    setFlag(m_registers.tx_flag);
+                    break;
+                case SlaveEvent::Kind::i2c_stop:
+                    if (slave)
+                    {
+                        clearStatus(UCBBUSY);
+                        m_tx_pending = false;
+                        if (m_i2c_addressed)
+                            setStatus(UCSTPIFG);
+                    }
+                    m_i2c_addressed = false;
+                    break;
+                default:
+                    Usci::processSlave();
+                    return;
+            }
+            m_slave_events.pop_front();
+        }
+
+        Time UsciB::sclPeriod() const
+        {
+            return cyclesToTime(prescaler(), brclk());
+        }
+
+        void UsciB::afterRead(RegisterBase& reg)
+        {
+            if (!i2cMode())
+            {
+                Usci::afterRead(reg);
+                return;
+            }
+            if (&reg == &m_registers.rx_buf)
+            {
+                clearFlag(m_registers.rx_flag);
+                // The master stretched SCL until the last character was read
+                if (m_i2c_state == I2CState::wait_receive)
+                    i2cDeliver(now());
+                else if (m_slave_held)
+                    i2cRelease();
+            }
+        }
+
+        std::uint16_t UsciB::write(RegisterBase& reg, std::uint16_t value)
+        {
+            if (!i2cMode() || inReset())
+                return Usci::write(reg, value);
+
+            if (&reg == &m_registers.stat)
+                return (value & ~i2c_read_only_status) | (reg.peek() & i2c_read_only_status);
+            if (&reg == &m_registers.tx_buf)
+            {
+                clearFlag(m_registers.tx_flag);
+                m_tx_pending = true;
+                m_tx_data = static_cast<std::uint8_t>(value);
+                return value;
+            }
+            if (&reg == &m_registers.ctl1)
+            {
+                std::uint8_t old_value = reg.peek();
+                if (!(old_value & UCSWRST) && (value & UCSWRST))
+                    enterReset();
+                // UCTXSTT and UCTXSTP can only be set by software, they are reset by the hardware
+                value |= old_value & (UCTXSTT | UCTXSTP);
+                return value;
+            }
+            return Usci::write(reg, value);
+        }
+
+        void UsciB::afterWrite(RegisterBase& reg)
+        {
+            if (!i2cMode() || inReset())
+            {
+                Usci::afterWrite(reg);
+                return;
+            }
+            if (&reg == &m_registers.tx_buf)
+            {
+                if (m_slave_held)
+                    i2cRelease();
+                startTransfer(now());
+                return;
+            }
+            if (&reg != &m_registers.ctl1)
+                return;
+
+            std::uint8_t ctl1 = m_registers.ctl1.peek();
+            switch (m_i2c_state)
+            {
+                case I2CState::idle:
+                    if (ctl1 & UCTXSTT)
+                        i2cStart(now());
+                    else if (ctl1 & UCTXSTP)
+                        m_registers.ctl1.poke(ctl1 & ~UCTXSTP);
+                    break;
+                case I2CState::wait_transmit:
+                case I2CState::wait_nack:
+                    if (ctl1 & UCTXSTP)
+                        i2cStop(now());
+                    else if (ctl1 & UCTXSTT)
+                        i2cStart(now());
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        bool UsciB::interruptPending(unsigned vector) const
+        {
+            if (!i2cMode())
+                return Usci::interruptPending(vector);
+
+            // In I2C mode the data flags share the transmit vector, the state flags use the receive vector
+            if (vector == m_tx_vector)
+                return m_registers.ifg.peek() & m_registers.ie.peek() & (m_registers.rx_flag | m_registers.tx_flag);
+            if (vector == m_rx_vector)
+                return m_registers.stat.peek() & m_i2c_ie.peek() & (UCNACKIFG | UCSTPIFG | UCSTTIFG | UCALIFG);
+            return false;
+        }
+
+        void UsciB::startTransfer(Time now)
+        {
+            if (!i2cMode())
+            {
+                Usci::startTransfer(now);
+                return;
+            }
+            if (m_i2c_state == I2CState::wait_transmit && m_tx_pending)
+            {
+                m_shift_data = m_tx_data;
+                m_tx_pending = false;
+                setFlag(m_registers.tx_flag);
+                m_i2c_state = I2CState::transmit;
+                clearStatus(UCSCLLOW);
+                i2cSchedule(now, 9);
+            }
+        }
+
+        void UsciB::finishTransfer(Time now)
+        {
+            Usci::finishTransfer(now);
+        }
+
+        std::uint8_t UsciB::stePin() const
+        {
+            return BIT4;
+        }
+
+        Time UsciB::nextEvent() const
+        {
+            switch (m_i2c_state)
+            {
+                case I2CState::address:
+                case I2CState::transmit:
+                case I2CState::receive:
+                case I2CState::stop:
+                    return m_i2c_event;
+                default:
+                    return 0;
+            }
+        }
+
+        void UsciB::process(Time now)
+        {
+            switch (m_i2c_state)
+            {
+                case I2CState::address:
+                    i2cAddressDone(now);
+                    break;
+                case I2CState::transmit:
+                    i2cTransmitDone(now);
+                    break;
+                case I2CState::receive:
+                    i2cReceiveDone(now);
+                    break;
+                case I2CState::stop:
+                    m_registers.ctl1.poke(m_registers.ctl1.peek() & ~UCTXSTP);
+                    clearStatus(UCBBUSY | UCSCLLOW);
+                    if (m_i2c_slave)
+                        m_i2c_slave->stop();
+                    m_i2c_slave = nullptr;
+                    m_i2c_state = I2CState::idle;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        void UsciB::i2cSchedule(Time now, std::uint32_t scl_periods)
+        {
+            m_i2c_event = now + scl_periods * sclPeriod();
+            // The addressed slave stretches the clock
+            if (m_i2c_slave)
+                m_i2c_event += m_i2c_slave->holdScl();
+        }
+
+        void UsciB::i2cStart(Time now)
+        {
+            if (!(m_registers.ctl0.peek() & UCMST))
+                return;
+            if (m_i2c_slave && m_i2c_state != I2CState::idle)
+            {
+                // Repeated start: the previous slave sees the end of its transfer
+                m_i2c_slave = nullptr;
+            }
+            m_i2c_read = !(m_registers.ctl1.peek() & UCTR);
+            setStatus(UCBBUSY);
+            clearStatus(UCSCLLOW | UCNACKIFG);
+            // In transmitter mode TXIFG is set as soon as the start condition is generated
+            if (!m_i2c_read)
+                setFlag(m_registers.tx_flag);
+            m_i2c_state = I2CState::address;
+            // start condition, 7 address bits, R/W bit and acknowledge
+            i2cSchedule(now, 10);
+        }
+
+        void UsciB::i2cAddressDone(Time now)
+        {
+            auto device = m_i2c_devices.find(m_i2c_sa.peek() & 0x7f);
+            I2CDevice* slave = (device == m_i2c_devices.end()) ? nullptr : device->second;
+            bool ack = slave && slave->start(m_i2c_read);
+            m_registers.ctl1.poke(m_registers.ctl1.peek() & ~UCTXSTT);
+
+            if (!ack)
+            {
+                setStatus(UCNACKIFG);
+                clearFlag(m_registers.tx_flag);
+                m_tx_pending = false;
+                m_i2c_slave = nullptr;
+                if (m_registers.ctl1.peek() & UCTXSTP)
+                    i2cStop(now);
+                else
+                    m_i2c_state = I2CState::wait_nack;
+                return;
+            }
+
+            m_i2c_slave = slave;
+            if (m_i2c_read)
+            {
+                m_i2c_state = I2CState::receive;
+                i2cSchedule(now, 9);
+            }
+            else
+                i2cAfterAcknowledge(now);
+        }
+
+        void UsciB::i2cAfterAcknowledge(Time now)
+        {
+            std::uint8_t ctl1 = m_registers.ctl1.peek();
+            if (ctl1 & UCTXSTP)
+            {
+                // A stop condition is generated even if data is still waiting in TXBUF
+                m_tx_pending = false;
+                i2cStop(now);
+            }
+            else if (ctl1 & UCTXSTT)
+                i2cStart(now);
+            else if (m_tx_pending)
+            {
+                m_shift_data = m_tx_data;
+                m_tx_pending = false;
+                setFlag(m_registers.tx_flag);
+                m_i2c_state = I2CState::transmit;
+                i2cSchedule(now, 9);
+            }
+            else
+            {
+                m_i2c_state = I2CState::wait_transmit;
+                setStatus(UCSCLLOW);
+            }
+        }
+
+        void UsciB::i2cTransmitDone(Time now)
+        {
+            m_transmitted.push_back(m_shift_data);
+            bool ack = m_i2c_slave && m_i2c_slave->write(m_shift_data);
+            if (ack)
+            {
+                i2cAfterAcknowledge(now);
+                return;
+            }
+            setStatus(UCNACKIFG);
+            clearFlag(m_registers.tx_flag);
+            m_tx_pending = false;
+            if (m_registers.ctl1.peek() & UCTXSTP)
+                i2cStop(now);
+            else
+                m_i2c_state = I2CState::wait_nack;
+        }
+
+        void UsciB::i2cReceiveDone(Time now)
+        {
+            m_i2c_received = m_i2c_slave ? m_i2c_slave->read() : 0xff;
+            if (flag(m_registers.rx_flag))
+            {
+                // RXBUF was not read yet: the master holds SCL low before acknowledging
+                m_i2c_state = I2CState::wait_receive;
+                setStatus(UCSCLLOW);
+                return;
+            }
+            i2cDeliver(now);
+        }
+
+        void UsciB::i2cDeliver(Time now)
+        {
+            clearStatus(UCSCLLOW);
+            m_registers.rx_buf.poke(m_i2c_received);
+            setFlag(m_registers.rx_flag);
+
+            // The acknowledge of the character depends on a pending stop or repeated start
+            std::uint8_t ctl1 = m_registers.ctl1.peek();
+            if (ctl1 & UCTXSTP)
+                i2cStop(now);
+            else if (ctl1 & UCTXSTT)
+                i2cStart(now);
+            else
+            {
+                m_i2c_state = I2CState::receive;
+                i2cSchedule(now, 9);
+            }
+        }
+
+        void UsciB::i2cRelease()
+        {
+            clearStatus(UCSCLLOW);
+            Time held = now() > m_slave_held_since ? now() - m_slave_held_since : 0;
+            m_i2c_stretch_time += held;
+            releaseSlave();
+        }
+
+        void UsciB::i2cStop(Time now)
+        {
+            clearStatus(UCSCLLOW);
+            m_i2c_state = I2CState::stop;
+            i2cSchedule(now, 1);
+        }
+    }
+}
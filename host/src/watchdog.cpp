@@ -0,0 +1,71 @@
+#include "msp430hal/host/watchdog.h"
+
+#include <msp430.h>
+
+#include "msp430hal/host/clock.h"
+#include "msp430hal/host/device.h"
+
+namespace msp430hal
+{
+    namespace host
+    {
+        Watchdog::Watchdog(Device& device, const ClockSystem& clocks)
+            : m_device(device), m_clocks(clocks)
+        {}
+
+        void Watchdog::reset()
+        {
+            m_counter = 0;
+            m_edges.clear();
+        }
+
+        std::uint16_t Watchdog::write(RegisterBase&, std::uint16_t value)
+        {
+            if ((value & 0xff00) != WDTPW)
+                m_device.reset("watchdog password violation");
+            if (value & WDTCNTCL)
+            {
+                m_counter = 0;
+                m_edges.clear();
+            }
+            // Reads always return 0x69 in the upper byte, WDTCNTCL reads as 0
+            return 0x6900 | (value & 0x00ff & ~WDTCNTCL);
+        }
+
+        void Watchdog::advance(Time from, Time to)
+        {
+            std::uint16_t ctl = WDTCTL.peek();
+            if (ctl & WDTHOLD)
+                return;
+
+            std::uint32_t hz = (ctl & WDTSSEL) ? m_clocks.aclk() : m_clocks.smclk();
+            static constexpr std::uint16_t intervals[] = {32768, 8192, 512, 64};
+            std::uint32_t interval = intervals[ctl & 0x03];
+            std::uint64_t edges = m_edges.count(to - from, hz);
+            while (edges > 0)
+            {
+                std::uint64_t remaining = interval - m_counter;
+                if (edges < remaining)
+                {
+                    m_counter += edges;
+                    return;
+                }
+                edges -= remaining;
+                m_counter = 0;
+                if (!(ctl & WDTTMSEL))
+                    m_device.reset("watchdog timer expired");
+                IFG1.poke(IFG1.peek() | WDTIFG);
+            }
+        }
+
+        bool Watchdog::interruptPending(unsigned vector) const
+        {
+            return vector == WDT_VECTOR && (IFG1.peek() & WDTIFG) && (IE1.peek() & WDTIE);
+        }
+
+        void Watchdog::acknowledgeInterrupt(unsigned)
+        {
+            IFG1.poke(IFG1.peek() & ~WDTIFG);
+        }
+    }
+}
@@ -5,6 +5,7 @@
 #include <cstdint>
 #include "clock_module.h"
 #include "../timer/watchdog_timer.h"
+#include "../util/register.h"
 
 namespace msp430hal
 {
@@ -72,7 +73,7 @@ namespace msp430hal
             FCTL3 = flash_password;
 
             //Dummy write
-            *reinterpret_cast<std::uint16_t*>(segment_address) = 0;
+            storeAt<std::uint16_t>(segment_address, 0);
 
             bool error = FCTL3 & (ACCVIFG | FAIL);
             //Set Lock Bit
@@ -104,7 +105,7 @@ namespace msp430hal
             FCTL1 = flash_password | (FCTL1 & 0x0018) | WRT;
             FCTL3 = flash_password;
 
-            *reinterpret_cast<T*>(address) = data;
+            storeAt(address, data);
 
             bool error = FCTL3 & (ACCVIFG | FAIL);
             FCTL3 = flash_password | LOCK;
@@ -132,7 +133,7 @@ namespace msp430hal
             FCTL1 = flash_password | (FCTL1 & 0x0018) | WRT;
             FCTL3 = flash_password;
 
-            *reinterpret_cast<std::uint8_t*>(address) = byte;
+            storeAt(address, byte);
 
             bool error = FCTL3 & (ACCVIFG | FAIL);
             FCTL3 = flash_password | LOCK;
@@ -160,7 +161,7 @@ namespace msp430hal
             FCTL1 = flash_password | (FCTL1 & 0x0018) | WRT;
             FCTL3 = flash_password;
 
-            *reinterpret_cast<std::uint16_t*>(address) = word;
+            storeAt(address, word);
 
             bool error = FCTL3 & (ACCVIFG | FAIL);
             FCTL3 = flash_password | LOCK;
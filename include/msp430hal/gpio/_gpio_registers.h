@@ -3,6 +3,7 @@
 
 #include <msp430.h>
 #include <cstdint>
+#include "../util/register.h"
 
 namespace msp430hal
 {
@@ -43,7 +44,7 @@ namespace msp430hal
 
         namespace _gpio_registers
         {
-            static constexpr volatile std::uint8_t* gpio_registers[][9] = {
+            static constexpr register8_t* gpio_registers[][9] = {
                     {&P1IN, &P1OUT, &P1DIR, &P1IFG, &P1IES, &P1IE, &P1SEL, &P1SEL2, &P1REN},
 #ifdef __MSP430_HAS_PORT2_R__
                     {&P2IN, &P2OUT, &P2DIR, &P2IFG, &P2IES, &P2IE, &P2SEL, &P2SEL2, &P2REN},
@@ -56,7 +57,7 @@ namespace msp430hal
 #endif
             };
 
-            constexpr volatile std::uint8_t* getGPIORegister(int reg_no, Port port)
+            constexpr register8_t* getGPIORegister(int reg_no, Port port)
             {
                 return gpio_registers[port][reg_no];
             }
@@ -12,11 +12,11 @@ namespace msp430hal
 {
     namespace gpio
     {
-        namespace
-        {
-            struct GPIOPins_base
-            {};
-        }
+        /// \brief Common base of all GPIOPins, see is_GPIO_Pin.
+        ///
+        /// Not in an anonymous namespace, the GPIOPins used by the drivers in headers would get internal linkage.
+        struct GPIOPins_base
+        {};
 
         enum class Mode
         {
@@ -50,15 +50,15 @@ namespace msp430hal
         template<Port port, std::uint8_t pins, Mode mode = Mode::output, PinResistors resistor = PinResistors::internal_pullup>
         struct GPIOPins : GPIOPins_base
         {
-            static constexpr volatile std::uint8_t* in = _gpio_registers::getGPIORegister(0, port);
-            static constexpr volatile std::uint8_t* out = _gpio_registers::getGPIORegister(1, port);
-            static constexpr volatile std::uint8_t* dir = _gpio_registers::getGPIORegister(2, port);
-            static constexpr volatile std::uint8_t* ifg = _gpio_registers::getGPIORegister(3, port);
-            static constexpr volatile std::uint8_t* ies = _gpio_registers::getGPIORegister(4, port);
-            static constexpr volatile std::uint8_t* ie = _gpio_registers::getGPIORegister(5, port);
-            static constexpr volatile std::uint8_t* sel = _gpio_registers::getGPIORegister(6, port);
-            static constexpr volatile std::uint8_t* sel2 = _gpio_registers::getGPIORegister(7, port);
-            static constexpr volatile std::uint8_t* ren = _gpio_registers::getGPIORegister(8, port);
+            static constexpr register8_t* in = _gpio_registers::getGPIORegister(0, port);
+            static constexpr register8_t* out = _gpio_registers::getGPIORegister(1, port);
+            static constexpr register8_t* dir = _gpio_registers::getGPIORegister(2, port);
+            static constexpr register8_t* ifg = _gpio_registers::getGPIORegister(3, port);
+            static constexpr register8_t* ies = _gpio_registers::getGPIORegister(4, port);
+            static constexpr register8_t* ie = _gpio_registers::getGPIORegister(5, port);
+            static constexpr register8_t* sel = _gpio_registers::getGPIORegister(6, port);
+            static constexpr register8_t* sel2 = _gpio_registers::getGPIORegister(7, port);
+            static constexpr register8_t* ren = _gpio_registers::getGPIORegister(8, port);
 
             static const Port port_value = port;
             static const std::uint8_t pins_value = pins;
@@ -0,0 +1,143 @@
+#ifndef MSP430HAL_MEMORY_BLOCK_POOL_H
+#define MSP430HAL_MEMORY_BLOCK_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "../multitasking/interrupt_guard.h"
+
+namespace msp430hal
+{
+    namespace memory
+    {
+        /// \brief Allocator for fixed size blocks out of a statically sized pool.
+        ///
+        /// The free blocks form an intrusive singly linked list, the link is stored in the first bytes of each free block.
+        /// allocate() and deallocate() are O(1) and only disable interrupts for the few instructions needed to pop or
+        /// push the head of the list, so both can be used from ISRs and the main loop at the same time. A typical use is
+        /// handing a received frame from an ISR to the main loop by pointer instead of copying it.
+        ///
+        /// \tparam block_size The usable size of each block in bytes.
+        /// \tparam block_count The number of blocks in the pool.
+        template<std::size_t block_size, std::size_t block_count>
+        class block_pool
+        {
+            static_assert(block_size > 0, "The blocks of a pool must not be empty");
+            static_assert(block_count > 0 && block_count <= 0xffff, "The number of blocks must be between 1 and 65535");
+
+            struct free_block
+            {
+                free_block* next;
+            };
+
+        public:
+            using count_type = std::conditional_t<(block_count <= 0xff), std::uint8_t, std::uint16_t>;
+
+            static constexpr std::size_t block_size_value = block_size;
+            static constexpr std::size_t block_count_value = block_count;
+            /// \brief Distance between two blocks; large enough for the free list link and word aligned.
+            static constexpr std::size_t stride = ((block_size < sizeof(free_block) ? sizeof(free_block) : block_size) + alignof(free_block) - 1)
+                                                  & ~(alignof(free_block) - 1);
+
+            block_pool()
+            {
+                for (std::size_t i = 0; i < block_count; ++i)
+                    blockAt(i)->next = (i + 1 < block_count) ? blockAt(i + 1) : nullptr;
+                m_free = blockAt(0);
+            }
+
+            block_pool(const block_pool&) = delete;
+            block_pool& operator=(const block_pool&) = delete;
+
+            /// \brief Take a block out of the pool.
+            ///
+            /// \return Pointer to a word aligned block of block_size bytes or nullptr if all blocks are in use.
+            void* allocate()
+            {
+                multitasking::InterruptGuard guard;
+                free_block* block = m_free;
+                if (block == nullptr)
+                {
+                    if (m_failed_allocations != 0xffff)
+                        m_failed_allocations = m_failed_allocations + 1;
+                    return nullptr;
+                }
+                m_free = block->next;
+                count_type in_use = m_in_use + 1;
+                m_in_use = in_use;
+                if (in_use > m_high_water_mark)
+                    m_high_water_mark = in_use;
+                return block;
+            }
+
+            /// \brief Return a block to the pool.
+            ///
+            /// \param block A block obtained by allocate() of this pool or nullptr, which is ignored.
+            void deallocate(void* block)
+            {
+                if (block == nullptr)
+                    return;
+                auto* freed = static_cast<free_block*>(block);
+                multitasking::InterruptGuard guard;
+                freed->next = m_free;
+                m_free = freed;
+                m_in_use = m_in_use - 1;
+            }
+
+            /// \brief Does the pointer point into the memory of this pool?
+            bool owns(const void* pointer) const
+            {
+                auto address = reinterpret_cast<std::uintptr_t>(pointer);
+                auto start = reinterpret_cast<std::uintptr_t>(m_storage);
+                return address >= start && address < start + sizeof(m_storage);
+            }
+
+            /// \brief The number of blocks which are currently allocated.
+            count_type in_use() const
+            {
+                return m_in_use;
+            }
+
+            /// \brief The number of blocks which can still be allocated.
+            count_type available() const
+            {
+                return block_count - m_in_use;
+            }
+
+            /// \brief The maximum number of blocks which were allocated at the same time.
+            count_type high_water_mark() const
+            {
+                return m_high_water_mark;
+            }
+
+            /// \brief The number of calls to allocate() which failed because the pool was exhausted, saturates at 0xffff.
+            std::uint16_t failed_allocations() const
+            {
+                return m_failed_allocations;
+            }
+
+            /// \brief Reset the high water mark to the current number of allocated blocks and clear the failure counter.
+            void reset_statistics()
+            {
+                multitasking::InterruptGuard guard;
+                m_high_water_mark = m_in_use;
+                m_failed_allocations = 0;
+            }
+
+        private:
+            free_block* blockAt(std::size_t index)
+            {
+                return reinterpret_cast<free_block*>(m_storage + index * stride);
+            }
+
+            alignas(free_block) std::uint8_t m_storage[stride * block_count];
+            free_block* volatile m_free = nullptr;
+            volatile count_type m_in_use = 0;
+            volatile count_type m_high_water_mark = 0;
+            volatile std::uint16_t m_failed_allocations = 0;
+        };
+    }
+}
+
+#endif //MSP430HAL_MEMORY_BLOCK_POOL_H
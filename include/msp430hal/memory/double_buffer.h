@@ -0,0 +1,124 @@
+#ifndef MSP430HAL_MEMORY_DOUBLE_BUFFER_H
+#define MSP430HAL_MEMORY_DOUBLE_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace msp430hal
+{
+    namespace memory
+    {
+        /// \brief Ping-pong buffer for continuous sample streams.
+        ///
+        /// The producer (usually an ISR) fills one half with push(). As soon as the half is full, both halves are swapped
+        /// by flipping a single index and the full half is marked as ready. The consumer (usually the main loop) processes
+        /// the ready half as a whole block and hands it back with release(), so the CPU can sleep between blocks.
+        ///
+        /// Only the producer changes the fill state and only the consumer clears the ready flag, hence no interrupts have to
+        /// be disabled. If the producer fills a half while the other one was not released yet, it keeps the full half until
+        /// the release and drops the following samples, which are counted as overruns.
+        ///
+        /// \tparam T The sample type, must be trivially copyable.
+        /// \tparam block_size The number of samples in each half.
+        template<typename T, std::size_t block_size>
+        class double_buffer
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "The samples of a double buffer must be trivially copyable");
+            static_assert(block_size > 0 && block_size <= 0xffff, "The block size must be between 1 and 65535");
+
+        public:
+            using value_type = T;
+            using index_type = std::conditional_t<(block_size <= 0xff), std::uint8_t, std::uint16_t>;
+
+            static constexpr std::size_t block_size_value = block_size;
+
+            /// \brief Append a sample to the half which is currently filled. Must only be called by the producer.
+            ///
+            /// \param value The sample.
+            /// \return true if a block became ready with this call, e.g. to wake up the CPU on exit of the ISR.
+            bool push(const T& value)
+            {
+                bool block_ready = false;
+                index_type count = m_fill_count;
+                if (count == block_size)
+                {
+                    // The last full half waits for the release of the other half
+                    if (m_ready)
+                    {
+                        if (m_overruns != 0xffff)
+                            m_overruns = m_overruns + 1;
+                        return false;
+                    }
+                    swap();
+                    block_ready = true;
+                    count = 0;
+                }
+
+                m_buffer[m_fill_half][count] = value;
+                ++count;
+                m_fill_count = count;
+                if (count == block_size && !m_ready)
+                {
+                    swap();
+                    block_ready = true;
+                }
+                return block_ready;
+            }
+
+            /// \brief Is a full block waiting to be processed?
+            bool ready() const
+            {
+                return m_ready;
+            }
+
+            /// \brief The block which is ready to be processed. Must only be called by the consumer.
+            ///
+            /// \return Pointer to the block_size samples of the ready half or nullptr if no block is ready.
+            const T* ready_block() const
+            {
+                if (!m_ready)
+                    return nullptr;
+                std::atomic_signal_fence(std::memory_order_acquire);
+                return m_buffer[m_fill_half ^ 1];
+            }
+
+            /// \brief Hand the ready block back to the producer after it was processed. Must only be called by the consumer.
+            void release()
+            {
+                std::atomic_signal_fence(std::memory_order_release);
+                m_ready = false;
+            }
+
+            /// \brief The number of samples dropped because the consumer did not release a block in time, saturates at 0xffff.
+            std::uint16_t overruns() const
+            {
+                return m_overruns;
+            }
+
+            void clear_overruns()
+            {
+                m_overruns = 0;
+            }
+
+        private:
+            void swap()
+            {
+                m_fill_half = m_fill_half ^ 1;
+                m_fill_count = 0;
+                // The samples must be stored before the consumer can see the ready flag
+                std::atomic_signal_fence(std::memory_order_release);
+                m_ready = true;
+            }
+
+            alignas((sizeof(T) % 2 == 0 && alignof(T) < 2) ? 2 : alignof(T)) T m_buffer[2][block_size];
+            volatile std::uint8_t m_fill_half = 0;
+            volatile index_type m_fill_count = 0;
+            volatile bool m_ready = false;
+            volatile std::uint16_t m_overruns = 0;
+        };
+    }
+}
+
+#endif //MSP430HAL_MEMORY_DOUBLE_BUFFER_H
@@ -1,78 +1,443 @@
 #ifndef IR_TRAIN_DETECTOR_RING_ALLOCATOR_H
 #define IR_TRAIN_DETECTOR_RING_ALLOCATOR_H
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "../multitasking/interrupt_guard.h"
+#include "../util/math.h"
 
 namespace msp430hal
 {
     namespace memory
     {
+        /// \brief The smallest unsigned type that can hold free running indices of a ring buffer with the given capacity.
+        ///
+        /// The difference of both indices must be able to represent a completely filled buffer, hence 8 bit indices
+        /// are used up to a capacity of 128 elements.
         template<std::size_t capacity>
-        struct byte_ring_buffer
+        using ring_buffer_index_t = std::conditional_t<(capacity <= 0x80), std::uint8_t, std::uint16_t>;
+
+        /// \brief Specifies what a ring buffer does when new elements are inserted while it is full.
+        enum class OverflowPolicy
+        {
+            reject_new, ///< Keep the oldest elements, the new elements are dropped.
+            overwrite_oldest, ///< Keep the newest elements, the oldest unread elements are dropped.
+            block ///< Wait until the consumer made room. The wait callback is called while waiting.
+        };
+
+        /// \brief Lock free single producer, single consumer ring buffer.
+        ///
+        /// One side (usually an ISR) calls insert(), the other side (usually the main loop) calls get(). Both sides
+        /// only modify their own free running index, which is read and written with a single (atomic) access on the MSP430.
+        /// Therefore no interrupts have to be disabled. The capacity has to be a power of two, so wrapping the indices
+        /// is a single AND instead of a division.
+        ///
+        /// Elements with an even size are stored word aligned, hence 16 bit values are moved with word instructions.
+        ///
+        /// With OverflowPolicy::overwrite_oldest the producer advances the read index as well. Both sides update the
+        /// read index inside a short InterruptGuard section then, and the consumer retries a read if the producer
+        /// overwrote the elements it was copying. OverflowPolicy::block is meant for a producer in the main loop and
+        /// a consumer in an ISR (e.g. a transmit buffer); the producer must not wait with interrupts disabled.
+        ///
+        /// \tparam T The element type, must be trivially copyable.
+        /// \tparam capacity The number of elements the buffer can hold, must be a power of two.
+        /// \tparam overflow_policy What happens if elements are inserted while the buffer is full.
+        /// \tparam wait_callback Called repeatedly while the producer waits for free space with OverflowPolicy::block,
+        /// e.g. to enter a low power mode. nullptr for busy waiting.
+        template<typename T,
+                 std::size_t capacity,
+                 OverflowPolicy overflow_policy = OverflowPolicy::reject_new,
+                 void (*wait_callback)() = nullptr>
+        struct ring_buffer
         {
-            std::uint8_t m_buffer[capacity];
+            static_assert(std::is_trivially_copyable_v<T>, "The elements of a ring buffer must be trivially copyable");
+            static_assert(capacity > 0 && is_power_of_two(capacity), "The capacity of the ring buffer must be a power of two");
+            static_assert(capacity <= 0x8000, "The capacity of the ring buffer exceeds the 16 bit index range");
+
+            using value_type = T;
+            using index_type = ring_buffer_index_t<capacity>;
+
+            /// \brief A contiguous part of the buffer memory.
+            template<typename element_type>
+            struct segment
+            {
+                element_type* data;
+                index_type size;
+            };
+
+            /// \brief Up to two parts of the buffer memory, the second one is only used if the range wraps around the end.
+            template<typename element_type>
+            struct segment_pair
+            {
+                segment<element_type> first;
+                segment<element_type> second;
+            };
+
+            static constexpr std::size_t capacity_value = capacity;
+            static constexpr OverflowPolicy overflow_policy_value = overflow_policy;
+
+            /// \brief Insert an element at the end of the buffer. Must only be called by the producer.
+            ///
+            /// \param value The element which should be inserted.
+            /// \return false if the element was dropped because the buffer was full (only with OverflowPolicy::reject_new),
+            /// true otherwise.
+            bool insert(const T& value)
+            {
+                if (makeRoom(1) == 0)
+                    return false;
+                index_type write_index = m_write_index;
+                m_buffer[write_index & mask] = value;
+                // The element must be stored before the consumer can see the new index
+                std::atomic_signal_fence(std::memory_order_release);
+                m_write_index = write_index + 1;
+                return true;
+            }
+
+            /// \brief Remove the oldest element from the buffer. Must only be called by the consumer.
+            ///
+            /// \param value Receives the oldest element, unchanged if the buffer is empty.
+            /// \return false if the buffer is empty, true otherwise.
+            bool get(T& value)
+            {
+                for (;;)
+                {
+                    index_type read_index = m_read_index;
+                    if (read_index == m_write_index)
+                        return false;
+                    std::atomic_signal_fence(std::memory_order_acquire);
+                    value = m_buffer[read_index & mask];
+                    // The element must be read before the producer is allowed to overwrite it
+                    std::atomic_signal_fence(std::memory_order_release);
+                    if (tryAdvanceRead(read_index, 1))
+                        return true;
+                }
+            }
+
+            /// \brief Remove the oldest element from the buffer. Must only be called by the consumer.
+            ///
+            /// \return The oldest element or a value initialized element if the buffer is empty.
+            T get()
+            {
+                T value{};
+                get(value);
+                return value;
+            }
+
+            /// \brief Insert multiple elements at the end of the buffer. Must only be called by the producer.
+            ///
+            /// The elements are copied in at most two contiguous blocks (per wait with OverflowPolicy::block). If there is
+            /// not enough room the overflow policy decides which elements are dropped, the dropped elements are counted.
+            ///
+            /// \param data Pointer to the first element which should be inserted.
+            /// \param length The number of elements which should be inserted, may exceed the capacity.
+            /// \return The number of elements which were stored in the buffer.
+            std::size_t write(const T* data, std::size_t length)
+            {
+                if constexpr (overflow_policy == OverflowPolicy::block)
+                {
+                    std::size_t written = 0;
+                    while (written < length)
+                    {
+                        index_type count = makeRoom(length - written);
+                        store(data + written, count);
+                        written += count;
+                    }
+                    return written;
+                }
+                else
+                {
+                    if (overflow_policy == OverflowPolicy::overwrite_oldest && length > capacity)
+                    {
+                        // Only the newest elements survive
+                        countDropped(length - capacity);
+                        data += length - capacity;
+                        length = capacity;
+                    }
+                    index_type count = makeRoom(length);
+                    store(data, count);
+                    return count;
+                }
+            }
+
+            /// \brief Remove multiple elements from the buffer. Must only be called by the consumer.
+            ///
+            /// The elements are copied in at most two contiguous blocks.
+            ///
+            /// \param data Pointer to the memory where the elements should be stored.
+            /// \param length The maximum number of elements which should be removed, may exceed the capacity.
+            /// \return The number of elements which were removed.
+            std::size_t read(T* data, std::size_t length)
+            {
+                for (;;)
+                {
+                    index_type read_index = m_read_index;
+                    index_type available = static_cast<index_type>(m_write_index - read_index);
+                    index_type count = (length < available) ? static_cast<index_type>(length) : available;
+                    std::atomic_signal_fence(std::memory_order_acquire);
+                    index_type offset = read_index & mask;
+                    index_type first = (count < capacity - offset) ? count : capacity - offset;
+                    std::memcpy(data, m_buffer + offset, first * sizeof(T));
+                    std::memcpy(data + first, m_buffer, (count - first) * sizeof(T));
+                    std::atomic_signal_fence(std::memory_order_release);
+                    if (tryAdvanceRead(read_index, count))
+                        return count;
+                }
+            }
+
+            /// \brief Remove multiple elements from the buffer without copying them. Must only be called by the consumer.
+            ///
+            /// E.g. to release a record whose length is known and whose elements were already processed in place.
+            ///
+            /// \param length The maximum number of elements which should be removed, may exceed the capacity.
+            /// \return The number of elements which were removed.
+            std::size_t skip(std::size_t length)
+            {
+                for (;;)
+                {
+                    index_type read_index = m_read_index;
+                    index_type available = static_cast<index_type>(m_write_index - read_index);
+                    index_type count = (length < available) ? static_cast<index_type>(length) : available;
+                    if (tryAdvanceRead(read_index, count))
+                        return count;
+                }
+            }
+
+            /// \brief The unread elements which are stored contiguous starting at the oldest element. Must only be called by the consumer.
+            ///
+            /// The elements stay in the buffer until they are released with commit(). If the unread elements wrap around the end
+            /// of the buffer memory, only the first part is returned, the rest is returned after the commit.
+            ///
+            /// \return Pointer to the oldest element and the number of contiguous elements.
+            segment<const T> peek_contiguous()
+            {
+                index_type read_index = m_read_index;
+                index_type available = static_cast<index_type>(m_write_index - read_index);
+                std::atomic_signal_fence(std::memory_order_acquire);
+                m_peek_index = read_index;
+                index_type offset = read_index & mask;
+                index_type contiguous = capacity - offset;
+                return {m_buffer + offset, (available < contiguous) ? available : contiguous};
+            }
+
+            /// \brief All unread elements starting at the oldest element. Must only be called by the consumer.
+            ///
+            /// Like peek_contiguous(), but the elements which wrap around the end of the buffer memory are returned as
+            /// second segment, so all of them can be processed without copying before they are released with commit().
+            segment_pair<const T> peek_segments()
+            {
+                index_type read_index = m_read_index;
+                index_type available = static_cast<index_type>(m_write_index - read_index);
+                std::atomic_signal_fence(std::memory_order_acquire);
+                m_peek_index = read_index;
+                index_type offset = read_index & mask;
+                index_type contiguous = capacity - offset;
+                if (available <= contiguous)
+                    return {{m_buffer + offset, available}, {m_buffer, 0}};
+                return {{m_buffer + offset, contiguous}, {m_buffer, static_cast<index_type>(available - contiguous)}};
+            }
 
-            void insert(std::uint8_t byte)
+            /// \brief Release elements obtained by peek_contiguous() or peek_segments(). Must only be called by the consumer.
+            ///
+            /// \param length The number of elements which were consumed, must not exceed the size returned by the peek.
+            /// \return false if the producer overwrote some of the peeked elements in the meantime (only possible with
+            /// OverflowPolicy::overwrite_oldest), true otherwise.
+            bool commit(index_type length)
             {
-                // If we write at the location of the next read, we have a overflow
-                if (m_next_write_index == m_next_read_index)
-                    m_status_flags |= 0x01;
-                // If we never wrote something in the buffer the read pointer is located after the entries
-                if (m_next_read_index > capacity)
-                    m_next_read_index = 0;
-                m_buffer[m_next_write_index] = byte;
-                m_next_write_index = (m_next_write_index + 1) % capacity;
+                std::atomic_signal_fence(std::memory_order_release);
+                if constexpr (overflow_policy == OverflowPolicy::overwrite_oldest)
+                {
+                    multitasking::InterruptGuard guard;
+                    index_type dropped = m_read_index - m_peek_index;
+                    if (dropped < length)
+                        m_read_index = m_peek_index + length;
+                    return dropped == 0;
+                }
+                else
+                {
+                    m_read_index = m_peek_index + length;
+                    return true;
+                }
             }
 
-            std::uint8_t get()
+            /// \brief The free space which is contiguous starting at the write position. Must only be called by the producer.
+            ///
+            /// Data can be written directly into the returned memory (e.g. by a SPI or UART driver), it becomes visible to
+            /// the consumer after publish(). The overflow policy is not applied, only the currently free space is returned.
+            ///
+            /// \return Pointer to the write position and the number of contiguous free elements.
+            segment<T> reserve_contiguous()
             {
-                // For security reasons: if we never wrote something we should return 0
-                if (m_next_read_index > capacity)
-                    return 0;
-                std::uint8_t temp = m_buffer[m_next_read_index];
-                m_next_read_index = (m_next_read_index + 1) % capacity;
-                return temp;
+                index_type write_index = m_write_index;
+                index_type free = capacity - static_cast<index_type>(write_index - m_read_index);
+                index_type offset = write_index & mask;
+                index_type contiguous = capacity - offset;
+                return {m_buffer + offset, (free < contiguous) ? free : contiguous};
             }
 
+            /// \brief All free space starting at the write position. Must only be called by the producer.
+            ///
+            /// Like reserve_contiguous(), but the free space at the start of the buffer memory is returned as second
+            /// segment, e.g. to assemble a record of unknown length which is only published once it is complete.
+            segment_pair<T> reserve_segments()
+            {
+                index_type write_index = m_write_index;
+                index_type free = capacity - static_cast<index_type>(write_index - m_read_index);
+                index_type offset = write_index & mask;
+                index_type contiguous = capacity - offset;
+                if (free <= contiguous)
+                    return {{m_buffer + offset, free}, {m_buffer, 0}};
+                return {{m_buffer + offset, contiguous}, {m_buffer, static_cast<index_type>(free - contiguous)}};
+            }
+
+            /// \brief Make elements written into the memory obtained by reserve_contiguous() or reserve_segments() visible. Must only be called by the producer.
+            ///
+            /// \param length The number of elements which were written, must not exceed the size returned by the reservation.
+            void publish(index_type length)
+            {
+                std::atomic_signal_fence(std::memory_order_release);
+                m_write_index = m_write_index + length;
+            }
+
+            /// \brief The number of elements which can be read.
+            index_type size() const
+            {
+                return static_cast<index_type>(m_write_index - m_read_index);
+            }
+
+            bool empty() const
+            {
+                return m_write_index == m_read_index;
+            }
+
+            bool full() const
+            {
+                return size() == capacity;
+            }
+
+            /// \brief Was at least one element dropped because the buffer was full?
             bool overflow() const
             {
-                return m_status_flags & 0x01;
+                return m_dropped != 0;
             }
 
+            /// \brief The number of elements dropped because the buffer was full, saturates at 0xffff.
+            std::uint16_t dropped() const
+            {
+                return m_dropped;
+            }
+
+            /// \brief Discard all unread elements and reset the drop counter. Must only be called by the consumer.
             void clear()
             {
-                m_next_read_index = capacity + 1;
-                m_next_write_index = 0;
-                m_status_flags = 0;
+                if constexpr (overflow_policy == OverflowPolicy::overwrite_oldest)
+                {
+                    multitasking::InterruptGuard guard;
+                    m_read_index = m_write_index;
+                }
+                else
+                    m_read_index = m_write_index;
+                m_dropped = 0;
             }
 
+            /// \brief Reset the drop counter.
             void clear_overflow()
             {
-                m_status_flags &= 0xfe;
+                m_dropped = 0;
             }
 
-            bool empty() const
+        private:
+            static constexpr index_type mask = capacity - 1;
+            static constexpr std::size_t storage_alignment = (sizeof(T) % 2 == 0 && alignof(T) < 2) ? 2 : alignof(T);
+
+            /// \brief Apply the overflow policy for inserting length elements.
+            ///
+            /// \param length The number of elements to insert, with OverflowPolicy::overwrite_oldest at most the capacity.
+            /// \return The number of elements which can be stored now.
+            index_type makeRoom(std::size_t length)
             {
-                return (m_next_write_index == m_next_read_index && !overflow()) || m_next_read_index > capacity;
+                index_type free = capacity - size();
+                if (length <= free)
+                    return static_cast<index_type>(length);
+
+                if constexpr (overflow_policy == OverflowPolicy::reject_new)
+                {
+                    countDropped(length - free);
+                    return free;
+                }
+                else if constexpr (overflow_policy == OverflowPolicy::overwrite_oldest)
+                {
+                    multitasking::InterruptGuard guard;
+                    free = capacity - size();
+                    if (length > free)
+                    {
+                        m_read_index = m_read_index + static_cast<index_type>(length - free);
+                        countDropped(length - free);
+                    }
+                    return static_cast<index_type>(length);
+                }
+                else
+                {
+                    while ((free = capacity - size()) == 0)
+                    {
+                        if constexpr (wait_callback != nullptr)
+                            wait_callback();
+                    }
+                    return (length < free) ? static_cast<index_type>(length) : free;
+                }
             }
-        private:
-            std::size_t m_next_read_index = capacity + 1;
-            std::size_t m_next_write_index = 0;
-
-
-            std::uint8_t m_status_flags = 0x00;
-            //Status bits
-            /*
-             * Bit 0    Overflow
-             * Bit 1
-             * Bit 2
-             * Bit 3
-             * Bit 4
-             * Bit 5
-             * Bit 6
-             * Bit 7
-             */
+
+            /// \brief Copy elements to the write position and publish them, the room must have been made before.
+            void store(const T* data, index_type length)
+            {
+                index_type write_index = m_write_index;
+                index_type offset = write_index & mask;
+                index_type first = (length < capacity - offset) ? length : capacity - offset;
+                std::memcpy(m_buffer + offset, data, first * sizeof(T));
+                std::memcpy(m_buffer, data + first, (length - first) * sizeof(T));
+                std::atomic_signal_fence(std::memory_order_release);
+                m_write_index = write_index + length;
+            }
+
+            /// \brief Release elements read starting at read_index.
+            ///
+            /// \return false if the producer dropped elements in the meantime and the read has to be repeated.
+            bool tryAdvanceRead(index_type read_index, index_type length)
+            {
+                if constexpr (overflow_policy == OverflowPolicy::overwrite_oldest)
+                {
+                    multitasking::InterruptGuard guard;
+                    if (m_read_index != read_index)
+                        return false;
+                    m_read_index = read_index + length;
+                }
+                else
+                    m_read_index = read_index + length;
+                return true;
+            }
+
+            void countDropped(std::size_t count)
+            {
+                std::uint16_t dropped = m_dropped;
+                m_dropped = (count > 0xffffu - dropped) ? 0xffff : static_cast<std::uint16_t>(dropped + count);
+            }
+
+            alignas(storage_alignment) T m_buffer[capacity];
+            volatile index_type m_write_index = 0;
+            volatile index_type m_read_index = 0;
+            index_type m_peek_index = 0;
+            volatile std::uint16_t m_dropped = 0;
         };
+
+        /// \brief Lock free single producer, single consumer ring buffer for bytes.
+        ///
+        /// \tparam capacity The number of bytes the buffer can hold, must be a power of two.
+        /// \tparam overflow_policy What happens if bytes are inserted while the buffer is full.
+        template<std::size_t capacity, OverflowPolicy overflow_policy = OverflowPolicy::reject_new>
+        using byte_ring_buffer = ring_buffer<std::uint8_t, capacity, overflow_policy>;
     }
 }
 
@@ -7,20 +7,25 @@ namespace msp430hal
 {
     namespace multitasking
     {
-        /// \brief a simple guard that disables interrupts at creation and reenables them when destroyed
+        /// \brief a simple guard that disables interrupts at creation and restores the previous interrupt state when destroyed
+        ///
+        /// Restoring instead of unconditionally enabling the interrupts allows nesting guards and using them inside ISRs.
         struct InterruptGuard
         {
-            InterruptGuard()
+            InterruptGuard() : m_state(__get_interrupt_state())
             {
                 __disable_interrupt();
             }
 
             ~InterruptGuard()
             {
-                __enable_interrupt();
+                __set_interrupt_state(m_state);
             }
 
             void operator=(InterruptGuard& other) = delete;
+
+        private:
+            unsigned short m_state;
         };
     }
 }
@@ -0,0 +1,333 @@
+#ifndef MSP430HAL_PROTOCOL_FRAMING_H
+#define MSP430HAL_PROTOCOL_FRAMING_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../util/crc.h"
+
+namespace msp430hal
+{
+    namespace protocol
+    {
+        /// \brief The result of feeding a byte into a frame decoder.
+        enum class FrameStatus : std::uint8_t
+        {
+            incomplete, ///< The frame is not finished yet (or an empty frame was skipped).
+            complete, ///< A frame with a valid CRC is available in the buffer.
+            crc_error, ///< The frame ended but the CRC did not match.
+            overflow, ///< The frame ended but was longer than the buffer.
+            invalid ///< The frame ended but violated the encoding or was shorter than the CRC.
+        };
+
+        namespace
+        {
+            static constexpr std::uint8_t slip_end = 0xc0;
+            static constexpr std::uint8_t slip_esc = 0xdb;
+            static constexpr std::uint8_t slip_esc_end = 0xdc;
+            static constexpr std::uint8_t slip_esc_esc = 0xdd;
+        }
+
+        /// \brief Common part of the frame decoders: CRC check and storage of the payload.
+        ///
+        /// The decoded bytes pass through a two byte delay line before they are stored, so the trailing CRC never
+        /// reaches the buffer and the buffer only has to hold the payload.
+        ///
+        /// If the frames are decoded in an ISR, setBuffer() passes the buffer of a complete frame on and continues with
+        /// another one, e.g. with blocks of a memory::block_pool, so the next frame does not overwrite the payload
+        /// before the main loop processed it.
+        class FrameDecoder
+        {
+        public:
+            /// \param buffer Receives the payload of the frames.
+            /// \param capacity The size of the buffer.
+            FrameDecoder(std::uint8_t* buffer, std::size_t capacity) : m_buffer(buffer), m_capacity(capacity)
+            {}
+
+            /// \brief The payload length of the last complete frame.
+            std::size_t length() const
+            {
+                return m_length;
+            }
+
+            const std::uint8_t* data() const
+            {
+                return m_buffer;
+            }
+
+            /// \brief Store the following frames in another buffer.
+            ///
+            /// Meant to be called right after push() returned FrameStatus::complete: the payload stays in the previous
+            /// buffer, which is returned, and length() is reset. A frame which is received at the time of the call
+            /// ends as FrameStatus::invalid, its first bytes are in the previous buffer.
+            ///
+            /// \param buffer Receives the payload of the following frames.
+            /// \param capacity The size of the buffer.
+            /// \return The previous buffer.
+            std::uint8_t* setBuffer(std::uint8_t* buffer, std::size_t capacity)
+            {
+                std::uint8_t* previous = m_buffer;
+                if (m_delayed != 0)
+                    m_invalid = true;
+                m_buffer = buffer;
+                m_capacity = capacity;
+                m_length = 0;
+                return previous;
+            }
+
+            /// \brief Drop the frame which is currently received, e.g. after a timeout.
+            void reset()
+            {
+                m_crc = crc16_ccitt_initial;
+                m_length = 0;
+                m_delayed = 0;
+                m_overflow = false;
+                m_invalid = false;
+            }
+
+        protected:
+            void emit(std::uint8_t byte)
+            {
+                m_crc = crc16_ccitt_update(m_crc, byte);
+                if (m_delayed < 2)
+                {
+                    m_delay[m_delayed] = byte;
+                    ++m_delayed;
+                    return;
+                }
+                if (m_length < m_capacity)
+                    m_buffer[m_length++] = m_delay[0];
+                else
+                    m_overflow = true;
+                m_delay[0] = m_delay[1];
+                m_delay[1] = byte;
+            }
+
+            /// \brief Finish the current frame at a delimiter and prepare for the next one.
+            FrameStatus finish()
+            {
+                FrameStatus status;
+                if (m_delayed == 0 && !m_invalid)
+                    status = FrameStatus::incomplete;
+                else if (m_invalid || m_delayed < 2)
+                    status = FrameStatus::invalid;
+                else if (m_overflow)
+                    status = FrameStatus::overflow;
+                else if (m_crc != 0)
+                    status = FrameStatus::crc_error;
+                else
+                    status = FrameStatus::complete;
+
+                std::size_t length = m_length;
+                reset();
+                if (status == FrameStatus::complete)
+                    m_length = length;
+                return status;
+            }
+
+            std::uint8_t* m_buffer;
+            std::size_t m_capacity;
+            std::size_t m_length = 0;
+            std::uint16_t m_crc = crc16_ccitt_initial;
+            std::uint8_t m_delay[2] = {};
+            std::uint8_t m_delayed = 0;
+            bool m_overflow = false;
+            bool m_invalid = false;
+        };
+
+        /// \brief Incremental decoder for COBS frames with a trailing CRC-16, delimited by 0x00.
+        ///
+        /// Feed every received byte to push(), e.g. from the receive ISR. The payload of a complete frame stays valid
+        /// in the buffer until the next byte is pushed, unless the buffer is exchanged with setBuffer().
+        class CobsDecoder : public FrameDecoder
+        {
+        public:
+            using FrameDecoder::FrameDecoder;
+
+            FrameStatus push(std::uint8_t byte)
+            {
+                if (byte == 0x00)
+                {
+                    // A frame must not end inside a block, the zero implied by the last block is not part of the data
+                    if (m_remaining != 0)
+                        m_invalid = true;
+                    m_remaining = 0;
+                    m_zero_pending = false;
+                    return finish();
+                }
+                if (m_remaining == 0)
+                {
+                    if (m_zero_pending)
+                        emit(0x00);
+                    m_remaining = byte - 1;
+                    m_zero_pending = (byte != 0xff);
+                    return FrameStatus::incomplete;
+                }
+                emit(byte);
+                --m_remaining;
+                return FrameStatus::incomplete;
+            }
+
+            void reset()
+            {
+                FrameDecoder::reset();
+                m_remaining = 0;
+                m_zero_pending = false;
+            }
+
+        private:
+            std::uint8_t m_remaining = 0;
+            bool m_zero_pending = false;
+        };
+
+        /// \brief Incremental decoder for SLIP (RFC 1055) frames with a trailing CRC-16.
+        ///
+        /// Feed every received byte to push(), e.g. from the receive ISR. The payload of a complete frame stays valid
+        /// in the buffer until the next byte is pushed, unless the buffer is exchanged with setBuffer().
+        class SlipDecoder : public FrameDecoder
+        {
+        public:
+            using FrameDecoder::FrameDecoder;
+
+            FrameStatus push(std::uint8_t byte)
+            {
+                if (byte == slip_end)
+                {
+                    if (m_escaped)
+                        m_invalid = true;
+                    m_escaped = false;
+                    return finish();
+                }
+                if (m_escaped)
+                {
+                    m_escaped = false;
+                    if (byte == slip_esc_end)
+                        emit(slip_end);
+                    else if (byte == slip_esc_esc)
+                        emit(slip_esc);
+                    else
+                        m_invalid = true;
+                }
+                else if (byte == slip_esc)
+                    m_escaped = true;
+                else
+                    emit(byte);
+                return FrameStatus::incomplete;
+            }
+
+            void reset()
+            {
+                FrameDecoder::reset();
+                m_escaped = false;
+            }
+
+        private:
+            bool m_escaped = false;
+        };
+
+        /// \brief The maximum number of bytes encodeCobsFrame() writes for a payload of the given length.
+        constexpr std::size_t cobsEncodedSize(std::size_t length)
+        {
+            return (length + 2) + (length + 2) / 254 + 2;
+        }
+
+        /// \brief The maximum number of bytes encodeSlipFrame() writes for a payload of the given length.
+        constexpr std::size_t slipEncodedSize(std::size_t length)
+        {
+            return 2 * (length + 2) + 1;
+        }
+
+        /// \brief Encode a payload and its CRC-16 as COBS frame, followed by the 0x00 delimiter.
+        ///
+        /// The bytes are inserted directly into the sink, e.g. the transmit buffer of a BufferedUART or any other ring
+        /// buffer. Each block is found by scanning ahead in the payload, which also calculates the CRC, so no
+        /// temporary copy of the frame is needed.
+        ///
+        /// \tparam Sink Provides bool insert(std::uint8_t), like memory::ring_buffer.
+        /// \return false if the sink rejected a byte, the receiver will then discard the truncated frame.
+        template<typename Sink>
+        bool encodeCobsFrame(Sink& sink, const std::uint8_t* data, std::size_t length)
+        {
+            const std::size_t total = length + 2;
+            std::uint16_t crc = crc16_ccitt_initial;
+            // The CRC is complete as soon as the scan passed the payload, which happens before its bytes are read
+            auto byteAt = [&](std::size_t index) -> std::uint8_t
+            {
+                if (index < length)
+                    return data[index];
+                return (index == length) ? static_cast<std::uint8_t>(crc >> 8) : static_cast<std::uint8_t>(crc);
+            };
+
+            bool accepted = true;
+            std::size_t start = 0;
+            for (;;)
+            {
+                std::size_t end = start;
+                bool zero = false;
+                while (end < total && end - start < 254)
+                {
+                    if (end < length)
+                        crc = crc16_ccitt_update(crc, data[end]);
+                    if (byteAt(end) == 0x00)
+                    {
+                        zero = true;
+                        break;
+                    }
+                    ++end;
+                }
+
+                bool full_block = !zero && end - start == 254;
+                accepted &= sink.insert(static_cast<std::uint8_t>(full_block ? 0xff : end - start + 1));
+                for (std::size_t i = start; i < end; ++i)
+                    accepted &= sink.insert(byteAt(i));
+
+                if (zero)
+                    start = end + 1;
+                else if (full_block && end < total)
+                    start = end;
+                else
+                    break;
+            }
+            accepted &= sink.insert(0x00);
+            return accepted;
+        }
+
+        /// \brief Encode a payload and its CRC-16 as SLIP frame, followed by the END delimiter.
+        ///
+        /// \tparam Sink Provides bool insert(std::uint8_t), like memory::ring_buffer.
+        /// \return false if the sink rejected a byte, the receiver will then discard the truncated frame.
+        template<typename Sink>
+        bool encodeSlipFrame(Sink& sink, const std::uint8_t* data, std::size_t length)
+        {
+            bool accepted = true;
+            auto put = [&](std::uint8_t byte)
+            {
+                if (byte == slip_end)
+                {
+                    accepted &= sink.insert(slip_esc);
+                    accepted &= sink.insert(slip_esc_end);
+                }
+                else if (byte == slip_esc)
+                {
+                    accepted &= sink.insert(slip_esc);
+                    accepted &= sink.insert(slip_esc_esc);
+                }
+                else
+                    accepted &= sink.insert(byte);
+            };
+
+            std::uint16_t crc = crc16_ccitt_initial;
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                crc = crc16_ccitt_update(crc, data[i]);
+                put(data[i]);
+            }
+            put(static_cast<std::uint8_t>(crc >> 8));
+            put(static_cast<std::uint8_t>(crc));
+            accepted &= sink.insert(slip_end);
+            return accepted;
+        }
+    }
+}
+
+#endif //MSP430HAL_PROTOCOL_FRAMING_H
@@ -4,6 +4,7 @@
 #include <msp430.h>
 #include <cstdint>
 #include <type_traits>
+#include "../util/register.h"
 
 namespace msp430hal
 {
@@ -79,7 +80,7 @@ namespace msp430hal
         {
 
             //Arrays with the configuration registers for each available timer and template functions to access them easily.
-            constexpr volatile unsigned int* timer_a_registers[][17]{
+            constexpr register16_t* timer_a_registers[][17]{
 #ifdef __MSP430_HAS_TA3__
                     {&TA0CTL, &TA0R, &TA0CCTL0, &TA0CCR0, &TA0CCTL1, &TA0CCR1, &TA0CCTL2, &TA0CCR2, nullptr, nullptr,
                  nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &TA0IV},
@@ -100,17 +101,17 @@ namespace msp430hal
             };
 
 #ifdef __MSP430_HAS_TB7__
-            constexpr volatile unsigned int* timer_b_registers[][17]{
+            constexpr register16_t* timer_b_registers[][17]{
             {&TB0CTL, &TB0R, &TB0CCTL0, &TB0CCR0, &TB0CCTL1, &TB0CCR1, &TB0CCTL2, &TB0CCR2, &TB0CCTL3, &TB0CCR3, &TB0CCTL4, &TB0CCR4, &TB0CCTL5, &TB0CCR5, &TB0CCTL6, &TB0CCR6, &TB0IV},
         };
 #else
-            constexpr volatile unsigned int*** timer_b_registers = nullptr;
+            constexpr register16_t*** timer_b_registers = nullptr;
 #endif
 
 
 #if __cplusplus >= 201703L
             template<const TimerModule module, const std::uint8_t instance>
-            constexpr volatile unsigned int* getTimerRegister(std::uint8_t reg_no)
+            constexpr register16_t* getTimerRegister(std::uint8_t reg_no)
             {
                 if constexpr(module == TimerModule::timer_a)
                 {
@@ -124,7 +125,7 @@ namespace msp430hal
 #else
 
             template<const TimerModule timer_module, const std::uint_fast8_t instance>
-            constexpr volatile unsigned int* getTimerRegister(std::uint_fast8_t reg_no)
+            constexpr register16_t* getTimerRegister(std::uint_fast8_t reg_no)
             {
                 return (timer_module == TimerModule::timer_a) ? timer_a_registers[instance][reg_no] : timer_b_registers[instance][reg_no];
             }
@@ -133,13 +134,13 @@ namespace msp430hal
             template<const TimerModule module, const std::uint_fast8_t instance>
             struct CaptureControlRegisters
             {
-                static constexpr volatile unsigned int* data = nullptr;
+                static constexpr register16_t* data = nullptr;
             };
 
             template<const std::uint_fast8_t instance>
             struct CaptureControlRegisters<TimerModule::timer_a, instance>
             {
-                static constexpr volatile unsigned int* data[3][2] = {
+                static constexpr register16_t* data[3][2] = {
                         {getTimerRegister<TimerModule::timer_a, instance>(2), getTimerRegister<TimerModule::timer_a, instance>(3)},
                         {getTimerRegister<TimerModule::timer_a, instance>(4), getTimerRegister<TimerModule::timer_a, instance>(5)},
                         {getTimerRegister<TimerModule::timer_a, instance>(6), getTimerRegister<TimerModule::timer_a, instance>(7)},
@@ -147,12 +148,12 @@ namespace msp430hal
             };
 
             template<const std::uint_fast8_t instance>
-            constexpr volatile unsigned int* CaptureControlRegisters<TimerModule::timer_a, instance>::data[3][2];
+            constexpr register16_t* CaptureControlRegisters<TimerModule::timer_a, instance>::data[3][2];
 
             template<const std::uint_fast8_t instance>
             struct CaptureControlRegisters<TimerModule::timer_b, instance>
             {
-                static constexpr volatile unsigned int* data[7][2] = {
+                static constexpr register16_t* data[7][2] = {
                         {getTimerRegister<TimerModule::timer_b, instance>(2), getTimerRegister<TimerModule::timer_b, instance>(3)},
                         {getTimerRegister<TimerModule::timer_b, instance>(4), getTimerRegister<TimerModule::timer_b, instance>(5)},
                         {getTimerRegister<TimerModule::timer_b, instance>(6), getTimerRegister<TimerModule::timer_b, instance>(7)},
@@ -164,7 +165,7 @@ namespace msp430hal
             };
 
             template<const std::uint_fast8_t instance>
-            constexpr volatile unsigned int* CaptureControlRegisters<TimerModule::timer_b, instance>::data[7][2];
+            constexpr register16_t* CaptureControlRegisters<TimerModule::timer_b, instance>::data[7][2];
 
         }
 
@@ -176,9 +177,9 @@ namespace msp430hal
                 const int instance>
         struct Timer_t
         {
-            static constexpr volatile unsigned int* ctl = getTimerRegister<module, instance>(0);
-            static constexpr volatile unsigned int* counter = getTimerRegister<module, instance>(1);
-            static constexpr volatile unsigned int* tiv = getTimerRegister<module, instance>(16);
+            static constexpr register16_t* ctl = getTimerRegister<module, instance>(0);
+            static constexpr register16_t* counter = getTimerRegister<module, instance>(1);
+            static constexpr register16_t* tiv = getTimerRegister<module, instance>(16);
 
             using capture_control_registers = CaptureControlRegisters<module, instance>;
 
@@ -188,7 +189,7 @@ namespace msp430hal
             /// Clears the TAR register, sets the clock divider to 1 and stops the timer.
             static void reset()
             {
-#ifdef __GNUC__
+#if defined(__GNUC__) && defined(__MSP430__)
                 __asm__ __volatile__ ( "BIS.W %[taclr], %[tctl]"
                         : [tctl] "=m"(*ctl)
                 : [taclr] "i"(TACLR)
@@ -209,7 +210,7 @@ namespace msp430hal
             /// \brief Enables the timer overflow interrupt.
             static void enableInterrupt()
             {
-#ifdef __GNUC__
+#if defined(__GNUC__) && defined(__MSP430__)
                 __asm__ __volatile__ ( "BIS.W %[tie], %[tctl]"
                         : [tctl] "=m"(*ctl)
                 : [tie] "i"(TAIE)
@@ -315,7 +316,7 @@ namespace msp430hal
             template<std::uint_fast8_t capture_unit>
             static void compareMode()
             {
-                *capture_control_registers::data[capture_unit][0] |= 0xfeff;
+                *capture_control_registers::data[capture_unit][0] &= 0xfeff;
             }
 
             /// \brief Enable capture mode.
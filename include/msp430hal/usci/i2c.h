@@ -1,10 +1,14 @@
-#ifndef IR_TRAIN_DETECTOR_I2C_H
-#define IR_TRAIN_DETECTOR_I2C_H
+#ifndef MSP430HAL_USCI_I2C_H
+#define MSP430HAL_USCI_I2C_H
 
 #include <msp430.h>
+#include <cstddef>
 #include <cstdint>
+#include <type_traits>
 #include "usci.h"
+#include "../gpio/pin.h"
 #include "../memory/ring_buffer.h"
+#include "../multitasking/interrupt_guard.h"
 
 namespace msp430hal
 {
@@ -12,15 +16,22 @@ namespace msp430hal
     {
         namespace
         {
-            static constexpr volatile unsigned int* usci_b_i2c_reg[][2] = {
+            static constexpr register16_t* usci_b_i2c_reg[][2] = {
                     {&UCB0I2COA, &UCB0I2CSA},
 #ifdef __MSP430_HAS_USCI_AB1__
                     {&UCB1I2COA, &UCB1I2CSA}
 #endif
             };
 
+            static constexpr register8_t* usci_b_i2c_ie_reg[] = {
+                    &UCB0I2CIE,
+#ifdef __MSP430_HAS_USCI_AB1__
+                    &UCB1I2CIE
+#endif
+            };
+
             template<int instance>
-            constexpr volatile unsigned int* getUsciI2CRegister(int reg_no)
+            constexpr register16_t* getUsciI2CRegister(int reg_no)
             {
                 return usci_b_i2c_reg[instance][reg_no];
             }
@@ -38,6 +49,95 @@ namespace msp430hal
             receive
         };
 
+        /// \brief The port pins of a USCI_B module in I2C mode.
+        ///
+        /// Only USCI_B0 is mapped, SCL is P1.6 and SDA is P1.7 on the MSP430G2553. The pins of USCI_B1 depend on the
+        /// device and have to be configured by the application.
+        template<std::uint_fast8_t instance>
+        struct I2CPins
+        {
+            static constexpr std::uint8_t scl = gpio::p_6;
+            static constexpr std::uint8_t sda = gpio::p_7;
+
+            /// \brief Connect SCL and SDA to the USCI.
+            static void init()
+            {
+                if constexpr (instance == 0)
+                    gpio::GPIOPins<gpio::port_1, scl | sda>::switchFunction(gpio::PinFunction::secondary_peripheral);
+            }
+
+            /// \brief Disconnect SCL and SDA from the USCI, both are released and can be pulled low by pull().
+            ///
+            /// The lines are only pulled low or released like the open drain outputs of the USCI, they need external
+            /// pull-up resistors.
+            static void release()
+            {
+                if constexpr (instance == 0)
+                {
+                    *gpio::GPIOPins<gpio::port_1, scl | sda>::dir &= ~(scl | sda);
+                    *gpio::GPIOPins<gpio::port_1, scl | sda>::out &= ~(scl | sda);
+                    *gpio::GPIOPins<gpio::port_1, scl | sda>::ren &= ~(scl | sda);
+                    gpio::GPIOPins<gpio::port_1, scl | sda>::switchFunction(gpio::PinFunction::io);
+                }
+            }
+
+            /// \brief Pull the given lines low (true) or release them (false) after release().
+            static void pull(std::uint8_t lines, bool low)
+            {
+                if constexpr (instance == 0)
+                {
+                    if (low)
+                        *gpio::GPIOPins<gpio::port_1, scl | sda>::dir |= lines;
+                    else
+                        *gpio::GPIOPins<gpio::port_1, scl | sda>::dir &= ~lines;
+                }
+            }
+
+            /// \brief Is SDA high?
+            static bool sdaHigh()
+            {
+                if constexpr (instance == 0)
+                    return *gpio::GPIOPins<gpio::port_1, scl | sda>::in & sda;
+                else
+                    return true;
+            }
+        };
+
+        /// \brief SCL frequencies of the I2C bus modes the USCI supports.
+        enum I2CBusSpeed : std::uint32_t
+        {
+            standard_mode = 100000, ///< 100 kHz
+            fast_mode = 400000 ///< 400 kHz
+        };
+
+        /// \brief The bit clock divider UCBRx for an SCL frequency, computed at compile time.
+        ///
+        /// The divider is rounded up, so the bus never runs faster than scl_frequency. A configuration which misses the
+        /// target by more than max_deviation_percent fails to compile, e.g. 400 kHz from a 1 MHz BRCLK.
+        ///
+        /// \tparam brclk The frequency of the clock source selected for the USCI.
+        /// \tparam scl_frequency The target SCL frequency, at most 400 kHz.
+        /// \tparam max_deviation_percent How much slower than the target the bus may run.
+        template<std::uint32_t brclk, std::uint32_t scl_frequency, std::uint8_t max_deviation_percent = 10>
+        struct I2CClockDivider
+        {
+            static_assert(scl_frequency > 0 && scl_frequency <= fast_mode, "I2C supports at most 400 kHz (fast mode)");
+
+            static constexpr std::uint32_t divider = (brclk + scl_frequency - 1) / scl_frequency;
+
+            /// \brief The value for UCBxBR0 and UCBxBR1.
+            static constexpr std::uint16_t value = static_cast<std::uint16_t>(divider);
+
+            /// \brief The SCL frequency the bus actually runs at.
+            static constexpr std::uint32_t frequency = brclk / divider;
+
+            static_assert(divider >= 4, "The USCI needs at least 4 BRCLK cycles per SCL period, choose a faster BRCLK");
+            static_assert(divider <= 0xffff, "The SCL frequency is too low for the BRCLK");
+            static_assert(static_cast<std::uint64_t>(frequency) * 100 >=
+                          static_cast<std::uint64_t>(scl_frequency) * (100 - max_deviation_percent),
+                          "The SCL frequency can not be reached from the BRCLK, choose another clock");
+        };
+
         template<std::uint8_t instance,
                  UsciClockSource clock_source = uclk,
                  std::uint16_t ucbr = 0x0001,
@@ -49,21 +149,25 @@ namespace msp430hal
         {
             typedef Usci_t<UsciModule::usci_b, instance> Usci;
 
-            static constexpr volatile unsigned int* i2coa = getUsciI2CRegister<instance>(0);
-            static constexpr volatile unsigned int* i2csa = getUsciI2CRegister<instance>(1);
+            static constexpr register16_t* i2coa = getUsciI2CRegister<instance>(0);
+            static constexpr register16_t* i2csa = getUsciI2CRegister<instance>(1);
+            static constexpr register8_t* i2cie = usci_b_i2c_ie_reg[instance];
+
+            static constexpr bool master_mode_value = master_mode;
 
             static void init()
             {
                 Usci::disableModule();
+                I2CPins<instance>::init();
 
                 *Usci::ctl_0 = (own_addressing_mode << 7) | (multi_master_env << 5) |
                                 (master_mode << 3) | 0x07;
                 *Usci::ctl_1 = clock_source | 0x1;
 
                 if (own_addressing_mode == addressing_7)
-                    *i2coa |= own_address & 0x007f;
+                    *i2coa = own_address & 0x007f;
                 else
-                    *i2coa |= own_address & 0x02ff;
+                    *i2coa = own_address & 0x03ff;
 
                 *Usci::br_0 = static_cast<std::uint8_t>(ucbr & 0x00ff);
                 *Usci::br_1 = static_cast<std::uint8_t>((ucbr & 0xff00) >> 8);
@@ -72,38 +176,16 @@ namespace msp430hal
             static void prepareTransmit(std::uint16_t slave_address, I2CAdressingMode slave_adressing_mode = I2CAdressingMode::addressing_7)
             {
                 Usci::disableModule();
-
-                if (slave_adressing_mode == I2CAdressingMode::addressing_7)
-                {
-                    *Usci::ctl_0 |= (slave_adressing_mode << 6);
-                    *i2csa |= slave_address & 0x007f;
-                }
-                else
-                {
-                    *Usci::ctl_0 &= ~(slave_adressing_mode << 6);
-                    *i2csa |= slave_address & 0x02ff;
-                }
+                setSlaveAddress(slave_address, slave_adressing_mode);
                 setMode(I2CMode::transmit);
-
                 Usci::enableModule();
             }
 
             static void prepareReceive(std::uint16_t slave_address, I2CAdressingMode slave_adressing_mode = I2CAdressingMode::addressing_7)
             {
                 Usci::disableModule();
-
-                if (slave_adressing_mode == I2CAdressingMode::addressing_7)
-                {
-                    *Usci::ctl_0 |= (slave_adressing_mode << 6);
-                    *i2csa |= slave_address & 0x007f;
-                }
-                else
-                {
-                    *Usci::ctl_0 &= ~(slave_adressing_mode << 6);
-                    *i2csa |= slave_address & 0x02ff;
-                }
+                setSlaveAddress(slave_address, slave_adressing_mode);
                 setMode(I2CMode::receive);
-
                 Usci::enableModule();
             }
 
@@ -155,8 +237,132 @@ namespace msp430hal
                     *Usci::ctl_1 &= ~UCTR;
             }
 
+            /// \brief Free the bus from a slave which holds SDA low, e.g. because the master was reset in the middle of a
+            /// read.
+            ///
+            /// The pins are switched to GPIO and SCL is pulsed up to nine times until the slave releases SDA, then a stop
+            /// condition is generated and the pins are given back to the USCI. The lines are only pulled low or released,
+            /// like the open drain outputs of the USCI. The timing assumes that MCLK is not slower than BRCLK. Only the
+            /// pins of USCI_B0 are known.
+            static void recoverBus()
+            {
+                static_assert(instance == 0, "The bus recovery only knows the pins of USCI_B0");
+                using Pins = I2CPins<instance>;
+
+                disable();
+                Pins::release();
+                for (std::uint8_t pulse = 0; pulse < 9 && !Pins::sdaHigh(); ++pulse)
+                {
+                    Pins::pull(Pins::scl, true);
+                    halfClockDelay();
+                    Pins::pull(Pins::scl, false);
+                    halfClockDelay();
+                }
+                // Stop condition: SDA rises while SCL is high
+                Pins::pull(Pins::scl, true);
+                halfClockDelay();
+                Pins::pull(Pins::sda, true);
+                halfClockDelay();
+                Pins::pull(Pins::scl, false);
+                halfClockDelay();
+                Pins::pull(Pins::sda, false);
+                halfClockDelay();
+                init();
+            }
+
+        private:
+            /// \brief At least half an SCL period, i.e. ucbr / 2 BRCLK cycles, if MCLK is not slower than BRCLK.
+            static void halfClockDelay()
+            {
+                __delay_cycles(ucbr / 2 + 1);
+            }
+
+            /// \brief The addressing mode may only be changed while the module is in reset.
+            static void setSlaveAddress(std::uint16_t slave_address, I2CAdressingMode slave_adressing_mode)
+            {
+                if (slave_adressing_mode == I2CAdressingMode::addressing_7)
+                {
+                    *Usci::ctl_0 &= ~UCSLA10;
+                    *i2csa = slave_address & 0x007f;
+                }
+                else
+                {
+                    *Usci::ctl_0 |= UCSLA10;
+                    *i2csa = slave_address & 0x03ff;
+                }
+            }
+        };
+
+        /// \brief I2C_t with UCBRx derived from the BRCLK frequency and the SCL frequency, see I2CClockDivider.
+        ///
+        /// \tparam brclk The frequency of the clock selected with clock_source.
+        template<std::uint8_t instance,
+                 std::uint32_t brclk,
+                 std::uint32_t scl_frequency = standard_mode,
+                 UsciClockSource clock_source = smclk,
+                 bool master_mode = true,
+                 I2CAdressingMode own_addressing_mode = addressing_7,
+                 bool multi_master_env = false,
+                 std::uint16_t own_address = 0x0000>
+        using I2CClocked_t = I2C_t<instance, clock_source, I2CClockDivider<brclk, scl_frequency>::value, master_mode,
+                                   own_addressing_mode, multi_master_env, own_address>;
+
+        /// \brief The result of a transfer of BufferedBlockingI2CMaster.
+        enum class I2CStatus : std::uint8_t
+        {
+            ok, ///< All bytes were transferred.
+            nack, ///< The slave did not acknowledge its address or a byte, the transfer was stopped.
+            arbitration_lost, ///< Another master won the bus, the transfer was abandoned.
+            timeout ///< The transfer did not finish in time, the bus was recovered.
+        };
+
+        /// \brief Lets BufferedBlockingI2CMaster and AsyncI2CMaster wait without limit.
+        struct I2CNoTimeout
+        {
+            void start() {}
+
+            bool expired() const
+            {
+                return false;
+            }
+        };
+
+        /// \brief Bounds each transfer of BufferedBlockingI2CMaster or AsyncI2CMaster by a deadline on a hardware timer.
+        ///
+        /// The deadline starts with the transfer and is checked by every wait for the USCI. A transfer which is still
+        /// waiting when it expires is abandoned and the bus is recovered, so the worst case latency of a transfer is
+        /// timeout_ticks plus eleven SCL periods for the recovery (nine pulses and a stop condition).
+        ///
+        /// \tparam Timer A Timer_t which counts in continuous mode, e.g. from SMCLK. It is only read.
+        /// \tparam timeout_ticks The deadline in timer counts, less than half the counter range so that its wrap around
+        /// is handled.
+        template<typename Timer, std::uint16_t timeout_ticks>
+        struct I2CTimeout
+        {
+            static_assert(timeout_ticks > 0 && timeout_ticks < 0x8000, "The timeout must be within half the timer range");
+
+            void start()
+            {
+                m_start = *Timer::counter;
+            }
+
+            bool expired() const
+            {
+                return static_cast<std::uint16_t>(*Timer::counter - m_start) >= timeout_ticks;
+            }
+
+        private:
+            std::uint16_t m_start = 0;
         };
 
+        /// \brief Blocking I2C master, each transfer returns when it finished or failed.
+        ///
+        /// NACKs and a lost arbitration end a transfer with a status instead of waiting for a flag which is never set.
+        /// With I2CTimeout every transfer is bounded in time as well; if it expires, e.g. because a slave holds SDA or
+        /// SCL low, the bus is recovered with recoverBus().
+        ///
+        /// \tparam Timeout I2CTimeout, or I2CNoTimeout to opt in to transfers which block the CPU without limit if a
+        /// slave stalls the bus. There is no default, the choice has to be made explicitly.
         template<std::uint8_t instance,
                 std::size_t buffer_capacity,
                 UsciClockSource clock_source = uclk,
@@ -164,112 +370,782 @@ namespace msp430hal
                 bool master_mode = true,
                 I2CAdressingMode own_addressing_mode = addressing_7,
                 bool multi_master_env = false,
-                std::uint16_t own_address = 0x0000>
+                std::uint16_t own_address = 0x0000,
+                typename Timeout = void>
         struct BufferedBlockingI2CMaster
         {
+            static_assert(!std::is_void_v<Timeout>, "Choose I2CTimeout, or I2CNoTimeout to wait without limit");
+
             typedef I2C_t<instance, clock_source, ucbr, true, own_addressing_mode, multi_master_env, own_address> I2C;
+            using Usci = typename I2C::Usci;
 
             memory::byte_ring_buffer<buffer_capacity> buffer;
 
-            BufferedBlockingI2CMaster()
+            /// \brief Configure the USCI, it leaves the reset state with the first transfer.
+            ///
+            /// The constructor does not touch the hardware, so the driver can be a global object which is initialized
+            /// after the clocks were set up.
+            void init()
             {
                 I2C::init();
             }
 
-            void writeByte(std::uint16_t slave_address, std::uint8_t byte, I2CAdressingMode slave_addressing_mode = addressing_7)
+            I2CStatus writeByte(std::uint16_t slave_address, std::uint8_t byte, I2CAdressingMode slave_addressing_mode = addressing_7)
             {
-                I2C::prepareTransmit(slave_address, slave_addressing_mode);
-                I2C::generateStartCondition();
-                while (!I2C::getTransmitInterruptFlag());
-                *I2C::Usci::tx_buf = byte;
+                return writeBytes(slave_address, &byte, 1, slave_addressing_mode);
+            }
 
-                I2C::generateStopCondition();
+            I2CStatus writeBytes(std::uint16_t slave_address, const std::uint8_t* start, std::size_t bytes, I2CAdressingMode slave_addressing_mode = addressing_7)
+            {
+                m_timeout.start();
+                startWrite(slave_address, slave_addressing_mode);
+                I2CStatus status = send(start, bytes);
+                if (status == I2CStatus::ok)
+                    status = stopAfterTransmit();
+                return status;
             }
 
-            void writeBytes(std::uint16_t slave_address, std::uint8_t* start, std::size_t bytes, I2CAdressingMode slave_addressing_mode = addressing_7)
+            /// \brief Write the low byte first.
+            I2CStatus writeWord(std::uint16_t slave_address, std::uint16_t word, I2CAdressingMode slave_addressing_mode = addressing_7)
             {
-                I2C::prepareTransmit(slave_address, slave_addressing_mode);
+                const std::uint8_t bytes[] = {static_cast<std::uint8_t>(word & 0x00ff),
+                                              static_cast<std::uint8_t>((word & 0xff00) >> 8)};
+                return writeBytes(slave_address, bytes, 2, slave_addressing_mode);
+            }
+
+            /// \brief Start a write whose bytes are passed one by one. Each call of the burst is bounded by the timeout.
+            void startBurstWrite(std::uint16_t slave_address, I2CAdressingMode slave_addressing_mode = addressing_7)
+            {
+                startWrite(slave_address, slave_addressing_mode);
+            }
+
+            I2CStatus burstWrite(std::uint8_t byte)
+            {
+                m_timeout.start();
+                return send(&byte, 1);
+            }
+
+            I2CStatus stopBurstWrite()
+            {
+                m_timeout.start();
+                return stopAfterTransmit();
+            }
+
+            I2CStatus writeRegister(std::uint16_t slave_address, std::uint8_t reg_addr, const std::uint8_t* data_start, std::size_t count, I2CAdressingMode slave_addressing_mode = addressing_7)
+            {
+                m_timeout.start();
+                startWrite(slave_address, slave_addressing_mode);
+                I2CStatus status = send(&reg_addr, 1);
+                if (status == I2CStatus::ok)
+                    status = send(data_start, count);
+                if (status == I2CStatus::ok)
+                    status = stopAfterTransmit();
+                return status;
+            }
+
+            /// \brief Read count bytes starting at a register into the internal buffer.
+            I2CStatus readRegister(std::uint16_t slave_address, std::uint8_t reg_addr, std::size_t count, I2CAdressingMode slave_addressing_mode = addressing_7)
+            {
+                return transfer(slave_address, &reg_addr, 1, count, [this](std::uint8_t byte) { buffer.insert(byte); },
+                                slave_addressing_mode);
+            }
+
+            /// \brief Read count bytes starting at a register directly into data, e.g. a whole sensor frame at once.
+            I2CStatus readRegister(std::uint16_t slave_address, std::uint8_t reg_addr, std::uint8_t* data, std::size_t count, I2CAdressingMode slave_addressing_mode = addressing_7)
+            {
+                return writeRead(slave_address, &reg_addr, 1, data, count, slave_addressing_mode);
+            }
+
+            /// \brief Write tx_length bytes, then read rx_length bytes into rx after a repeated start.
+            ///
+            /// Either part may be empty. The received bytes are stored directly, without a copy through the buffer.
+            I2CStatus writeRead(std::uint16_t slave_address, const std::uint8_t* tx, std::size_t tx_length, std::uint8_t* rx, std::size_t rx_length, I2CAdressingMode slave_addressing_mode = addressing_7)
+            {
+                return transfer(slave_address, tx, tx_length, rx_length, [&rx](std::uint8_t byte) { *rx++ = byte; },
+                                slave_addressing_mode);
+            }
+
+            /// \brief Free the bus from a slave which holds SDA low, see I2C_t::recoverBus().
+            static void recoverBus()
+            {
+                I2C::recoverBus();
+            }
+
+        private:
+            template<typename Store>
+            I2CStatus transfer(std::uint16_t slave_address, const std::uint8_t* tx, std::size_t tx_length, std::size_t rx_length, Store store, I2CAdressingMode slave_addressing_mode)
+            {
+                m_timeout.start();
+                I2CStatus status;
+                if (tx_length > 0 || rx_length == 0)
+                {
+                    startWrite(slave_address, slave_addressing_mode);
+                    status = send(tx, tx_length);
+                    if (status != I2CStatus::ok || rx_length == 0)
+                        return (status == I2CStatus::ok) ? stopAfterTransmit() : status;
+                    // The repeated start follows as soon as the last byte was acknowledged
+                    status = waitUntil([] { return I2C::getTransmitInterruptFlag(); });
+                    if (status != I2CStatus::ok)
+                        return status;
+                    *Usci::ifg &= ~UCB0TXIFG;
+                    I2C::setMode(I2CMode::receive);
+                }
+                else
+                    I2C::prepareReceive(slave_address, slave_addressing_mode);
                 I2C::generateStartCondition();
-                std::size_t index = 0;
-                while (index < bytes)
+
+                if (rx_length == 1)
                 {
-                    while(!I2C::getTransmitInterruptFlag());
-                    *I2C::Usci::tx_buf = *(start + index);
-                    ++index;
+                    // No RXIFG precedes a single byte, so STOP goes out once the slave acknowledged its address
+                    status = waitUntil([] { return !I2C::getStartCondition(); });
+                    if (status != I2CStatus::ok)
+                        return status;
+                    I2C::generateStopCondition();
                 }
-                I2C::generateStopCondition();
+                for (std::size_t read = 0; read < rx_length; ++read)
+                {
+                    status = waitUntil([] { return I2C::getReceiveInterruptFlag(); });
+                    if (status != I2CStatus::ok)
+                        return status;
+                    // The last byte is clocked in once this one is read, it must see STOP already
+                    if (read + 2 == rx_length)
+                        I2C::generateStopCondition();
+                    store(*Usci::rx_buf);
+                }
+                return waitForStop();
             }
 
-            void writeWord(std::uint16_t slave_address, std::uint16_t word, I2CAdressingMode slave_addressing_mode = addressing_7)
+            void startWrite(std::uint16_t slave_address, I2CAdressingMode slave_addressing_mode)
             {
                 I2C::prepareTransmit(slave_address, slave_addressing_mode);
                 I2C::generateStartCondition();
-                while (!I2C::getTransmitInterruptFlag());
-                *I2C::Usci::tx_buf = static_cast<std::uint8_t>(word & 0x00ff);
-                while (!I2C::getTransmitInterruptFlag());
-                *I2C::Usci::tx_buf = static_cast<std::uint8_t>(word & 0xff00 >> 8);
+            }
+
+            I2CStatus send(const std::uint8_t* data, std::size_t count)
+            {
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    I2CStatus status = waitUntil([] { return I2C::getTransmitInterruptFlag(); });
+                    if (status != I2CStatus::ok)
+                        return status;
+                    *Usci::tx_buf = data[index];
+                }
+                return I2CStatus::ok;
+            }
+
+            I2CStatus stopAfterTransmit()
+            {
+                // STOP follows the byte in the shift register, the one in TXBUF would be lost
+                I2CStatus status = waitUntil([] { return I2C::getTransmitInterruptFlag(); });
+                if (status != I2CStatus::ok)
+                    return status;
                 I2C::generateStopCondition();
+                *Usci::ifg &= ~UCB0TXIFG;
+                status = waitForStop();
+                // The last byte may still be rejected
+                if (status == I2CStatus::ok && (*Usci::stat & UCNACKIFG))
+                {
+                    *Usci::stat &= ~UCNACKIFG;
+                    status = I2CStatus::nack;
+                }
+                return status;
+            }
+
+            /// \brief Wait for the USCI, unless the slave rejected a byte, the arbitration was lost or the deadline
+            /// expired.
+            template<typename Condition>
+            I2CStatus waitUntil(Condition done)
+            {
+                while (!done())
+                {
+                    std::uint8_t state = *Usci::stat;
+                    if (state & UCALIFG)
+                    {
+                        // Losing the arbitration switches the USCI to slave mode
+                        *Usci::stat &= ~UCALIFG;
+                        *Usci::ctl_0 |= UCMST;
+                        return I2CStatus::arbitration_lost;
+                    }
+                    if (state & UCNACKIFG)
+                    {
+                        I2C::generateStopCondition();
+                        *Usci::stat &= ~UCNACKIFG;
+                        *Usci::ifg &= ~UCB0TXIFG;
+                        I2CStatus status = waitForStop();
+                        return (status == I2CStatus::ok) ? I2CStatus::nack : status;
+                    }
+                    if (timedOut())
+                        return I2CStatus::timeout;
+                }
+                return I2CStatus::ok;
             }
 
+            I2CStatus waitForStop()
+            {
+                while (I2C::getStopCondition())
+                {
+                    if (timedOut())
+                        return I2CStatus::timeout;
+                }
+                return I2CStatus::ok;
+            }
 
-            void startBurstWrite(std::uint16_t slave_address, I2CAdressingMode slave_addressing_mode = addressing_7)
+            /// \brief Recover the bus if the deadline expired. Without a deadline the bus recovery is not needed.
+            bool timedOut()
             {
-                I2C::prepareTransmit(slave_address, slave_addressing_mode);
-                I2C::generateStartCondition();
+                if constexpr (std::is_same_v<Timeout, I2CNoTimeout>)
+                    return false;
+                else
+                {
+                    if (!m_timeout.expired())
+                        return false;
+                    recoverBus();
+                    return true;
+                }
+            }
+
+            Timeout m_timeout;
+        };
+
+        enum class I2CTransactionStatus : std::uint8_t
+        {
+            idle, ///< Not submitted yet, or rejected because the queue was full.
+            pending, ///< Waiting in the queue.
+            active, ///< Currently transferred.
+            complete, ///< All bytes were transferred.
+            nack, ///< The slave did not acknowledge its address or a byte, the transfer was stopped.
+            arbitration_lost, ///< Another master won the bus, the transfer was abandoned.
+            timeout ///< The transfer did not finish in time, the bus was recovered.
+        };
+
+        struct I2CTransaction;
+
+        /// \brief Called from the ISR (or from AsyncI2CMaster::service()) when a transaction finished. May submit
+        /// further transactions.
+        using I2CCompletionCallback = void (*)(I2CTransaction& transaction);
+
+        /// \brief A transfer to one slave, which is queued by AsyncI2CMaster.
+        ///
+        /// The tx bytes are written first. If rx bytes are requested as well, they are read after a repeated start,
+        /// e.g. a register address followed by the register contents. The transaction and its buffers are used in
+        /// place, so they must stay valid until the transaction finished.
+        struct I2CTransaction
+        {
+            /// \brief The 7 bit slave address.
+            std::uint8_t address;
+            const std::uint8_t* tx;
+            std::size_t tx_length;
+            std::uint8_t* rx;
+            std::size_t rx_length;
+            I2CCompletionCallback on_complete = nullptr;
+            /// \brief Free for use by the callback.
+            void* context = nullptr;
+            volatile I2CTransactionStatus status = I2CTransactionStatus::idle;
+        };
+
+        /// \brief Interrupt driven I2C master which runs queued transactions.
+        ///
+        /// Address, data, repeated START and STOP are driven by the USCI interrupts, so the CPU is free to sleep or
+        /// compute during the bus traffic. Received bytes are stored directly into the buffer of the transaction and
+        /// STOP is requested while the last byte is received, so it is not acknowledged. A transaction finishes as soon
+        /// as its last byte was read, or written and STOP was requested; a NACK of the last written byte is therefore
+        /// not reported. The ISRs never wait for the bus.
+        ///
+        /// A few steps have no interrupt of their own and are done by service(), which has to be called periodically
+        /// from the main loop:
+        /// - The START of a transaction which was queued behind another one waits until the STOP of the previous one was
+        ///   generated and the bus is free, which is also the case after a lost arbitration until the other master
+        ///   released the bus.
+        /// - A single byte read needs STOP while its only byte is received. service() generates its START and waits
+        ///   with disabled interrupts until the slave acknowledged the address, about ten SCL periods.
+        /// - An address probe without data completes once its STOP was generated without a NACK.
+        ///
+        /// With I2CTimeout every transaction is bounded in time. service() checks the deadline as well, since a slave
+        /// which holds SCL low causes no interrupt at all. An expired transaction ends with status timeout, the bus is
+        /// recovered by service() outside the ISRs and with interrupts enabled.
+        ///
+        /// The vectors are shared with USCI_A, hence the driver does not define the ISRs itself. Call
+        /// handleDataInterrupt() from the USCIAB0TX (USCIAB1TX) vector and handleStateInterrupt() from the USCIAB0RX
+        /// (USCIAB1RX) vector.
+        ///
+        /// \tparam I2C A configured I2C_t in master mode.
+        /// \tparam max_transactions The number of transactions which can wait, must be a power of two.
+        /// \tparam Timeout I2CNoTimeout or I2CTimeout.
+        template<typename I2C, std::size_t max_transactions, typename Timeout = I2CNoTimeout>
+        struct AsyncI2CMaster
+        {
+            using Usci = typename I2C::Usci;
+
+            static_assert(I2C::master_mode_value, "The I2C module has to be configured as master");
+
+            /// \brief Configure the USCI and enable the NACK and arbitration lost interrupts.
+            void init()
+            {
+                I2C::init();
+                I2C::enable();
+                *I2C::i2cie = UCNACKIE | UCALIE;
             }
 
-            void burstWrite(std::uint8_t byte)
+            /// \brief Append a transaction to the queue, it is started immediately if the bus is idle.
+            ///
+            /// \return false if the queue is full.
+            bool submit(I2CTransaction& transaction)
             {
-                while (!I2C::getTransmitInterruptFlag());
-                *I2C::Usci::tx_buf = byte;
+                multitasking::InterruptGuard guard;
+                if (m_queue.full())
+                    return false;
+                transaction.status = I2CTransactionStatus::pending;
+                m_queue.insert(&transaction);
+                if (m_active == nullptr)
+                    startNext();
+                return true;
             }
 
-            void stopBurstWrite()
+            /// \brief Have all submitted transactions finished?
+            bool idle() const
             {
+                return m_active == nullptr;
+            }
+
+            /// \brief The number of transactions which wait in the queue, not counting the active one.
+            std::size_t pending() const
+            {
+                return m_queue.size();
+            }
+
+            /// \brief Do the steps of the active transaction which have no interrupt and end it if its deadline expired.
+            ///
+            /// Call it periodically from the main loop, not from an ISR. The bus is recovered with I2C_t::recoverBus()
+            /// and the callback of the transaction is called from here, both with interrupts enabled. Afterwards the
+            /// next transaction is started.
+            ///
+            /// \return true if a transaction was ended.
+            bool service()
+            {
+                I2CTransactionStatus status;
+                {
+                    multitasking::InterruptGuard guard;
+                    if (m_active == nullptr)
+                        return false;
+                    if (m_wait != Wait::recovery && expired())
+                        stopInterrupts();
+                    switch (m_wait)
+                    {
+                        case Wait::bus:
+                            start();
+                            return false;
+                        case Wait::address:
+                            receiveSingle();
+                            if (m_wait != Wait::recovery)
+                                return false;
+                            status = I2CTransactionStatus::timeout;
+                            break;
+                        case Wait::stop:
+                            // A pending NACK is handled by handleStateInterrupt() once the guard ends
+                            if (I2C::getStopCondition() || (*Usci::stat & (UCBBUSY | UCNACKIFG)))
+                                return false;
+                            status = I2CTransactionStatus::complete;
+                            break;
+                        case Wait::recovery:
+                            status = I2CTransactionStatus::timeout;
+                            break;
+                        default:
+                            return false;
+                    }
+                }
+                // The ISRs of the USCI are disabled during the recovery
+                if (status == I2CTransactionStatus::timeout)
+                    recover();
+                return finish(status);
+            }
+
+            /// \brief Must be called from the transmit ISR of the USCI, which serves the data flags in I2C mode.
+            ///
+            /// \return true if a transaction finished, e.g. to wake up the CPU on exit of the ISR.
+            bool handleDataInterrupt()
+            {
+                I2CTransaction* transaction = m_active;
+                if (transaction == nullptr || m_wait != Wait::none)
+                {
+                    // TXIFG stays set while TXBUF is empty
+                    *Usci::ifg &= ~UCB0TXIFG;
+                    return false;
+                }
+
+                if (Usci::isRxInterruptPending())
+                {
+                    // Reading RXBUF releases SCL for the next byte, so STOP is requested before
+                    if (m_rx_index + 2 == transaction->rx_length)
+                        I2C::generateStopCondition();
+                    transaction->rx[m_rx_index++] = *Usci::rx_buf;
+                    if (m_rx_index < transaction->rx_length)
+                        return false;
+                    return finish(I2CTransactionStatus::complete);
+                }
+
+                if (!Usci::isTxInterruptPending())
+                    return false;
+                if (m_tx_index < transaction->tx_length)
+                {
+                    *Usci::tx_buf = transaction->tx[m_tx_index++];
+                    return false;
+                }
+                // The last byte is shifted, TXIFG is not cleared by the hardware if TXBUF stays empty. The USCI holds
+                // SCL low after it until the repeated START or STOP is requested.
+                *Usci::ifg &= ~UCB0TXIFG;
+                if (transaction->rx_length == 1)
+                {
+                    m_wait = Wait::address;
+                    return false;
+                }
+                if (transaction->rx_length > 0)
+                {
+                    I2C::setMode(I2CMode::receive);
+                    I2C::generateStartCondition();
+                    return false;
+                }
                 I2C::generateStopCondition();
+                if (transaction->tx_length == 0)
+                {
+                    // An address probe: TXIFG was set by the START, the address may still be rejected
+                    m_wait = Wait::stop;
+                    return false;
+                }
+                return finish(I2CTransactionStatus::complete);
             }
 
-            void writeRegister(std::uint16_t slave_address, std::uint8_t reg_addr, std::uint8_t* data_start, std::size_t count, I2CAdressingMode slave_addressing_mode = addressing_7)
+            /// \brief Must be called from the receive ISR of the USCI, which serves the state flags in I2C mode.
+            ///
+            /// \return true if a transaction finished, e.g. to wake up the CPU on exit of the ISR.
+            bool handleStateInterrupt()
             {
-                I2C::prepareTransmit(slave_address, slave_addressing_mode);
-                I2C::generateStartCondition();
-                while (!I2C::getTransmitInterruptFlag());
-                *I2C::Usci::tx_buf = reg_addr;
+                std::uint8_t state = *Usci::stat;
+                if (state & UCALIFG)
+                {
+                    // Losing the arbitration switches the USCI to slave mode, no STOP is generated. start() switches
+                    // back once the other master released the bus.
+                    *Usci::stat &= ~UCALIFG;
+                    *Usci::ifg &= ~UCB0TXIFG;
+                    return started() && finish(I2CTransactionStatus::arbitration_lost);
+                }
+                if (state & UCNACKIFG)
+                {
+                    // A NACK of the last byte of a finished write arrives while the next transaction waits for the bus
+                    *Usci::stat &= ~UCNACKIFG;
+                    if (!started())
+                        return false;
+                    I2C::generateStopCondition();
+                    *Usci::ifg &= ~UCB0TXIFG;
+                    return finish(I2CTransactionStatus::nack);
+                }
+                return false;
+            }
+
+        private:
+            /// \brief What the active transaction waits for.
+            enum class Wait : std::uint8_t
+            {
+                none, ///< The USCI interrupts drive the transaction.
+                bus, ///< The START waits until the previous STOP was generated and the bus is free.
+                address, ///< A single byte read waits for service() to generate START and STOP.
+                stop, ///< An address probe completes once its STOP was generated without a NACK.
+                recovery ///< The deadline expired, service() recovers the bus.
+            };
 
-                std::size_t index = 0;
-                while (index < count)
+            void startNext()
+            {
+                I2CTransaction* transaction;
+                if (!m_queue.get(transaction))
                 {
-                    while(!I2C::getTransmitInterruptFlag());
-                    *I2C::Usci::tx_buf = *(data_start + index);
-                    ++index;
+                    Usci::disableInterrupts();
+                    return;
                 }
+                m_active = transaction;
+                m_tx_index = 0;
+                m_rx_index = 0;
+                transaction->status = I2CTransactionStatus::active;
+                m_timeout.start();
+                start();
             }
 
-            void readRegister(std::uint16_t slave_address, std::uint8_t reg_addr, std::size_t count, I2CAdressingMode slave_addressing_mode = addressing_7)
+            /// \brief Generate the START of the active transaction, or leave it to service() while the bus is busy.
+            void start()
             {
-                I2C::prepareTransmit(slave_address, slave_addressing_mode);
-                I2C::generateStartCondition();
-                while (!I2C::getTransmitInterruptFlag());
-                *I2C::Usci::tx_buf = reg_addr;
-                I2C::setMode(I2CMode::receive);
-                std::size_t read = 0;
-                if (count == 1)
+                if (I2C::getStopCondition() || (*Usci::stat & UCBBUSY))
+                {
+                    m_wait = Wait::bus;
+                    return;
+                }
+                m_wait = Wait::none;
+                if (!(*Usci::ctl_0 & UCMST))
+                {
+                    // A lost arbitration switched the USCI to slave mode, UCMST may only be changed in reset
+                    Usci::disableModule();
+                    *Usci::ctl_0 |= UCMST;
+                    Usci::enableModule();
+                    *I2C::i2cie = UCNACKIE | UCALIE;
+                }
+                const I2CTransaction& transaction = *m_active;
+                *I2C::i2csa = transaction.address;
+                Usci::enableInterrupts();
+                if (transaction.tx_length > 0 || transaction.rx_length == 0)
+                {
+                    // TXIFG is set as soon as the start condition was generated
+                    I2C::setMode(I2CMode::transmit);
+                    I2C::generateStartCondition();
+                }
+                else if (transaction.rx_length == 1)
+                    m_wait = Wait::address;
+                else
                 {
+                    I2C::setMode(I2CMode::receive);
                     I2C::generateStartCondition();
-                    while (I2C::getStartCondition());
+                }
+            }
+
+            /// \brief Has the active transaction generated its START, i.e. do the state flags belong to it?
+            bool started() const
+            {
+                return m_active != nullptr && m_wait != Wait::bus && m_wait != Wait::recovery;
+            }
+
+            /// \brief Generate START and STOP of a single byte read. Must be called with disabled interrupts.
+            ///
+            /// STOP has to be requested while the only byte is received, i.e. after the address was acknowledged.
+            void receiveSingle()
+            {
+                m_wait = Wait::none;
+                I2C::setMode(I2CMode::receive);
+                I2C::generateStartCondition();
+                while (I2C::getStartCondition() && !(*Usci::stat & (UCNACKIFG | UCALIFG)))
+                {
+                    if (expired())
+                    {
+                        stopInterrupts();
+                        return;
+                    }
+                }
+                // A NACK or a lost arbitration is handled by handleStateInterrupt()
+                if (!(*Usci::stat & (UCNACKIFG | UCALIFG)))
                     I2C::generateStopCondition();
+            }
+
+            bool expired() const
+            {
+                if constexpr (std::is_same_v<Timeout, I2CNoTimeout>)
+                    return false;
+                else
+                    return m_timeout.expired();
+            }
+
+            /// \brief Keep the ISRs away from the USCI until service() recovered the bus.
+            void stopInterrupts()
+            {
+                Usci::disableInterrupts();
+                *I2C::i2cie = 0;
+                m_wait = Wait::recovery;
+            }
+
+            /// \brief Free the bus after a timeout.
+            void recover()
+            {
+                if constexpr (!std::is_same_v<Timeout, I2CNoTimeout>)
+                {
+                    I2C::recoverBus();
+                    I2C::enable();
+                    *I2C::i2cie = UCNACKIE | UCALIE;
                 }
-                while (read < count)
+            }
+
+            bool finish(I2CTransactionStatus status)
+            {
+                I2CTransaction* transaction = m_active;
+                transaction->status = status;
+                m_wait = Wait::none;
+                m_active = nullptr;
+                if (transaction->on_complete != nullptr)
+                    transaction->on_complete(*transaction);
+                // The callback, or an ISR while service() called it, may have started the next transaction already
+                multitasking::InterruptGuard guard;
+                if (m_active == nullptr)
+                    startNext();
+                return true;
+            }
+
+            memory::ring_buffer<I2CTransaction*, max_transactions> m_queue;
+            I2CTransaction* volatile m_active = nullptr;
+            std::size_t m_tx_index = 0;
+            std::size_t m_rx_index = 0;
+            volatile Wait m_wait = Wait::none;
+            Timeout m_timeout;
+        };
+
+        /// \brief Called from the ISR when an external master addressed the slave.
+        ///
+        /// \param read True if the master reads.
+        using I2CSlaveStartCallback = void (*)(bool read);
+
+        /// \brief Called from the ISR at the stop condition.
+        ///
+        /// \param first_register The register the master started writing to.
+        /// \param written The number of data bytes the master wrote, 0 for a pure read.
+        using I2CSlaveStopCallback = void (*)(std::uint8_t first_register, std::uint8_t written);
+
+        /// \brief Interrupt driven I2C slave which emulates a register file, like most I2C sensors do.
+        ///
+        /// The first byte the master writes after its address sets the register pointer, further bytes are written
+        /// to the registers, restricted to the bits set in write_mask. Reads start at the register pointer. The pointer
+        /// increments with every byte and wraps at the end of the map, a pointer beyond the map starts at register 0.
+        ///
+        /// TXBUF is refilled from the map as soon as the previous byte moved into the shift register, so the master
+        /// finds the next byte ready and SCL is only held low for the first byte of a read, until the ISR wrote it.
+        /// The byte left in TXBUF after the master stopped reading is not counted, the pointer stays behind the last
+        /// byte the master got.
+        ///
+        /// The vectors are shared with USCI_A, hence the driver does not define the ISRs itself. Call
+        /// handleDataInterrupt() from the USCIAB0TX (USCIAB1TX) vector and handleStateInterrupt() from the USCIAB0RX
+        /// (USCIAB1RX) vector.
+        ///
+        /// \tparam I2C A configured I2C_t in slave mode with its own address.
+        /// \tparam register_count The size of the register map.
+        template<typename I2C, std::uint8_t register_count>
+        struct I2CRegisterSlave
+        {
+            using Usci = typename I2C::Usci;
+
+            static_assert(!I2C::master_mode_value, "The I2C module has to be configured as slave");
+            static_assert(register_count > 0, "The register map must not be empty");
+
+            /// \brief The register file. Values which span several registers should be updated with interrupts
+            /// disabled, so a master never reads half of an update.
+            volatile std::uint8_t registers[register_count] = {};
+
+            /// \brief The bits of each register the master may change, 0x00 makes a register read only. All
+            /// registers are writable by default.
+            std::uint8_t write_mask[register_count];
+
+            explicit I2CRegisterSlave(I2CSlaveStartCallback on_start = nullptr, I2CSlaveStopCallback on_stop = nullptr)
+                : m_on_start(on_start), m_on_stop(on_stop)
+            {
+                for (std::uint8_t& mask : write_mask)
+                    mask = 0xff;
+            }
+
+            /// \brief Configure the USCI and start listening to the own address.
+            void init()
+            {
+                I2C::init();
+                I2C::enable();
+                *I2C::i2cie = UCSTTIE | UCSTPIE;
+                Usci::enableInterrupts();
+            }
+
+            /// \brief The register the next byte is read from or written to.
+            std::uint8_t pointer() const
+            {
+                return m_pointer;
+            }
+
+            /// \brief Must be called from the transmit ISR of the USCI, which serves the data flags in I2C mode.
+            ///
+            /// \return true if a transfer ended, e.g. to wake up the CPU on exit of the ISR.
+            bool handleDataInterrupt()
+            {
+                // A received byte always precedes the flags, a byte to transmit always follows them
+                receive();
+                bool wake = serveConditions();
+                if (Usci::isTxInterruptPending())
                 {
-                    while (!I2C::getReceiveInterruptFlag());
-                    buffer.insert(*I2C::Usci::rx_buf);
-                    ++count;
+                    // The previous byte moved into the shift register, so the master gets it
+                    if (m_loaded)
+                        m_pointer = next(m_pointer);
+                    *Usci::tx_buf = registers[m_pointer];
+                    m_loaded = true;
                 }
-                I2C::generateStopCondition();
+                return wake;
+            }
+
+            /// \brief Must be called from the receive ISR of the USCI, which serves the state flags in I2C mode.
+            ///
+            /// \return true if a transfer ended, e.g. to wake up the CPU on exit of the ISR.
+            bool handleStateInterrupt()
+            {
+                receive();
+                return serveConditions();
+            }
+
+        private:
+            static std::uint8_t next(std::uint8_t pointer)
+            {
+                return (pointer + 1 < register_count) ? pointer + 1 : 0;
+            }
+
+            void receive()
+            {
+                if (!Usci::isRxInterruptPending())
+                    return;
+                std::uint8_t byte = *Usci::rx_buf;
+                if (m_pointer_pending)
+                {
+                    m_pointer = (byte < register_count) ? byte : 0;
+                    m_first_written = m_pointer;
+                    m_pointer_pending = false;
+                }
+                else
+                {
+                    std::uint8_t mask = write_mask[m_pointer];
+                    registers[m_pointer] = (registers[m_pointer] & ~mask) | (byte & mask);
+                    m_pointer = next(m_pointer);
+                    ++m_written;
+                }
+            }
+
+            /// \brief Serve the stop condition of the last transfer before the start condition of the next one.
+            bool serveConditions()
+            {
+                std::uint8_t state = *Usci::stat;
+                bool wake = false;
+                if (state & UCSTPIFG)
+                {
+                    *Usci::stat &= ~UCSTPIFG;
+                    endRead();
+                    if (m_on_stop != nullptr)
+                        m_on_stop(m_first_written, m_written);
+                    m_written = 0;
+                    wake = true;
+                }
+                if (state & UCSTTIFG)
+                {
+                    *Usci::stat &= ~UCSTTIFG;
+                    // A repeated start may end a read as well
+                    endRead();
+                    bool read = *Usci::ctl_1 & UCTR;
+                    if (!read)
+                    {
+                        m_pointer_pending = true;
+                        m_written = 0;
+                    }
+                    if (m_on_start != nullptr)
+                        m_on_start(read);
+                }
+                return wake;
+            }
+
+            /// \brief The byte which was left in TXBUF was never sent, the pointer stays at it.
+            void endRead()
+            {
+                m_loaded = false;
             }
 
+            I2CSlaveStartCallback m_on_start;
+            I2CSlaveStopCallback m_on_stop;
+            std::uint8_t m_pointer = 0;
+            std::uint8_t m_first_written = 0;
+            std::uint8_t m_written = 0;
+            bool m_pointer_pending = false;
+            bool m_loaded = false;
         };
     }
 }
 
-#endif //IR_TRAIN_DETECTOR_I2C_H
+#endif //MSP430HAL_USCI_I2C_H
@@ -2,8 +2,15 @@
 #define MSP430HAL_USCI_SPINTERFACE_H
 
 #include <msp430.h>
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <tuple>
+#include <utility>
 #include "usci.h"
+#include "../gpio/pin.h"
+#include "../memory/ring_buffer.h"
+#include "../multitasking/interrupt_guard.h"
 
 namespace msp430hal::usci
 {
@@ -33,6 +40,27 @@ namespace msp430hal::usci
         active_low_trailing_edge = 0xc0
     };
 
+    /// \brief The port pins of a USCI module in SPI mode.
+    ///
+    /// Only the modules of USCI_AB0 are mapped, all of them are on port 1 of the MSP430G2553. The pins of USCI_AB1
+    /// depend on the device and have to be configured by the application.
+    template<UsciModule module, std::uint_fast8_t instance, SPIMode mode>
+    struct SPIPins
+    {
+        static constexpr bool four_pin = (mode & 0x06) != 0;
+        static constexpr std::uint8_t data_pins = (module == UsciModule::usci_a) ? (gpio::p_1 | gpio::p_2 | gpio::p_4)
+                                                                                  : (gpio::p_5 | gpio::p_6 | gpio::p_7);
+        static constexpr std::uint8_t ste_pin = (module == UsciModule::usci_a) ? gpio::p_5 : gpio::p_4;
+        static constexpr std::uint8_t pins_value = four_pin ? (data_pins | ste_pin) : data_pins;
+
+        /// \brief Connect SIMO, SOMI, CLK and in 4-pin mode STE to the USCI.
+        static void init()
+        {
+            if constexpr (instance == 0)
+                gpio::GPIOPins<gpio::port_1, pins_value>::switchFunction(gpio::PinFunction::secondary_peripheral);
+        }
+    };
+
     template<UsciModule module,
             std::uint_fast8_t instance,
             SPIMode mode = master_3pin,
@@ -60,7 +88,7 @@ namespace msp430hal::usci
             *Usci::ctl_1 |= clock_source;
             *Usci::br_0 = (std::uint8_t) (0x00ff & pre_scale_factor);
             *Usci::br_1 = (std::uint8_t) ((0xff00 & pre_scale_factor) >> 8);
-            // TODO configure ports
+            SPIPins<module, instance, mode>::init();
 
             Usci::enableModule();
         }
@@ -102,6 +130,103 @@ namespace msp430hal::usci
             return readOverrunError();
         }
 
+        /// \brief Is a character being shifted or waiting in the transmit buffer?
+        static bool busy()
+        {
+            return *Usci::stat & UCBUSY;
+        }
+
+        /// \brief Exchange a single character, waits until it was shifted completely.
+        static std::uint8_t transfer(std::uint8_t data)
+        {
+            while (!Usci::isTxInterruptPending());
+            *Usci::tx_buf = data;
+            while (!Usci::isRxInterruptPending());
+            return *Usci::rx_buf;
+        }
+
+        /// \brief Full duplex block transfer.
+        ///
+        /// The transmit buffer is loaded with the next character while the previous one is still shifted, and the
+        /// received character is read afterwards, so the clock runs without gaps between the characters. The received
+        /// character has to be read within one character time. At prescaler 1 that is not possible, the characters are
+        /// exchanged one at a time like with transfer(data) then.
+        ///
+        /// \param tx The characters to send.
+        /// \param rx Receives the characters, may be the same buffer as tx.
+        /// \param length The number of characters to exchange.
+        static void transfer(const std::uint8_t* tx, std::uint8_t* rx, std::size_t length)
+        {
+            if constexpr (pre_scale_factor < 2)
+            {
+                for (std::size_t i = 0; i < length; ++i)
+                    rx[i] = transfer(tx[i]);
+                return;
+            }
+            if (length == 0)
+                return;
+            while (!Usci::isTxInterruptPending());
+            *Usci::tx_buf = *tx++;
+            for (std::size_t i = 1; i < length; ++i)
+            {
+                while (!Usci::isTxInterruptPending());
+                *Usci::tx_buf = *tx++;
+                while (!Usci::isRxInterruptPending());
+                *rx++ = *Usci::rx_buf;
+            }
+            while (!Usci::isRxInterruptPending());
+            *rx = *Usci::rx_buf;
+        }
+
+        /// \brief Receive a block while sending a constant character, e.g. 0xff for SD cards.
+        ///
+        /// Keeps two characters in flight like the full duplex block transfer, one at a time at prescaler 1.
+        ///
+        /// \param rx Receives the characters.
+        /// \param length The number of characters to receive.
+        /// \param fill The character sent for every received one.
+        static void read(std::uint8_t* rx, std::size_t length, std::uint8_t fill = 0xff)
+        {
+            if constexpr (pre_scale_factor < 2)
+            {
+                for (std::size_t i = 0; i < length; ++i)
+                    rx[i] = transfer(fill);
+                return;
+            }
+            if (length == 0)
+                return;
+            while (!Usci::isTxInterruptPending());
+            *Usci::tx_buf = fill;
+            for (std::size_t i = 1; i < length; ++i)
+            {
+                while (!Usci::isTxInterruptPending());
+                *Usci::tx_buf = fill;
+                while (!Usci::isRxInterruptPending());
+                *rx++ = *Usci::rx_buf;
+            }
+            while (!Usci::isRxInterruptPending());
+            *rx = *Usci::rx_buf;
+        }
+
+        /// \brief Send a block and discard the received characters.
+        ///
+        /// Only the transmit buffer is served, which is the fastest way to feed e.g. a display. Returns after the last
+        /// character was shifted completely, so the chip select can be released right away. The receive buffer is read
+        /// once at the end to clear the receive flag and the overrun error caused by the skipped characters.
+        ///
+        /// \param tx The characters to send.
+        /// \param length The number of characters to send.
+        static void write(const std::uint8_t* tx, std::size_t length)
+        {
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                while (!Usci::isTxInterruptPending());
+                *Usci::tx_buf = tx[i];
+            }
+            while (busy());
+            [[maybe_unused]] std::uint8_t discarded = *Usci::rx_buf;
+        }
+
         static void enable()
         {
             Usci::enableModule();
@@ -112,6 +237,674 @@ namespace msp430hal::usci
             Usci::disableModule();
         }
     };
+
+    /// \brief Compile time description of a device on a shared SPI bus.
+    ///
+    /// \tparam ChipSelectPin An output GPIOPin which selects the device.
+    /// \tparam chip_select_active_high The chip select is active low unless stated otherwise.
+    template<typename ChipSelectPin,
+             SPIClockMode clock_mode = active_high_leading_edge,
+             SPICharacterFormat format = msb_8bit,
+             std::uint16_t pre_scale_factor = 1,
+             bool chip_select_active_high = false>
+    struct SPIDevice
+    {
+        using ChipSelect = ChipSelectPin;
+
+        static constexpr SPIClockMode clock_mode_value = clock_mode;
+        static constexpr SPICharacterFormat format_value = format;
+        static constexpr std::uint16_t pre_scale_factor_value = pre_scale_factor;
+        static constexpr bool chip_select_active_high_value = chip_select_active_high;
+
+        static_assert(ChipSelectPin::mode_value == gpio::Mode::output, "The chip select has to be an output");
+        static_assert(pre_scale_factor > 0, "The prescaler must not be zero");
+
+        static constexpr std::uint8_t ctl_0_value = clock_mode | format | master_3pin | 0x01;
+        static constexpr std::uint8_t br_0_value = static_cast<std::uint8_t>(pre_scale_factor & 0x00ff);
+        static constexpr std::uint8_t br_1_value = static_cast<std::uint8_t>(pre_scale_factor >> 8);
+
+        static void select()
+        {
+            if constexpr (chip_select_active_high)
+                ChipSelectPin::set();
+            else
+                ChipSelectPin::clear();
+        }
+
+        static void release()
+        {
+            if constexpr (chip_select_active_high)
+                ChipSelectPin::clear();
+            else
+                ChipSelectPin::set();
+        }
+    };
+
+    /// \brief SPI master shared by several devices with different settings.
+    ///
+    /// select() reconfigures the USCI for the device, but only writes the registers whose values differ between the
+    /// previously selected and the new device. The differences are calculated at compile time for every pair of
+    /// devices; only the index of the current device is kept at run time. Selecting a device with the settings of the
+    /// current one costs no register access besides its chip select.
+    ///
+    /// A reconfiguration puts the USCI into reset, which clears its interrupt enable bits, so the bus is meant for
+    /// blocking transfers. The chip select of the previous device must be released before another device is selected.
+    ///
+    /// \tparam Devices The SPIDevice descriptors of all devices on the bus.
+    template<UsciModule module, std::uint_fast8_t instance, UsciClockSource clock_source, typename... Devices>
+    struct SharedSPIBus
+    {
+        static_assert(sizeof...(Devices) > 0, "At least one device is required");
+
+        using Usci = Usci_t<module, instance>;
+        /// \brief The data path, which is independent of the device settings besides the prescaler of the fastest
+        /// device, which decides whether the block transfers can keep two characters in flight.
+        using SPI = SPI_t<module, instance, master_3pin, msb_8bit, active_high_leading_edge, clock_source,
+                          std::min({Devices::pre_scale_factor_value...})>;
+
+        template<std::size_t index>
+        using Device = std::tuple_element_t<index, std::tuple<Devices...>>;
+
+        /// \brief Configure the pins of the bus and the chip selects, the USCI starts with the settings of the first device.
+        static void init()
+        {
+            (Devices::release(), ...);
+            (Devices::ChipSelect::init(gpio::PinFunction::io), ...);
+
+            using First = Device<0>;
+            Usci::disableModule();
+            *Usci::ctl_0 = First::ctl_0_value;
+            *Usci::ctl_1 = clock_source | UCSWRST;
+            *Usci::br_0 = First::br_0_value;
+            *Usci::br_1 = First::br_1_value;
+            SPIPins<module, instance, master_3pin>::init();
+            Usci::enableModule();
+            m_current = 0;
+        }
+
+        /// \brief Reconfigure the USCI for the device if necessary and assert its chip select.
+        template<typename Target>
+        static void select()
+        {
+            constexpr std::size_t target = indexOf<Target>();
+            if (m_current != target)
+            {
+                switchTo<Target>(std::index_sequence_for<Devices...>{});
+                m_current = target;
+            }
+            Target::select();
+        }
+
+        /// \brief Release the chip select of the device after the last character was shifted completely.
+        template<typename Target>
+        static void release()
+        {
+            while (SPI::busy());
+            Target::release();
+        }
+
+        /// \brief The index of the device the USCI is configured for.
+        static std::uint8_t current()
+        {
+            return m_current;
+        }
+
+        static std::uint8_t transfer(std::uint8_t data)
+        {
+            return SPI::transfer(data);
+        }
+
+        static void transfer(const std::uint8_t* tx, std::uint8_t* rx, std::size_t length)
+        {
+            SPI::transfer(tx, rx, length);
+        }
+
+        static void read(std::uint8_t* rx, std::size_t length, std::uint8_t fill = 0xff)
+        {
+            SPI::read(rx, length, fill);
+        }
+
+        static void write(const std::uint8_t* tx, std::size_t length)
+        {
+            SPI::write(tx, length);
+        }
+
+    private:
+        template<typename Target, std::size_t index = 0>
+        static constexpr std::size_t indexOf()
+        {
+            static_assert(index < sizeof...(Devices), "The device is not attached to this bus");
+            if constexpr (std::is_same_v<Target, Device<index>>)
+                return index;
+            else
+                return indexOf<Target, index + 1>();
+        }
+
+        template<typename Target, std::size_t... indices>
+        static void switchTo(std::index_sequence<indices...>)
+        {
+            ((m_current == indices ? reconfigure<Device<indices>, Target>() : void()), ...);
+        }
+
+        template<typename From, typename To>
+        static void reconfigure()
+        {
+            constexpr bool ctl_0_differs = From::ctl_0_value != To::ctl_0_value;
+            constexpr bool br_0_differs = From::br_0_value != To::br_0_value;
+            constexpr bool br_1_differs = From::br_1_value != To::br_1_value;
+            if constexpr (ctl_0_differs || br_0_differs || br_1_differs)
+            {
+                // Entering the reset state would abort a character which is still shifted
+                while (SPI::busy());
+                Usci::disableModule();
+                if constexpr (ctl_0_differs)
+                    *Usci::ctl_0 = To::ctl_0_value;
+                if constexpr (br_0_differs)
+                    *Usci::br_0 = To::br_0_value;
+                if constexpr (br_1_differs)
+                    *Usci::br_1 = To::br_1_value;
+                Usci::enableModule();
+            }
+        }
+
+        static inline std::uint8_t m_current = 0;
+    };
+
+    /// \brief A chip select line, active low unless stated otherwise.
+    struct ChipSelect
+    {
+        register8_t* out;
+        std::uint8_t pins;
+        bool active_high;
+
+        void select() const
+        {
+            if (active_high)
+                *out |= pins;
+            else
+                *out &= ~pins;
+        }
+
+        void release() const
+        {
+            if (active_high)
+                *out &= ~pins;
+            else
+                *out |= pins;
+        }
+    };
+
+    /// \brief The chip select line of an output GPIOPin. The pin has to be initialized and released before use.
+    template<typename Pin, bool active_high = false>
+    constexpr ChipSelect chipSelect()
+    {
+        return ChipSelect{Pin::out, Pin::pins_value, active_high};
+    }
+
+    enum class SPITransactionStatus : std::uint8_t
+    {
+        idle, ///< Not submitted yet, or rejected because the queue was full.
+        pending, ///< Waiting in the queue.
+        active, ///< Currently transferred.
+        complete, ///< All characters were exchanged.
+        overrun ///< Complete, but the ISR was too late and at least one received character was lost.
+    };
+
+    struct SPITransaction;
+
+    /// \brief Called from the ISR when a transaction finished. May submit further transactions.
+    using SPICompletionCallback = void (*)(SPITransaction& transaction);
+
+    /// \brief A transfer to one device, which is queued by AsyncSPIMaster.
+    ///
+    /// The transaction and its buffers are used in place, so they must stay valid until the status is complete or
+    /// overrun.
+    struct SPITransaction
+    {
+        ChipSelect chip_select;
+        /// \brief The characters to send, nullptr to send fill instead.
+        const std::uint8_t* tx;
+        /// \brief Receives the characters, nullptr to discard them. May be the same buffer as tx.
+        std::uint8_t* rx;
+        std::size_t length;
+        SPICompletionCallback on_complete = nullptr;
+        /// \brief Free for use by the callback.
+        void* context = nullptr;
+        std::uint8_t fill = 0xff;
+        /// \brief Keep the device selected, e.g. if the next transaction continues the command to the same device.
+        bool keep_selected = false;
+        volatile SPITransactionStatus status = SPITransactionStatus::idle;
+    };
+
+    /// \brief Interrupt driven SPI master which runs queued transactions back to back.
+    ///
+    /// The receive ISR stores the received character and loads the next one, keeping up to two characters in the
+    /// transmit and shift register, so the clock keeps running as long as the ISR is entered within one character
+    /// time. The chip select of each transaction is asserted before its first character and released after its last
+    /// character was received. Meanwhile the CPU is free to sleep or compute.
+    ///
+    /// The vectors are shared with the other USCI module, hence the driver does not define the ISR itself. Call
+    /// handleRxInterrupt() from the USCIAB0RX (USCIAB1RX) vector.
+    ///
+    /// \tparam SPI A configured SPI_t in a master mode.
+    /// \tparam max_transactions The number of transactions which can wait, must be a power of two.
+    template<typename SPI, std::size_t max_transactions>
+    struct AsyncSPIMaster
+    {
+        using Usci = typename SPI::Usci;
+
+        static_assert(SPI::mode_value & UCMST, "The SPI has to be configured as master");
+
+        /// \brief Configure the USCI, must be called before the first submit().
+        void init()
+        {
+            SPI::init();
+        }
+
+        /// \brief Append a transaction to the queue, it is started immediately if the bus is idle.
+        ///
+        /// \return false if the queue is full.
+        bool submit(SPITransaction& transaction)
+        {
+            multitasking::InterruptGuard guard;
+            if (m_queue.full())
+                return false;
+            transaction.status = SPITransactionStatus::pending;
+            m_queue.insert(&transaction);
+            if (m_active == nullptr)
+                startNext();
+            return true;
+        }
+
+        /// \brief Have all submitted transactions finished?
+        bool idle() const
+        {
+            return m_active == nullptr;
+        }
+
+        /// \brief The number of transactions which wait in the queue, not counting the active one.
+        std::size_t pending() const
+        {
+            return m_queue.size();
+        }
+
+        /// \brief Must be called from the receive ISR of the USCI.
+        ///
+        /// If the ISR was too late and received characters were lost, the transaction still finishes once its last
+        /// character was shifted, with status overrun.
+        ///
+        /// \return true if a transaction finished, e.g. to wake up the CPU on exit of the ISR.
+        bool handleRxInterrupt()
+        {
+            // The overrun flag is cleared by reading the receive buffer
+            bool overrun = *Usci::stat & UCOE;
+            std::uint8_t byte = *Usci::rx_buf;
+            SPITransaction* transaction = m_active;
+            if (transaction == nullptr)
+                return false;
+
+            if (overrun)
+            {
+                // Both characters in flight were completed, the first one is lost
+                m_overrun = true;
+                ++m_received;
+            }
+            if (transaction->rx != nullptr)
+                transaction->rx[m_received] = byte;
+            ++m_received;
+
+            if (m_received < transaction->length)
+            {
+                load(*transaction);
+                if (m_sent < transaction->length || SPI::busy() || Usci::isRxInterruptPending())
+                    return false;
+                // All characters were shifted but some were not counted: a character completed between reading the
+                // status and the receive buffer, and the overrun of its predecessor went unnoticed
+                m_overrun = true;
+            }
+
+            if (!transaction->keep_selected)
+                transaction->chip_select.release();
+            transaction->status = m_overrun ? SPITransactionStatus::overrun : SPITransactionStatus::complete;
+            m_active = nullptr;
+            if (transaction->on_complete != nullptr)
+                transaction->on_complete(*transaction);
+            // The callback may have started the next transaction already
+            if (m_active == nullptr)
+                startNext();
+            return true;
+        }
+
+    private:
+        void startNext()
+        {
+            SPITransaction* transaction;
+            while (m_queue.get(transaction))
+            {
+                if (transaction->length == 0)
+                {
+                    transaction->status = SPITransactionStatus::complete;
+                    if (transaction->on_complete != nullptr)
+                        transaction->on_complete(*transaction);
+                    if (m_active != nullptr)
+                        return;
+                    continue;
+                }
+                m_active = transaction;
+                m_sent = 0;
+                m_received = 0;
+                m_overrun = false;
+                transaction->status = SPITransactionStatus::active;
+                transaction->chip_select.select();
+                load(*transaction);
+                Usci::enableRxInterrupt();
+                return;
+            }
+            Usci::disableRxInterrupt();
+        }
+
+        /// \brief Fill the transmit buffer while less than two characters are in flight.
+        void load(const SPITransaction& transaction)
+        {
+            while (m_sent < transaction.length && m_sent - m_received < 2 && Usci::isTxInterruptPending())
+            {
+                *Usci::tx_buf = (transaction.tx != nullptr) ? transaction.tx[m_sent] : transaction.fill;
+                ++m_sent;
+            }
+        }
+
+        memory::ring_buffer<SPITransaction*, max_transactions> m_queue;
+        SPITransaction* volatile m_active = nullptr;
+        std::size_t m_sent = 0;
+        std::size_t m_received = 0;
+        bool m_overrun = false;
+    };
+
+    /// \brief Interrupt driven SPI slave, e.g. for a co-processor of a host which is the master.
+    ///
+    /// A frame lasts from the assertion to the release of the chip select (STE). The receive ISR assembles the
+    /// characters of a frame in the free space of the receive buffer; the frame only becomes visible when the chip
+    /// select is released, as a view into the receive buffer. A frame which does not fit is truncated.
+    ///
+    /// The response is sent from a buffer of the application. The first character is loaded into TXBUF before the
+    /// frame starts and the transmit ISR loads each following one while the previous is shifted, so the master can
+    /// clock without pauses. After the response the fill character is sent. A response set with setResponse() applies
+    /// to the next frame; at the end of a frame it is used up, so a frame without a new response only returns the fill
+    /// character, e.g. as busy indication.
+    ///
+    /// At the end of every frame the USCI is reset, which aligns the bit counter and discards the characters that were
+    /// preloaded for a longer frame. setResponse() resets it as well between frames, since TXBUF and the shift register
+    /// already hold the first characters of the old response.
+    ///
+    /// The end of a frame is only noticed when handleSelectInterrupt() runs, so the master has to keep the chip select
+    /// released until then: the port interrupt latency plus the receive ISR of the last character, about 100 MCLK
+    /// cycles with the ISRs of this driver alone. If the chip select is asserted again before, the characters of both
+    /// frames can not be told apart; both frames are discarded and counted by missedBoundaries().
+    ///
+    /// The vectors are shared with the other USCI module, hence the driver does not define the ISRs itself. Call
+    /// handleRxInterrupt() from the USCIAB0RX, handleTxInterrupt() from the USCIAB0TX vector and
+    /// handleSelectInterrupt() from the port vector of the chip select pin.
+    ///
+    /// \tparam SPI A configured SPI_t in a slave mode.
+    /// \tparam SelectPin An input GPIOPin on port 1 or 2 which is connected to the chip select of the master, usually
+    /// the STE pin itself. The port interrupt detects the release at the end of a frame.
+    /// \tparam rx_capacity The size of the receive buffer, must be a power of two.
+    /// \tparam max_frames The number of complete frames that can wait for the main loop, must be a power of two.
+    template<typename SPI, typename SelectPin, std::size_t rx_capacity, std::size_t max_frames>
+    struct SPISlave
+    {
+        using Usci = typename SPI::Usci;
+        using RxBuffer = memory::byte_ring_buffer<rx_capacity>;
+        using index_type = typename RxBuffer::index_type;
+        /// \brief The characters of a frame, the second segment is empty unless the frame wraps around.
+        using FrameView = typename RxBuffer::template segment_pair<const std::uint8_t>;
+
+        static_assert(!(SPI::mode_value & UCMST), "The SPI has to be configured as slave");
+        static_assert(SelectPin::mode_value == gpio::Mode::input, "The chip select has to be an input");
+        static_assert(SelectPin::port_value <= gpio::Port::port_2, "The chip select needs a pin with interrupt capability");
+
+        /// \brief The chip select is active high only in 4-pin mode with active high STE.
+        static constexpr bool select_active_high = SPI::mode_value == slave_4pin_active_high;
+
+        RxBuffer rx_buffer;
+
+        /// \brief Configure the USCI, arm the chip select interrupt and preload the first response.
+        void init()
+        {
+            SelectPin::init();
+            SelectPin::setInterruptEdge(select_active_high ? gpio::InterruptEdge::falling : gpio::InterruptEdge::rising);
+            SelectPin::clearInterruptFlag();
+            SelectPin::enableInterrupt();
+            SPI::init();
+            prepareFrame();
+        }
+
+        /// \brief Set the response for the next frame.
+        ///
+        /// If no frame is in progress, the USCI is reset and the response is loaded immediately, otherwise when the
+        /// current frame ends. Like at the end of a frame, the master must not assert the chip select before this
+        /// returns. The data must stay valid until the frame which sends it ended.
+        ///
+        /// \param fill The character sent after the response.
+        void setResponse(const std::uint8_t* data, std::size_t length, std::uint8_t fill = 0xff)
+        {
+            multitasking::InterruptGuard guard;
+            m_next_response = data;
+            m_next_length = length;
+            m_next_fill = fill;
+            m_response_pending = true;
+            // A frame end which was not handled yet loads the response in handleSelectInterrupt()
+            if (!selected() && SelectPin::interruptFlag() == 0)
+                restart();
+        }
+
+        /// \brief Is the chip select asserted?
+        bool selected() const
+        {
+            return (SelectPin::inputLevel() != 0) == select_active_high;
+        }
+
+        /// \brief The number of complete frames waiting to be processed.
+        std::size_t frames() const
+        {
+            return m_frames.size();
+        }
+
+        /// \brief The oldest complete frame. Must only be called by the main loop.
+        ///
+        /// \return The view stays valid until releaseFrame() is called, both segments are empty if no frame is waiting.
+        FrameView frame()
+        {
+            auto lengths = m_frames.peek_contiguous();
+            if (lengths.size == 0)
+                return FrameView{{nullptr, 0}, {nullptr, 0}};
+            index_type length = lengths.data[0];
+            FrameView view = rx_buffer.peek_segments();
+            if (length <= view.first.size)
+            {
+                view.first.size = length;
+                view.second.size = 0;
+            }
+            else
+                view.second.size = length - view.first.size;
+            return view;
+        }
+
+        /// \brief Hand the memory of the oldest frame back to the receive ISR.
+        void releaseFrame()
+        {
+            index_type length;
+            if (m_frames.get(length))
+                rx_buffer.skip(length);
+        }
+
+        /// \brief The number of frames which were shortened, saturates at 0xffff.
+        std::uint16_t truncatedFrames() const
+        {
+            return m_truncated_frames;
+        }
+
+        /// \brief The number of frames which were dropped because max_frames frames were waiting, saturates at 0xffff.
+        std::uint16_t droppedFrames() const
+        {
+            return m_dropped_frames;
+        }
+
+        /// \brief The number of frame ends which were noticed after the chip select was asserted again, saturates at 0xffff.
+        ///
+        /// Both frames around such a boundary are discarded.
+        std::uint16_t missedBoundaries() const
+        {
+            return m_missed_boundaries;
+        }
+
+        /// \brief The number of characters lost because the receive ISR was too late, saturates at 0xffff.
+        std::uint16_t overruns() const
+        {
+            return m_overruns;
+        }
+
+        void clearStatistics()
+        {
+            m_truncated_frames = 0;
+            m_overruns = 0;
+            m_dropped_frames = 0;
+            m_missed_boundaries = 0;
+        }
+
+        /// \brief Must be called from the receive ISR of the USCI.
+        ///
+        /// \return Always false, frames are completed by handleSelectInterrupt().
+        bool handleRxInterrupt()
+        {
+            // The overrun flag is cleared by reading the receive buffer
+            if ((*Usci::stat & UCOE) && m_overruns != 0xffff)
+                m_overruns = m_overruns + 1;
+            std::uint8_t byte = *Usci::rx_buf;
+            if (m_discard)
+                return false;
+
+            auto free = rx_buffer.reserve_segments();
+            if (m_frame_length >= free.first.size + free.second.size)
+            {
+                m_truncated = true;
+                return false;
+            }
+            if (m_frame_length < free.first.size)
+                free.first.data[m_frame_length] = byte;
+            else
+                free.second.data[m_frame_length - free.first.size] = byte;
+            ++m_frame_length;
+            return false;
+        }
+
+        /// \brief Must be called from the transmit ISR of the USCI.
+        ///
+        /// \return Always false, the transmit interrupt stays enabled during the frame.
+        bool handleTxInterrupt()
+        {
+            if (m_response_index < m_response_length)
+                *Usci::tx_buf = m_response[m_response_index++];
+            else
+                *Usci::tx_buf = m_fill;
+            return false;
+        }
+
+        /// \brief Must be called from the port ISR of the chip select pin.
+        ///
+        /// \return true if a frame was completed, e.g. to wake up the CPU on exit of the ISR.
+        bool handleSelectInterrupt()
+        {
+            if (SelectPin::interruptFlag() == 0)
+                return false;
+            SelectPin::clearInterruptFlag();
+            // The last character was received before the release, its interrupt has a higher priority
+            if (Usci::isRxInterruptPending())
+                handleRxInterrupt();
+
+            if (selected())
+            {
+                // The next frame started already and its first characters may have been added to this one. The rest
+                // of the next frame is discarded as well, the USCI must not be reset while the master clocks.
+                if (m_missed_boundaries != 0xffff)
+                    m_missed_boundaries = m_missed_boundaries + 1;
+                m_frame_length = 0;
+                m_truncated = false;
+                m_discard = true;
+                return false;
+            }
+
+            bool stored = false;
+            if (m_frame_length > 0 && !m_discard)
+            {
+                if (m_frames.full())
+                {
+                    if (m_dropped_frames != 0xffff)
+                        m_dropped_frames = m_dropped_frames + 1;
+                }
+                else
+                {
+                    // The bytes must be visible before the frame is
+                    rx_buffer.publish(m_frame_length);
+                    m_frames.insert(m_frame_length);
+                    if (m_truncated && m_truncated_frames != 0xffff)
+                        m_truncated_frames = m_truncated_frames + 1;
+                    stored = true;
+                }
+            }
+            m_frame_length = 0;
+            m_truncated = false;
+            m_discard = false;
+
+            restart();
+            return stored;
+        }
+
+    private:
+        /// \brief Reset the USCI, which drops the preloaded characters, and prepare the next frame.
+        void restart()
+        {
+            Usci::disableModule();
+            Usci::enableModule();
+            prepareFrame();
+        }
+
+        /// \brief Take over the next response and preload its first character. Called while no frame is in progress.
+        void prepareFrame()
+        {
+            if (m_response_pending)
+            {
+                m_response = m_next_response;
+                m_response_length = m_next_length;
+                m_fill = m_next_fill;
+                m_response_pending = false;
+            }
+            else
+                m_response_length = 0;
+            m_response_index = 0;
+            handleTxInterrupt();
+            // Leaving the reset state clears the interrupt enable bits
+            Usci::enableRxInterrupt();
+            Usci::enableTxInterrupt();
+        }
+
+        memory::ring_buffer<index_type, max_frames> m_frames;
+        const std::uint8_t* m_response = nullptr;
+        std::size_t m_response_length = 0;
+        std::size_t m_response_index = 0;
+        std::uint8_t m_fill = 0xff;
+        const std::uint8_t* m_next_response = nullptr;
+        std::size_t m_next_length = 0;
+        std::uint8_t m_next_fill = 0xff;
+        bool m_response_pending = false;
+        index_type m_frame_length = 0;
+        bool m_truncated = false;
+        bool m_discard = false;
+        volatile std::uint16_t m_truncated_frames = 0;
+        volatile std::uint16_t m_overruns = 0;
+        volatile std::uint16_t m_dropped_frames = 0;
+        volatile std::uint16_t m_missed_boundaries = 0;
+    };
 }
 
 
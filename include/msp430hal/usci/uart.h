@@ -2,7 +2,12 @@
 #define MSP430HAL_USCI_UART_H
 
 #include <msp430.h>
+#include <cstddef>
+#include <cstdint>
 #include "usci.h"
+#include "../gpio/pin.h"
+#include "../memory/ring_buffer.h"
+#include "../multitasking/interrupt_guard.h"
 #include "../util/math.h"
 
 namespace msp430hal
@@ -17,7 +22,118 @@ namespace msp430hal
             uart_automatic_baud = 0x06
         };
 
+        /// \brief The minimal length of the delimiter between break and synch field for automatic baud rate detection.
+        enum BreakDelimiterLength : std::uint8_t
+        {
+            delimiter_1_bit = 0x00,
+            delimiter_2_bits = 0x10,
+            delimiter_3_bits = 0x20,
+            delimiter_4_bits = 0x30
+        };
+
+
+        /// \brief Divider and modulation settings of the USCI_A baud rate generator.
+        struct BaudRateSetting
+        {
+            std::uint16_t ucbr;
+            std::uint8_t ucbrs;
+            std::uint8_t ucbrf;
+            bool oversampling;
+            /// \brief Worst case deviation of a transmitted bit edge or a receive sampling point in percent of a bit.
+            double max_error_percent;
+        };
 
+        namespace
+        {
+            /// Bit i is set if bit i of a character (0 is the start bit) is stretched by UCBRSx, repeats after 8 bits.
+            static constexpr std::uint8_t ucbrs_pattern[8] = {0x00, 0x02, 0x22, 0x2a, 0xaa, 0xae, 0xee, 0xfe};
+
+            constexpr double absoluteValue(double value)
+            {
+                return (value < 0.) ? -value : value;
+            }
+        }
+
+        /// \brief The worst case bit timing error of a baud rate setting over one character.
+        ///
+        /// Follows the transmit and receive timing model of the family user's guide: the transmit error is the
+        /// deviation of every bit edge, the receive error the deviation of every sampling point including the half
+        /// BRCLK period uncertainty of the start bit synchronization.
+        ///
+        /// \param frame_bits The length of a character including start, parity, address and stop bits.
+        /// \return The largest deviation in percent of the ideal bit length.
+        constexpr double baudRateError(std::uint32_t brclk, std::uint32_t baud_rate, std::uint8_t frame_bits,
+                                       std::uint16_t ucbr, std::uint8_t ucbrs, std::uint8_t ucbrf, bool oversampling)
+        {
+            const double ideal_bit = static_cast<double>(brclk) / static_cast<double>(baud_rate);
+            // In BRCLK periods relative to the falling edge of the start bit
+            double tx_time = 0.;
+            double rx_time = (oversampling) ? (8. + (ucbrs_pattern[ucbrs] & 0x01)) * ucbr + ((ucbrf < 7) ? ucbrf : 7)
+                                            : (ucbr / 2) + (ucbrs_pattern[ucbrs] & 0x01);
+            double worst = 0.;
+            for (std::uint8_t bit = 0; bit < frame_bits; ++bit)
+            {
+                std::uint8_t stretched = (ucbrs_pattern[ucbrs] >> (bit & 0x07)) & 0x01;
+                double bit_length = (oversampling) ? (16. + stretched) * ucbr + ucbrf : static_cast<double>(ucbr + stretched);
+                tx_time += bit_length;
+                if (bit > 0)
+                    rx_time += bit_length;
+                double tx_error = absoluteValue(tx_time - (bit + 1) * ideal_bit);
+                double rx_error = absoluteValue(rx_time - (bit + 0.5) * ideal_bit) + 0.5;
+                if (tx_error > worst)
+                    worst = tx_error;
+                if (rx_error > worst)
+                    worst = rx_error;
+            }
+            return worst / ideal_bit * 100.;
+        }
+
+        /// \brief Search the divider and modulation settings with the smallest worst case bit timing error.
+        ///
+        /// Tries every UCBRSx (and with oversampling every UCBRFx) for the two prescalers around the ideal division
+        /// factor. Oversampling is only considered if the division factor is at least 16 and wins ties.
+        constexpr BaudRateSetting findBaudRateSetting(std::uint32_t brclk, std::uint32_t baud_rate, std::uint8_t frame_bits,
+                                                      bool allow_oversampling)
+        {
+            const double division_factor = static_cast<double>(brclk) / static_cast<double>(baud_rate);
+            BaudRateSetting best{0, 0, 0, false, 1e9};
+            std::uint32_t prescaler = static_cast<std::uint32_t>(division_factor);
+            for (std::uint32_t ucbr = (prescaler > 0) ? prescaler : 1; ucbr <= prescaler + 1 && ucbr <= 0xffff; ++ucbr)
+            {
+                for (std::uint8_t ucbrs = 0; ucbrs < 8; ++ucbrs)
+                {
+                    double error = baudRateError(brclk, baud_rate, frame_bits, ucbr, ucbrs, 0, false);
+                    if (error < best.max_error_percent)
+                        best = BaudRateSetting{static_cast<std::uint16_t>(ucbr), ucbrs, 0, false, error};
+                }
+            }
+            if (!allow_oversampling || division_factor < 16.)
+                return best;
+            prescaler = static_cast<std::uint32_t>(division_factor / 16.);
+            for (std::uint32_t ucbr = prescaler; ucbr <= prescaler + 1; ++ucbr)
+            {
+                for (std::uint8_t ucbrf = 0; ucbrf < 16; ++ucbrf)
+                {
+                    for (std::uint8_t ucbrs = 0; ucbrs < 8; ++ucbrs)
+                    {
+                        double error = baudRateError(brclk, baud_rate, frame_bits, ucbr, ucbrs, ucbrf, true);
+                        if (error <= best.max_error_percent)
+                            best = BaudRateSetting{static_cast<std::uint16_t>(ucbr), ucbrs, ucbrf, true, error};
+                    }
+                }
+            }
+            return best;
+        }
+
+        /// \brief Asynchronous mode of an USCI_A module.
+        ///
+        /// The divider and modulation settings are searched at compile time for the smallest worst case bit timing
+        /// error, see findBaudRateSetting(). A configuration whose error exceeds max_error_limit_percent fails to compile.
+        ///
+        /// \tparam oversampling_baud_generator Allow the oversampling mode, it is used if it gives the smaller error.
+        /// \tparam max_error_limit_percent The largest acceptable bit timing error in percent of a bit. The default of
+        /// 5 % leaves most of the tolerance of the other side to its own clock. Low division factors, e.g. 115200 baud
+        /// from 1 MHz (14.8 %), need an explicitly raised limit.
         template<std::uint8_t instance,
                  std::uint32_t baud_rate,
                  std::uint32_t brclk,
@@ -29,7 +145,8 @@ namespace msp430hal
                  bool seven_bit_data = false,
                  bool two_stop_bits = false,
                  UARTMode mode = uart,
-                 bool sync_mode = false>
+                 bool sync_mode = false,
+                 std::uint8_t max_error_limit_percent = 5>
 
         struct UART_t
         {
@@ -43,7 +160,6 @@ namespace msp430hal
             static constexpr std::uint8_t instance_value = instance;
             static constexpr std::uint32_t baud_rate_value = baud_rate;
             static constexpr std::uint32_t brclk_value = brclk;
-            static constexpr bool oversampling_baud_generator_value = (oversampling_baud_generator && division_factor() >= 16.);
             static constexpr bool enable_parity_value = enable_parity;
             static constexpr bool even_parity_value = even_parity;
             static constexpr bool msb_first_value = msb_first;
@@ -52,25 +168,38 @@ namespace msp430hal
             static constexpr UARTMode mode_value = mode;
             static constexpr bool sync_mode_value = sync_mode;
             static constexpr UsciClockSource clock_source_value = clock_source;
+            static constexpr std::uint8_t max_error_limit_percent_value = max_error_limit_percent;
+
+            /// \brief Start, data, parity, address and stop bits of a character.
+            static constexpr std::uint8_t frame_bits = 1 + (seven_bit_data ? 7 : 8) + (enable_parity ? 1 : 0) +
+                                                       ((mode == address_bit_multiprocessor) ? 1 : 0) + (two_stop_bits ? 2 : 1);
+
+            static constexpr BaudRateSetting baud_rate_setting = findBaudRateSetting(brclk, baud_rate, frame_bits,
+                                                                                     oversampling_baud_generator);
+            static constexpr bool oversampling_baud_generator_value = baud_rate_setting.oversampling;
+            static constexpr double max_error_percent = baud_rate_setting.max_error_percent;
+
+            static_assert(sync_mode || max_error_percent <= max_error_limit_percent,
+                          "The bit timing error of the baud rate exceeds the limit, choose another BRCLK or baud rate");
 
             static constexpr std::uint16_t ucbr_value()
             {
-                return (oversampling_baud_generator_value) ? static_cast<std::uint16_t>(division_factor() / 16.) : static_cast<std::uint16_t>(division_factor());
+                return baud_rate_setting.ucbr;
             }
 
             static constexpr std::uint8_t ucbrs_value()
             {
-                return round_t<std::uint8_t, double>((division_factor() - static_cast<std::uint16_t>(division_factor())) * 8);
+                return baud_rate_setting.ucbrs;
             }
 
             static constexpr std::uint8_t ucbrf_value()
             {
-                return round_t<std::uint8_t, double>((division_factor()/16. - static_cast<std::uint16_t>(division_factor()/16.)) * 16.);
+                return baud_rate_setting.ucbrf;
             }
 
             static constexpr std::uint8_t modulation_control_value()
             {
-                return (ucbrf_value() << 4) | (ucbrs_value() << 3) | oversampling_baud_generator_value;
+                return (ucbrf_value() << 4) | (ucbrs_value() << 1) | oversampling_baud_generator_value;
             }
 
             static constexpr std::uint16_t ucbr = ucbr_value();
@@ -154,7 +283,125 @@ namespace msp430hal
                 return *Usci::stat & UCBUSY;
             }
 
-            //TODO handle break condition
+            /// \brief Send a character, waits until the transmit buffer is free.
+            static void write(std::uint8_t byte)
+            {
+                while (!Usci::isTxInterruptPending());
+                *Usci::tx_buf = byte;
+            }
+
+            static bool readBreakCondition()
+            {
+                return *Usci::stat & UCBRK;
+            }
+
+            /// \brief Only receive address characters until disableDormantMode() is called.
+            ///
+            /// In the multiprocessor modes the receive interrupt flag is then only set for characters with the address
+            /// bit or after an idle period, so the CPU keeps sleeping while other nodes are addressed.
+            static void enableDormantMode()
+            {
+                static_assert(mode == idle_line_multiprocessor || mode == address_bit_multiprocessor || mode == uart_automatic_baud,
+                              "The dormant mode requires a multiprocessor or automatic baud rate mode");
+                *Usci::ctl_1 |= UCDORM;
+            }
+
+            static void disableDormantMode()
+            {
+                *Usci::ctl_1 &= ~UCDORM;
+            }
+
+            /// \brief Is the character in the receive buffer an address? Must be checked before reading the receive buffer.
+            static bool readAddressFlag()
+            {
+                return *Usci::stat & UCADDR;
+            }
+
+            /// \brief Send an address character, with the address bit set or preceded by an idle period.
+            static void transmitAddress(std::uint8_t address)
+            {
+                static_assert(mode == idle_line_multiprocessor || mode == address_bit_multiprocessor,
+                              "Address characters require a multiprocessor mode");
+                while (!Usci::isTxInterruptPending());
+                // UCTXADDR is reset when the start bit is generated
+                *Usci::ctl_1 |= UCTXADDR;
+                *Usci::tx_buf = address;
+            }
+
+            /// \brief Send a break. With automatic baud rate detection a break/synch sequence is sent instead.
+            static void transmitBreak()
+            {
+                while (!Usci::isTxInterruptPending());
+                *Usci::ctl_1 |= UCTXBRK;
+                // UCTXBRK is reset when the break is generated, the character is ignored apart from the synch field
+                *Usci::tx_buf = (mode == uart_automatic_baud) ? 0x55 : 0x00;
+            }
+
+            /// \brief Measure the baud rate with every received break/synch sequence.
+            ///
+            /// The measured divider and modulation settings are written into the baud rate registers by the hardware,
+            /// so the UART follows a master whose clock drifts. Only available in uart_automatic_baud mode.
+            ///
+            /// \param delimiter The minimal length of the delimiter between break and synch field.
+            static void enableAutomaticBaudRateDetection(BreakDelimiterLength delimiter = delimiter_1_bit)
+            {
+                static_assert(mode == uart_automatic_baud, "Automatic baud rate detection requires the uart_automatic_baud mode");
+                *Usci::ab_ctl = UCABDEN | delimiter;
+            }
+
+            /// \brief Keep the baud rate measured last.
+            static void disableAutomaticBaudRateDetection()
+            {
+                *Usci::ab_ctl &= ~UCABDEN;
+            }
+
+            /// \brief Was a break longer than 22 bit times received? The flag is cleared.
+            static bool breakTimeoutError()
+            {
+                bool error = *Usci::ab_ctl & UCBTOE;
+                *Usci::ab_ctl &= ~UCBTOE;
+                return error;
+            }
+
+            /// \brief Was a synch field too long to be measured? The flag is cleared.
+            static bool syncTimeoutError()
+            {
+                bool error = *Usci::ab_ctl & UCSTOE;
+                *Usci::ab_ctl &= ~UCSTOE;
+                return error;
+            }
+
+            /// \brief The divider and modulation settings currently used, e.g. the result of the last synch field.
+            ///
+            /// The measured baud rate is BRCLK divided by the bit length. To check it against limits, compare the
+            /// divider with settings computed at compile time instead of dividing at runtime.
+            ///
+            /// \return The setting, max_error_percent is not evaluated and always 0 to avoid floating point math at runtime.
+            static BaudRateSetting readBaudRateSetting()
+            {
+                std::uint8_t modulation = *Usci::mctl;
+                return BaudRateSetting{static_cast<std::uint16_t>(*Usci::br_0 | (*Usci::br_1 << 8)),
+                                       static_cast<std::uint8_t>((modulation & 0x0e) >> 1),
+                                       static_cast<std::uint8_t>(modulation >> 4),
+                                       static_cast<bool>(modulation & UCOS16), 0.};
+            }
+
+            /// \brief Reprogram the divider and modulation settings without resetting the module.
+            ///
+            /// Should only be called while no character is received or transmitted, e.g. to restore the configured
+            /// baud rate after a synch timeout or to apply a setting stored from an earlier measurement.
+            static void writeBaudRateSetting(const BaudRateSetting& setting)
+            {
+                *Usci::br_0 = static_cast<std::uint8_t>(0x00ff & setting.ucbr);
+                *Usci::br_1 = static_cast<std::uint8_t>((0xff00 & setting.ucbr) >> 8);
+                *Usci::mctl = (setting.ucbrf << 4) | (setting.ucbrs << 1) | setting.oversampling;
+            }
+
+            /// \brief Restore the divider and modulation settings calculated for the configured baud rate.
+            static void restoreBaudRate()
+            {
+                writeBaudRateSetting(baud_rate_setting);
+            }
 
             static void enable()
             {
@@ -168,6 +415,529 @@ namespace msp430hal
 
         };
 
+        /// \brief Interrupt driven UART with receive and transmit ring buffers.
+        ///
+        /// The receive interrupt stays enabled and moves every received character into the receive buffer. The transmit
+        /// interrupt is only enabled while the transmit buffer holds data, so an idle UART causes no interrupts at all.
+        /// write() and read() never wait, they transfer as many bytes as the buffers allow.
+        ///
+        /// The vectors are shared with USCI_B, hence the driver does not define the ISRs itself. Call handleRxInterrupt()
+        /// from the USCIAB0RX (USCIAB1RX) vector and handleTxInterrupt() from the USCIAB0TX (USCIAB1TX) vector.
+        ///
+        /// \tparam UART A configured UART_t.
+        /// \tparam rx_capacity The size of the receive buffer, must be a power of two.
+        /// \tparam tx_capacity The size of the transmit buffer, must be a power of two.
+        template<typename UART, std::size_t rx_capacity, std::size_t tx_capacity = rx_capacity>
+        struct BufferedUART
+        {
+            using Usci = typename UART::Usci;
+
+            memory::byte_ring_buffer<rx_capacity> rx_buffer;
+            memory::byte_ring_buffer<tx_capacity> tx_buffer;
+
+            /// \brief Configure the USCI and enable the receive interrupt.
+            ///
+            /// The constructor does not touch the hardware, so the driver can be a global object which is initialized
+            /// after the clocks were set up.
+            void init()
+            {
+                UART::init();
+                UART::enable();
+                // Leaving the reset state clears the interrupt enable bits, so enable the receive interrupt afterwards
+                Usci::enableRxInterrupt();
+            }
+
+            /// \brief Queue bytes for transmission without waiting.
+            ///
+            /// \param data The bytes to send.
+            /// \param length The number of bytes to send.
+            /// \return The number of bytes that fit into the transmit buffer.
+            std::size_t write(const std::uint8_t* data, std::size_t length)
+            {
+                std::size_t space = tx_capacity - tx_buffer.size();
+                if (length > space)
+                    length = space;
+                if (length == 0)
+                    return 0;
+                length = tx_buffer.write(data, length);
+                // The interrupt fires immediately if the transmitter is idle
+                Usci::enableTxInterrupt();
+                return length;
+            }
+
+            /// \brief Queue a single byte for transmission without waiting.
+            ///
+            /// \return false if the transmit buffer is full.
+            bool write(std::uint8_t byte)
+            {
+                if (tx_buffer.full())
+                    return false;
+                tx_buffer.insert(byte);
+                Usci::enableTxInterrupt();
+                return true;
+            }
+
+            /// \brief Start sending bytes which were inserted into tx_buffer directly, e.g. by a frame encoder.
+            void startTransmit()
+            {
+                if (!tx_buffer.empty())
+                    Usci::enableTxInterrupt();
+            }
+
+            /// \brief Take received bytes out of the receive buffer without waiting.
+            ///
+            /// \param data Receives the bytes.
+            /// \param length The maximum number of bytes to read.
+            /// \return The number of bytes actually read.
+            std::size_t read(std::uint8_t* data, std::size_t length)
+            {
+                return rx_buffer.read(data, length);
+            }
+
+            /// \brief Take a single received byte out of the receive buffer without waiting.
+            ///
+            /// \return false if no byte was received.
+            bool read(std::uint8_t& byte)
+            {
+                return rx_buffer.get(byte);
+            }
+
+            /// \brief The number of received bytes waiting to be read.
+            std::size_t available() const
+            {
+                return rx_buffer.size();
+            }
+
+            /// \brief The number of bytes which can be written without being truncated.
+            std::size_t writable() const
+            {
+                return tx_capacity - tx_buffer.size();
+            }
+
+            /// \brief Has every queued byte been shifted out completely?
+            bool transmitComplete() const
+            {
+                return tx_buffer.empty() && !UART::busy();
+            }
+
+            /// \brief The number of received bytes lost because the receive buffer was full, saturates at 0xffff.
+            std::uint16_t droppedBytes() const
+            {
+                return rx_buffer.dropped();
+            }
+
+            /// \brief Must be called from the receive ISR of the USCI.
+            ///
+            /// \return true if a byte was stored, e.g. to wake up the CPU on exit of the ISR.
+            bool handleRxInterrupt()
+            {
+                // Reading the receive buffer clears the interrupt flag, even if the byte is dropped
+                std::uint8_t byte = *Usci::rx_buf;
+                return rx_buffer.insert(byte);
+            }
+
+            /// \brief Must be called from the transmit ISR of the USCI.
+            ///
+            /// \return true if the transmit buffer ran empty with this call, e.g. to wake up the CPU on exit of the ISR.
+            bool handleTxInterrupt()
+            {
+                std::uint8_t byte;
+                if (tx_buffer.get(byte))
+                {
+                    *Usci::tx_buf = byte;
+                    return false;
+                }
+                // Nothing left to send; the main loop cannot interfere between the check and this, as it runs at lower priority
+                Usci::disableTxInterrupt();
+                return true;
+            }
+        };
+
+        /// \brief Buffered UART for a node on a multidrop bus using one of the multiprocessor modes.
+        ///
+        /// The USCI stays dormant until an address character arrives, so data for other nodes causes no interrupts. If
+        /// the address matches the own address the following data characters are received into the buffer until the
+        /// next address character; otherwise the USCI goes back to the dormant mode.
+        ///
+        /// \tparam UART A configured UART_t with idle_line_multiprocessor or address_bit_multiprocessor mode.
+        template<typename UART, std::size_t rx_capacity, std::size_t tx_capacity = rx_capacity>
+        struct MultiprocessorUART : BufferedUART<UART, rx_capacity, tx_capacity>
+        {
+            static_assert(UART::mode_value == idle_line_multiprocessor || UART::mode_value == address_bit_multiprocessor,
+                          "The UART has to use a multiprocessor mode");
+
+            using Usci = typename UART::Usci;
+            using Base = BufferedUART<UART, rx_capacity, tx_capacity>;
+
+            /// \param address The address this node responds to.
+            explicit MultiprocessorUART(std::uint8_t address) : m_address(address)
+            {}
+
+            /// \brief Configure the USCI like BufferedUART::init() and enter the dormant mode.
+            void init()
+            {
+                Base::init();
+                UART::enableDormantMode();
+            }
+
+            std::uint8_t address() const
+            {
+                return m_address;
+            }
+
+            void setAddress(std::uint8_t address)
+            {
+                m_address = address;
+            }
+
+            /// \brief Was this node addressed by the last address character?
+            bool selected() const
+            {
+                return m_selected;
+            }
+
+            /// \brief Queue an address character in front of the bytes written afterwards.
+            ///
+            /// Only one address can be waiting for transmission at a time.
+            ///
+            /// \return false if the transmit buffer is full or another address is still waiting.
+            bool writeAddress(std::uint8_t address)
+            {
+                {
+                    multitasking::InterruptGuard guard;
+                    if (m_address_pending || this->tx_buffer.full())
+                        return false;
+                    m_bytes_before_address = this->tx_buffer.size();
+                    m_address_pending = true;
+                }
+                this->tx_buffer.insert(address);
+                Usci::enableTxInterrupt();
+                return true;
+            }
+
+            /// \brief Must be called from the receive ISR of the USCI instead of BufferedUART::handleRxInterrupt().
+            ///
+            /// \return true if a data byte addressed to this node was stored.
+            bool handleRxInterrupt()
+            {
+                // Reading the receive buffer clears the address flag
+                bool address = UART::readAddressFlag();
+                std::uint8_t byte = *Usci::rx_buf;
+                if (address)
+                {
+                    m_selected = (byte == m_address);
+                    if (m_selected)
+                        UART::disableDormantMode();
+                    else
+                        UART::enableDormantMode();
+                    return false;
+                }
+                return m_selected && this->rx_buffer.insert(byte);
+            }
+
+            /// \brief Must be called from the transmit ISR of the USCI instead of BufferedUART::handleTxInterrupt().
+            ///
+            /// \return true if the transmit buffer ran empty with this call.
+            bool handleTxInterrupt()
+            {
+                std::uint8_t byte;
+                if (!this->tx_buffer.get(byte))
+                {
+                    Usci::disableTxInterrupt();
+                    return true;
+                }
+                if (m_address_pending)
+                {
+                    // UCTXADDR is reset when the start bit of the address character is generated
+                    if (m_bytes_before_address == 0)
+                    {
+                        m_address_pending = false;
+                        *Usci::ctl_1 |= UCTXADDR;
+                    }
+                    else
+                        m_bytes_before_address = m_bytes_before_address - 1;
+                }
+                *Usci::tx_buf = byte;
+                return false;
+            }
+
+        private:
+            std::uint8_t m_address;
+            volatile bool m_selected = false;
+            volatile bool m_address_pending = false;
+            volatile std::uint16_t m_bytes_before_address = 0;
+        };
+
+        /// \brief Buffered UART which receives whole lines, e.g. for a command console.
+        ///
+        /// The receive ISR detects the delimiter and records the length of every complete line, so the main loop never
+        /// scans the received bytes. The bytes of a line only become visible once the delimiter arrived; they are
+        /// handed out as view into the receive buffer, which consists of two segments if the line wraps around the end
+        /// of the buffer memory. The delimiter itself is not stored.
+        ///
+        /// A line which does not fit into the free space of the receive buffer or exceeds max_line_length is truncated,
+        /// the remaining characters up to the delimiter are dropped and counted in truncatedLines(). If max_lines
+        /// complete lines are already waiting, the new line is dropped and counted in droppedLines().
+        ///
+        /// \tparam max_lines The number of complete lines that can wait for the main loop, must be a power of two.
+        /// \tparam delimiter The character that ends a line, e.g. '\r' for terminals sending a carriage return only.
+        template<typename UART,
+                 std::size_t rx_capacity,
+                 std::size_t max_lines,
+                 std::size_t tx_capacity = rx_capacity,
+                 std::uint8_t delimiter = '\n',
+                 std::size_t max_line_length = rx_capacity>
+        struct LineBufferedUART : BufferedUART<UART, rx_capacity, tx_capacity>
+        {
+            using Usci = typename UART::Usci;
+            using RxBuffer = memory::byte_ring_buffer<rx_capacity>;
+            using index_type = typename RxBuffer::index_type;
+            /// \brief The characters of a line, the second segment is empty unless the line wraps around.
+            using LineView = typename RxBuffer::template segment_pair<const std::uint8_t>;
+
+            static_assert(max_line_length > 0 && max_line_length <= rx_capacity, "A line must fit into the receive buffer");
+
+            /// \brief Raw access would bypass the line boundaries, use line() and releaseLine() instead.
+            std::size_t read(std::uint8_t* data, std::size_t length) = delete;
+            bool read(std::uint8_t& byte) = delete;
+
+            /// \brief Bytes are only stored as part of a line, use lines(), truncatedLines() and droppedLines() instead.
+            std::size_t available() const = delete;
+            std::uint16_t droppedBytes() const = delete;
+
+            /// \brief The number of complete lines waiting to be processed.
+            std::size_t lines() const
+            {
+                return m_lines.size();
+            }
+
+            /// \brief The oldest complete line. Must only be called by the main loop.
+            ///
+            /// \return The view stays valid until releaseLine() is called, both segments are empty if no line is waiting.
+            LineView line()
+            {
+                auto lengths = m_lines.peek_contiguous();
+                if (lengths.size == 0)
+                    return LineView{{nullptr, 0}, {nullptr, 0}};
+                index_type length = lengths.data[0];
+                LineView view = this->rx_buffer.peek_segments();
+                if (length <= view.first.size)
+                {
+                    view.first.size = length;
+                    view.second.size = 0;
+                }
+                else
+                    view.second.size = length - view.first.size;
+                return view;
+            }
+
+            /// \brief Hand the memory of the oldest line back to the receive ISR.
+            void releaseLine()
+            {
+                index_type length;
+                if (m_lines.get(length))
+                    this->rx_buffer.skip(length);
+            }
+
+            /// \brief The number of lines which were shortened, saturates at 0xffff.
+            std::uint16_t truncatedLines() const
+            {
+                return m_truncated_lines;
+            }
+
+            /// \brief The number of lines which were dropped because max_lines lines were waiting, saturates at 0xffff.
+            std::uint16_t droppedLines() const
+            {
+                return m_dropped_lines;
+            }
+
+            void clearStatistics()
+            {
+                m_truncated_lines = 0;
+                m_dropped_lines = 0;
+            }
+
+            /// \brief Must be called from the receive ISR of the USCI instead of BufferedUART::handleRxInterrupt().
+            ///
+            /// \return true if a line was completed, e.g. to wake up the CPU on exit of the ISR.
+            bool handleRxInterrupt()
+            {
+                std::uint8_t byte = *Usci::rx_buf;
+                if (byte != delimiter)
+                {
+                    // The line is assembled in the free space and only published when it is complete
+                    auto free = this->rx_buffer.reserve_segments();
+                    if (m_line_length >= free.first.size + free.second.size || m_line_length >= max_line_length)
+                    {
+                        m_truncated = true;
+                        return false;
+                    }
+                    if (m_line_length < free.first.size)
+                        free.first.data[m_line_length] = byte;
+                    else
+                        free.second.data[m_line_length - free.first.size] = byte;
+                    ++m_line_length;
+                    return false;
+                }
+
+                bool stored = false;
+                if (m_lines.full())
+                {
+                    if (m_dropped_lines != 0xffff)
+                        m_dropped_lines = m_dropped_lines + 1;
+                }
+                else
+                {
+                    // The bytes must be visible before the line is
+                    this->rx_buffer.publish(m_line_length);
+                    m_lines.insert(m_line_length);
+                    if (m_truncated && m_truncated_lines != 0xffff)
+                        m_truncated_lines = m_truncated_lines + 1;
+                    stored = true;
+                }
+                m_line_length = 0;
+                m_truncated = false;
+                return stored;
+            }
+
+        private:
+            memory::ring_buffer<index_type, max_lines> m_lines;
+            index_type m_line_length = 0;
+            bool m_truncated = false;
+            volatile std::uint16_t m_truncated_lines = 0;
+            volatile std::uint16_t m_dropped_lines = 0;
+        };
+
+        /// \brief Buffered UART with RTS/CTS hardware flow control on two GPIO pins.
+        ///
+        /// Both signals are active low. RTS is deasserted by the receive ISR as soon as the receive buffer holds
+        /// high_watermark bytes and asserted again by read() once the buffer drained to low_watermark. The space above
+        /// the high watermark has to take the bytes the peer sends before it reacts, usually the character in progress
+        /// plus the transmit FIFO of the peer.
+        ///
+        /// The transmit ISR checks CTS before every byte. If CTS is deasserted the transmit interrupt is disabled and the
+        /// falling edge of CTS is armed instead, so a stopped transmitter causes no interrupts. Up to two bytes, which
+        /// are already in the transmit and shift register, are still sent after CTS was deasserted.
+        ///
+        /// The port vector is not defined by the driver either, call handleCtsInterrupt() from the vector of the CTS pin.
+        ///
+        /// \tparam RtsPin An output GPIOPin.
+        /// \tparam CtsPin An input GPIOPin on port 1 or 2, which support interrupts.
+        /// \tparam high_watermark The fill level of the receive buffer at which RTS is deasserted.
+        /// \tparam low_watermark The fill level of the receive buffer at which RTS is asserted again.
+        template<typename UART,
+                 typename RtsPin,
+                 typename CtsPin,
+                 std::size_t rx_capacity,
+                 std::size_t tx_capacity = rx_capacity,
+                 std::size_t high_watermark = rx_capacity - rx_capacity / 4,
+                 std::size_t low_watermark = rx_capacity / 4>
+        struct FlowControlledUART : BufferedUART<UART, rx_capacity, tx_capacity>
+        {
+            using Usci = typename UART::Usci;
+            using Base = BufferedUART<UART, rx_capacity, tx_capacity>;
+
+            static_assert(RtsPin::mode_value == gpio::Mode::output, "RTS has to be an output");
+            static_assert(CtsPin::mode_value == gpio::Mode::input, "CTS has to be an input");
+            static_assert(CtsPin::port_value <= gpio::Port::port_2, "CTS needs a pin with interrupt capability");
+            static_assert(low_watermark < high_watermark && high_watermark < rx_capacity,
+                          "The watermarks have to satisfy low < high < rx_capacity");
+
+            /// \brief Configure the USCI like BufferedUART::init() and the RTS and CTS pins.
+            void init()
+            {
+                Base::init();
+                // Assert RTS before the pin starts driving
+                RtsPin::clear();
+                RtsPin::init(gpio::PinFunction::io);
+                CtsPin::init(gpio::PinFunction::io);
+            }
+
+            /// \brief Take received bytes out of the receive buffer and assert RTS if enough space is free again.
+            std::size_t read(std::uint8_t* data, std::size_t length)
+            {
+                std::size_t count = Base::read(data, length);
+                updateRequestToSend();
+                return count;
+            }
+
+            /// \brief Take a single received byte out of the receive buffer and assert RTS if enough space is free again.
+            bool read(std::uint8_t& byte)
+            {
+                bool received = Base::read(byte);
+                updateRequestToSend();
+                return received;
+            }
+
+            /// \brief Is the peer allowed to send?
+            bool requestToSend() const
+            {
+                return (*RtsPin::out & RtsPin::pins_value) == 0;
+            }
+
+            /// \brief Does the peer allow to send?
+            bool clearToSend() const
+            {
+                return CtsPin::inputLevel() == 0;
+            }
+
+            /// \brief Must be called from the receive ISR of the USCI instead of BufferedUART::handleRxInterrupt().
+            ///
+            /// \return true if a byte was stored, e.g. to wake up the CPU on exit of the ISR.
+            bool handleRxInterrupt()
+            {
+                bool stored = Base::handleRxInterrupt();
+                if (this->rx_buffer.size() >= high_watermark)
+                    RtsPin::set();
+                return stored;
+            }
+
+            /// \brief Must be called from the transmit ISR of the USCI instead of BufferedUART::handleTxInterrupt().
+            ///
+            /// \return true if the transmit buffer ran empty with this call.
+            bool handleTxInterrupt()
+            {
+                if (CtsPin::inputLevel() != 0)
+                {
+                    // Changing the edge may set the flag, hence it is cleared afterwards
+                    CtsPin::setInterruptEdge(gpio::InterruptEdge::falling);
+                    CtsPin::clearInterruptFlag();
+                    CtsPin::enableInterrupt();
+                    // Check again, the edge could have happened before the detection was armed
+                    if (CtsPin::inputLevel() != 0)
+                    {
+                        Usci::disableTxInterrupt();
+                        return false;
+                    }
+                    CtsPin::disableInterrupt();
+                    CtsPin::clearInterruptFlag();
+                }
+                return Base::handleTxInterrupt();
+            }
+
+            /// \brief Must be called from the port ISR of the CTS pin.
+            ///
+            /// \return true if the interrupt was caused by CTS, e.g. to dispatch other pins of the port otherwise.
+            bool handleCtsInterrupt()
+            {
+                if (CtsPin::interruptFlag() == 0)
+                    return false;
+                CtsPin::clearInterruptFlag();
+                CtsPin::disableInterrupt();
+                // The transmit ISR checks CTS again, so a short pulse cannot release the transmitter
+                this->startTransmit();
+                return true;
+            }
+
+        private:
+            void updateRequestToSend()
+            {
+                // The receive ISR must not deassert RTS between the check and the assertion
+                multitasking::InterruptGuard guard;
+                if (this->rx_buffer.size() <= low_watermark)
+                    RtsPin::clear();
+            }
+        };
     }
 }
 
@@ -0,0 +1,37 @@
+#ifndef MSP430HAL_UTIL_CRC_H
+#define MSP430HAL_UTIL_CRC_H
+
+#include <cstddef>
+#include <cstdint>
+
+/// \brief The initial value of a CRC-16/CCITT-FALSE (polynomial 0x1021, no reflection, no final XOR).
+constexpr std::uint16_t crc16_ccitt_initial = 0xffff;
+
+/// \brief Add one byte to a CRC-16/CCITT-FALSE
+///
+/// Uses a few shifts and XORs instead of a lookup table, which keeps the flash usage at a couple of instructions and
+/// allows updating the CRC byte by byte in an ISR. Appending the CRC most significant byte first to the data gives a
+/// CRC of zero over data and CRC.
+///
+/// \param crc the CRC of the preceding bytes or crc16_ccitt_initial
+/// \param byte the next byte
+/// \return the updated CRC
+constexpr std::uint16_t crc16_ccitt_update(std::uint16_t crc, std::uint8_t byte)
+{
+    crc = static_cast<std::uint16_t>((crc >> 8) | (crc << 8));
+    crc ^= byte;
+    crc ^= (crc & 0xff) >> 4;
+    crc ^= static_cast<std::uint16_t>(crc << 12);
+    crc ^= static_cast<std::uint16_t>((crc & 0xff) << 5);
+    return crc;
+}
+
+/// \brief The CRC-16/CCITT-FALSE of a block of bytes
+constexpr std::uint16_t crc16_ccitt(const std::uint8_t* data, std::size_t length, std::uint16_t crc = crc16_ccitt_initial)
+{
+    for (std::size_t i = 0; i < length; ++i)
+        crc = crc16_ccitt_update(crc, data[i]);
+    return crc;
+}
+
+#endif //MSP430HAL_UTIL_CRC_H
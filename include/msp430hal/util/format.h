@@ -0,0 +1,191 @@
+#ifndef MSP430HAL_UTIL_FORMAT_H
+#define MSP430HAL_UTIL_FORMAT_H
+
+#include <cstdint>
+#include <type_traits>
+
+namespace msp430hal
+{
+    /// \brief Number formatting without division for serial output.
+    ///
+    /// The MSP430G2 has neither a hardware divider nor a multiplier, so printf style output pulls in software division
+    /// and several kilobytes of code. The functions here produce decimal digits by subtracting powers of ten, at most
+    /// nine subtractions per digit, and write each character directly to a sink.
+    ///
+    /// A sink is any object with a write(std::uint8_t) member, e.g. UART_t (blocking) or BufferedUART (non-blocking).
+    namespace format
+    {
+        namespace
+        {
+            static constexpr std::uint16_t powers_of_ten_16[] = {10000, 1000, 100, 10, 1};
+            static constexpr std::uint32_t powers_of_ten_32[] = {1000000000, 100000000, 10000000, 1000000, 100000,
+                                                                 10000, 1000, 100, 10, 1};
+
+            template<typename T>
+            using format_unsigned_t = std::conditional_t<(sizeof(T) <= 2), std::uint16_t, std::uint32_t>;
+
+            template<typename Sink, typename U>
+            void writeDigits(Sink& sink, U value, const U* powers, std::uint8_t count, std::uint8_t width, char fill,
+                             bool negative)
+            {
+                // Skip the leading zeros, the last digit is always written
+                std::uint8_t first = 0;
+                while (first + 1 < count && value < powers[first])
+                    ++first;
+
+                std::uint8_t length = count - first + negative;
+                if (negative && fill == '0')
+                    sink.write(static_cast<std::uint8_t>('-'));
+                for (; length < width; ++length)
+                    sink.write(static_cast<std::uint8_t>(fill));
+                if (negative && fill != '0')
+                    sink.write(static_cast<std::uint8_t>('-'));
+
+                for (std::uint8_t i = first; i < count; ++i)
+                {
+                    std::uint8_t digit = '0';
+                    while (value >= powers[i])
+                    {
+                        value -= powers[i];
+                        ++digit;
+                    }
+                    sink.write(digit);
+                }
+            }
+
+            template<typename Sink, typename U>
+            void writeMagnitude(Sink& sink, U magnitude, std::uint8_t width, char fill, bool negative)
+            {
+                if constexpr (sizeof(U) <= 2)
+                    writeDigits(sink, magnitude, powers_of_ten_16, 5, width, fill, negative);
+                else
+                    writeDigits(sink, magnitude, powers_of_ten_32, 10, width, fill, negative);
+            }
+
+            /// \brief Split a value into sign and magnitude, the most negative value is handled as well.
+            template<typename T>
+            format_unsigned_t<T> magnitudeOf(T value, bool& negative)
+            {
+                using U = format_unsigned_t<T>;
+                U magnitude = static_cast<U>(value);
+                negative = false;
+                if constexpr (std::is_signed_v<T>)
+                {
+                    if (value < 0)
+                    {
+                        negative = true;
+                        magnitude = static_cast<U>(U(0) - magnitude);
+                    }
+                }
+                return magnitude;
+            }
+        }
+
+        /// \brief Write a zero terminated string.
+        template<typename Sink>
+        void writeString(Sink& sink, const char* string)
+        {
+            while (*string != '\0')
+                sink.write(static_cast<std::uint8_t>(*string++));
+        }
+
+        /// \brief Write an integer in decimal.
+        ///
+        /// \param value An integer of up to 32 bit.
+        /// \param width The minimal number of characters, shorter numbers are padded on the left.
+        /// \param fill The padding character. With '0' the sign is written in front of the padding.
+        template<typename Sink, typename T>
+        void writeDecimal(Sink& sink, T value, std::uint8_t width = 0, char fill = ' ')
+        {
+            static_assert(std::is_integral_v<T> && sizeof(T) <= 4, "Only integers of up to 32 bit can be formatted");
+            bool negative;
+            auto magnitude = magnitudeOf(value, negative);
+            writeMagnitude(sink, magnitude, width, fill, negative);
+        }
+
+        /// \brief Write an integer in upper case hexadecimal without prefix.
+        ///
+        /// \param digits The number of digits, by default all digits of the type including leading zeros.
+        template<typename Sink, typename T>
+        void writeHex(Sink& sink, T value, std::uint8_t digits = sizeof(T) * 2)
+        {
+            static_assert(std::is_integral_v<T> && sizeof(T) <= 4, "Only integers of up to 32 bit can be formatted");
+            using U = format_unsigned_t<T>;
+            if (digits > sizeof(T) * 2)
+                digits = sizeof(T) * 2;
+            U bits = static_cast<U>(static_cast<std::make_unsigned_t<T>>(value));
+            for (std::uint8_t shift = digits * 4; shift > 0;)
+            {
+                shift -= 4;
+                std::uint8_t nibble = static_cast<std::uint8_t>(bits >> shift) & 0x0f;
+                sink.write(static_cast<std::uint8_t>((nibble < 10) ? '0' + nibble : 'A' + nibble - 10));
+            }
+        }
+
+        /// \brief Write a fixed point number in decimal, rounded half away from zero to the given number of decimal places.
+        ///
+        /// The fractional digits are produced by multiplying the fraction by ten with shifts and adds, so no division
+        /// is needed either. They are collected before the integer part is written, so a rounding carry can still
+        /// propagate into it. A negative value which rounds to zero is written without sign.
+        ///
+        /// \tparam fraction_bits The number of fractional bits of the Q format, e.g. 15 for Q15 or 8 for Q8.8.
+        /// \tparam decimals The number of decimal places.
+        /// \param value The raw fixed point value.
+        /// \param width The minimal number of characters including sign, point and decimals.
+        /// \param fill The padding character. With '0' the sign is written in front of the padding.
+        template<std::uint8_t fraction_bits, std::uint8_t decimals, typename Sink, typename T>
+        void writeFixed(Sink& sink, T value, std::uint8_t width = 0, char fill = ' ')
+        {
+            static_assert(std::is_integral_v<T> && sizeof(T) <= 4, "Only integers of up to 32 bit can be formatted");
+            static_assert(fraction_bits < sizeof(T) * 8 && fraction_bits <= 28, "Too many fractional bits for the type");
+            static_assert(decimals <= 9, "At most nine decimal places are supported");
+            using U = format_unsigned_t<T>;
+            constexpr std::uint32_t mask = (std::uint32_t(1) << fraction_bits) - 1;
+
+            bool negative;
+            U magnitude = magnitudeOf(value, negative);
+            U integer = static_cast<U>(magnitude >> fraction_bits);
+            std::uint32_t fraction = magnitude & mask;
+
+            std::uint8_t digits[(decimals > 0) ? decimals : 1];
+            for (std::uint8_t i = 0; i < decimals; ++i)
+            {
+                fraction = (fraction << 3) + (fraction << 1);
+                digits[i] = static_cast<std::uint8_t>(fraction >> fraction_bits);
+                fraction &= mask;
+            }
+            if constexpr (fraction_bits > 0)
+            {
+                // The remaining fraction decides the rounding, the carry ripples through the digits
+                bool carry = fraction >= (std::uint32_t(1) << (fraction_bits - 1));
+                for (std::uint8_t i = decimals; carry && i > 0;)
+                {
+                    --i;
+                    carry = (++digits[i] == 10);
+                    if (carry)
+                        digits[i] = 0;
+                }
+                if (carry)
+                    ++integer;
+            }
+            if (negative && integer == 0)
+            {
+                // No "-0.00" for values like -0.001
+                negative = false;
+                for (std::uint8_t i = 0; i < decimals; ++i)
+                    negative |= digits[i] != 0;
+            }
+
+            std::uint8_t integer_width = (decimals == 0) ? width : ((width > decimals + 1) ? width - decimals - 1 : 0);
+            writeMagnitude(sink, integer, integer_width, fill, negative);
+            if constexpr (decimals > 0)
+            {
+                sink.write(static_cast<std::uint8_t>('.'));
+                for (std::uint8_t i = 0; i < decimals; ++i)
+                    sink.write(static_cast<std::uint8_t>('0' + digits[i]));
+            }
+        }
+    }
+}
+
+#endif //MSP430HAL_UTIL_FORMAT_H
@@ -0,0 +1,43 @@
+#ifndef MSP430HAL_UTIL_REGISTER_H
+#define MSP430HAL_UTIL_REGISTER_H
+
+#include <msp430.h>
+#include <cstdint>
+
+#ifdef MSP430HAL_HOST_BACKEND
+#include "msp430hal/host/register.h"
+#endif
+
+namespace msp430hal
+{
+#ifdef MSP430HAL_HOST_BACKEND
+    /// \brief Type of a 8 bit peripheral register. On the host every access is forwarded to the simulated device.
+    using register8_t = host::Register<std::uint8_t>;
+
+    /// \brief Type of a 16 bit peripheral register. On the host every access is forwarded to the simulated device.
+    using register16_t = host::Register<std::uint16_t>;
+#else
+    /// \brief Type of a 8 bit peripheral register.
+    using register8_t = volatile std::uint8_t;
+
+    /// \brief Type of a 16 bit peripheral register.
+    using register16_t = volatile unsigned int;
+#endif
+
+    /// \brief Store a value at an absolute memory address, e.g. to program the flash memory.
+    ///
+    /// \tparam T The type of the value which determines the width of the access.
+    /// \param address The absolute address of the memory location.
+    /// \param value The value to store.
+    template<typename T>
+    inline void storeAt(std::uint16_t address, T value)
+    {
+#ifdef MSP430HAL_HOST_BACKEND
+        host::writeMemory(address, &value, sizeof(T));
+#else
+        *reinterpret_cast<volatile T*>(address) = value;
+#endif
+    }
+}
+
+#endif //MSP430HAL_UTIL_REGISTER_H
@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+#include <msp430.h>
+
+#include <msp430hal/cpu/clock_module.h>
+#include <msp430hal/host/device.h>
+#include <msp430hal/timer/hwtimer.h>
+#include <msp430hal/timer/watchdog_timer.h>
+#include <msp430hal/usci/i2c.h>
+
+using namespace msp430hal;
+
+namespace
+{
+    /// \brief A slave with 256 registers and an auto incremented register pointer, which counts the bytes read.
+    struct RegisterDevice : host::I2CDevice
+    {
+        std::uint8_t registers[256] = {};
+        std::uint8_t pointer = 0;
+        bool pointer_pending = false;
+        unsigned reads = 0;
+        host::Time hold = 0;
+
+        bool start(bool read) override
+        {
+            pointer_pending = !read;
+            return true;
+        }
+
+        bool write(std::uint8_t byte) override
+        {
+            if (pointer_pending)
+                pointer = byte;
+            else
+                registers[pointer++] = byte;
+            pointer_pending = false;
+            return true;
+        }
+
+        std::uint8_t read() override
+        {
+            ++reads;
+            return registers[pointer++];
+        }
+
+        host::Time holdScl() override
+        {
+            return hold;
+        }
+    };
+
+    constexpr std::uint8_t device_address = 0x48;
+    constexpr std::uint8_t absent_address = 0x21;
+
+    using I2C = usci::I2CClocked_t<0, 16000000, usci::standard_mode>;
+    /// \brief Counts SMCLK / 8, i.e. 2 MHz.
+    using Timer = timer::Timer_t<timer::timer_a, 0>;
+    /// \brief 1 ms
+    using Timeout = usci::I2CTimeout<Timer, 2000>;
+    using Master = usci::AsyncI2CMaster<I2C, 8, Timeout>;
+
+    Master* master = nullptr;
+    host::Time longest_isr = 0;
+
+    template<typename Handler>
+    void measured(Handler handler)
+    {
+        host::Time start = host::device().now();
+        handler();
+        longest_isr = std::max(longest_isr, host::device().now() - start);
+    }
+
+    void powerOn(RegisterDevice& slave)
+    {
+        host::Device& device = host::device();
+        device.powerOn();
+        timer::stopWatchdog();
+        cpu::setCalibratedFrequency<cpu::calibrated_16MHz>();
+        Timer::init(timer::continuous, timer::smclk, timer::times_8);
+        device.usciB0().attachI2CDevice(device_address, &slave);
+        device.attachInterrupt(USCIAB0TX_VECTOR, [] { measured([] { master->handleDataInterrupt(); }); });
+        device.attachInterrupt(USCIAB0RX_VECTOR, [] { measured([] { master->handleStateInterrupt(); }); });
+        longest_isr = 0;
+    }
+
+    /// \brief Run the main loop until all transactions finished, it checks the timeout every 100 µs.
+    void runUntilIdle(host::Time limit)
+    {
+        host::Device& device = host::device();
+        host::Time end = device.now() + limit;
+        __enable_interrupt();
+        while (!master->idle() && device.now() < end)
+        {
+            device.execute(1600);
+            master->service();
+        }
+        __disable_interrupt();
+    }
+
+    constexpr host::Time microsecond = host::picoseconds_per_second / 1000000;
+
+    /// \brief Writes, single and multi byte reads and an address NACK. No ISR call may wait for the bus.
+    bool transactions()
+    {
+        RegisterDevice slave;
+        powerOn(slave);
+        Master i2c_master;
+        i2c_master.init();
+        master = &i2c_master;
+
+        const std::uint8_t write[] = {0x10, 0xaa, 0xbb, 0xcc};
+        const std::uint8_t reg = 0x10;
+        std::uint8_t single = 0;
+        std::uint8_t next = 0;
+        std::uint8_t both[2] = {};
+        usci::I2CTransaction store{device_address, write, sizeof(write), nullptr, 0};
+        usci::I2CTransaction read_single{device_address, &reg, 1, &single, 1};
+        usci::I2CTransaction read_only{device_address, nullptr, 0, &next, 1};
+        usci::I2CTransaction read_both{device_address, &reg, 1, both, 2};
+        usci::I2CTransaction probe{absent_address, nullptr, 0, nullptr, 0};
+        for (usci::I2CTransaction* transaction : {&store, &read_single, &read_only, &read_both, &probe})
+            i2c_master.submit(*transaction);
+        runUntilIdle(10000 * microsecond);
+
+        bool success = true;
+        for (usci::I2CTransaction* transaction : {&store, &read_single, &read_only, &read_both})
+            success &= transaction->status == usci::I2CTransactionStatus::complete;
+        success &= probe.status == usci::I2CTransactionStatus::nack;
+        if (!success)
+            std::puts("FAIL a transaction ended with a wrong status");
+        // Every byte read from the slave must be the one requested, STOP has to prevent a further read
+        if (single != 0xaa || next != 0xbb || both[0] != 0xaa || both[1] != 0xbb || slave.reads != 4)
+        {
+            std::printf("FAIL wrong data or %u instead of 4 bytes read from the slave\n", slave.reads);
+            success = false;
+        }
+        host::Time scl_period = host::device().usciB0().sclPeriod();
+        std::printf("longest ISR call: %.2f us, SCL period %.2f us\n", static_cast<double>(longest_isr) / microsecond,
+                    static_cast<double>(scl_period) / microsecond);
+        if (longest_isr > scl_period / 4)
+        {
+            std::puts("FAIL an ISR call waited for the bus");
+            success = false;
+        }
+        return success;
+    }
+
+    /// \brief A slave which holds SCL low stalls the transaction until service() ends it, then the next
+    /// transaction runs.
+    bool stalledTransaction()
+    {
+        RegisterDevice slave;
+        powerOn(slave);
+        Master i2c_master;
+        i2c_master.init();
+        master = &i2c_master;
+
+        const std::uint8_t write[] = {0x20, 0x01};
+        const std::uint8_t reg = 0x30;
+        std::uint8_t value = 0;
+        slave.registers[reg] = 0x5a;
+        usci::I2CTransaction stalled{device_address, write, sizeof(write), nullptr, 0};
+        usci::I2CTransaction after{device_address, &reg, 1, &value, 1};
+        slave.hold = host::picoseconds_per_second;
+        i2c_master.submit(stalled);
+        i2c_master.submit(after);
+        host::Time start = host::device().now();
+        __enable_interrupt();
+        while (stalled.status == usci::I2CTransactionStatus::active && host::device().now() - start < 5000 * microsecond)
+        {
+            host::device().execute(1600);
+            i2c_master.service();
+        }
+        __disable_interrupt();
+        host::Time elapsed = host::device().now() - start;
+        slave.hold = 0;
+        runUntilIdle(10000 * microsecond);
+
+        std::printf("stalled transaction ended after %.0f us\n", static_cast<double>(elapsed) / microsecond);
+        // 1 ms deadline, 100 µs between the checks and the bus recovery
+        bool success = stalled.status == usci::I2CTransactionStatus::timeout && elapsed < 1400 * microsecond;
+        success &= after.status == usci::I2CTransactionStatus::complete && value == 0x5a;
+        if (!success)
+            std::puts("FAIL the stalled transaction was not ended in time");
+        return success;
+    }
+
+    /// \brief A transaction which loses the arbitration ends with that status. The next one waits until the other
+    /// master released the bus and runs with the USCI back in master mode.
+    bool arbitrationLost()
+    {
+        RegisterDevice slave;
+        powerOn(slave);
+        Master i2c_master;
+        i2c_master.init();
+        master = &i2c_master;
+
+        const std::uint8_t write[] = {0x40, 0x01};
+        const std::uint8_t reg = 0x40;
+        std::uint8_t value = 0;
+        slave.registers[reg] = 0x5a;
+        usci::I2CTransaction lost{device_address, write, sizeof(write), nullptr, 0};
+        usci::I2CTransaction after{device_address, &reg, 1, &value, 1};
+        i2c_master.submit(lost);
+        i2c_master.submit(after);
+        host::UsciB& usci = host::device().usciB0();
+        __enable_interrupt();
+        // 10 µs into the address phase
+        host::device().execute(160);
+        usci.loseArbitration();
+        for (int check = 0; check < 5; ++check)
+        {
+            host::device().execute(1600);
+            i2c_master.service();
+        }
+        __disable_interrupt();
+        bool success = lost.status == usci::I2CTransactionStatus::arbitration_lost;
+        success &= after.status == usci::I2CTransactionStatus::active && slave.reads == 0;
+        usci.releaseI2CBus();
+        runUntilIdle(10000 * microsecond);
+
+        success &= after.status == usci::I2CTransactionStatus::complete && value == 0x5a;
+        if (!success)
+            std::puts("FAIL the transaction after a lost arbitration did not wait for the bus or failed");
+        return success;
+    }
+}
+
+/// Runs queued transactions of the interrupt driven I2C master at 16 MHz MCLK and 100 kHz SCL. Fails if data or
+/// statuses are wrong, if an ISR call waits for the bus, if a transaction to a slave which holds SCL low is not
+/// ended by the timeout, or if the master does not recover from a lost arbitration.
+int main()
+{
+    bool success = transactions();
+    success &= stalledTransaction();
+    success &= arbitrationLost();
+    std::puts(success ? "AsyncI2CMaster correct" : "AsyncI2CMaster failure");
+    return success ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include <msp430.h>
+
+#include <msp430hal/cpu/clock_module.h>
+#include <msp430hal/host/device.h>
+#include <msp430hal/timer/watchdog_timer.h>
+#include <msp430hal/usci/spi.h>
+
+using namespace msp430hal;
+
+namespace
+{
+    /// \brief Answers every character with its complement, so the received data can be checked.
+    struct ComplementDevice : host::SpiDevice
+    {
+        std::size_t exchanged = 0;
+
+        std::uint8_t exchange(std::uint8_t mosi) override
+        {
+            ++exchanged;
+            return static_cast<std::uint8_t>(~mosi);
+        }
+    };
+
+    constexpr std::size_t transaction_length = 64;
+
+    using ChipSelectPin = gpio::GPIOPin<gpio::port_2, gpio::p_0, gpio::Mode::output>;
+
+    template<std::uint16_t prescaler>
+    using Spi = usci::SPI_t<usci::UsciModule::usci_b, 0, usci::master_3pin, usci::msb_8bit,
+                            usci::active_high_leading_edge, usci::smclk, prescaler>;
+
+    template<std::uint16_t prescaler>
+    using Master = usci::AsyncSPIMaster<Spi<prescaler>, 4>;
+
+    template<std::uint16_t prescaler>
+    Master<prescaler>* master = nullptr;
+
+    bool correct(const usci::SPITransaction& transaction)
+    {
+        for (std::size_t i = 0; i < transaction.length; ++i)
+        {
+            if (transaction.rx[i] != static_cast<std::uint8_t>(~transaction.tx[i]))
+                return false;
+        }
+        return true;
+    }
+
+    /// \brief Run two queued transactions at 16 MHz MCLK = BRCLK.
+    ///
+    /// \param in_time Does the prescaler leave the ISR enough time to keep up with the bus?
+    template<std::uint16_t prescaler>
+    bool run(bool in_time)
+    {
+        host::Device& device = host::device();
+        device.powerOn();
+        timer::stopWatchdog();
+        cpu::setCalibratedFrequency<cpu::calibrated_16MHz>();
+        ComplementDevice slave;
+        device.usciB0().attachSpiDevice(&slave);
+        ChipSelectPin::init();
+        ChipSelectPin::set();
+
+        Master<prescaler> spi_master;
+        spi_master.init();
+        master<prescaler> = &spi_master;
+        device.attachInterrupt(USCIAB0RX_VECTOR, [] { master<prescaler>->handleRxInterrupt(); });
+        __enable_interrupt();
+
+        std::vector<std::uint8_t> tx(transaction_length);
+        for (std::size_t i = 0; i < tx.size(); ++i)
+            tx[i] = static_cast<std::uint8_t>(i * 7 + 3);
+        std::vector<std::uint8_t> rx_first(transaction_length);
+        std::vector<std::uint8_t> rx_second(transaction_length);
+        usci::SPITransaction first{usci::chipSelect<ChipSelectPin>(), tx.data(), rx_first.data(), tx.size()};
+        usci::SPITransaction second{usci::chipSelect<ChipSelectPin>(), tx.data(), rx_second.data(), tx.size()};
+        spi_master.submit(first);
+        spi_master.submit(second);
+
+        // Far more than the bus needs for both transactions at any of the prescalers
+        for (unsigned i = 0; i < 1000 && !spi_master.idle(); ++i)
+            device.execute(100);
+        __disable_interrupt();
+
+        bool success = true;
+        if (!spi_master.idle() || slave.exchanged != 2 * transaction_length)
+        {
+            std::printf("FAIL prescaler %u: the transactions did not finish\n", prescaler);
+            success = false;
+        }
+        if (!(device.port(2).level() & BIT0))
+        {
+            std::printf("FAIL prescaler %u: the chip select is still asserted\n", prescaler);
+            success = false;
+        }
+        for (const usci::SPITransaction* transaction : {&first, &second})
+        {
+            bool data_correct = correct(*transaction);
+            std::printf("prescaler %u: status %u, data %s\n", prescaler, static_cast<unsigned>(transaction->status),
+                        data_correct ? "correct" : "wrong");
+            if (transaction->status == usci::SPITransactionStatus::complete && !data_correct)
+            {
+                std::printf("FAIL prescaler %u: characters were lost without an overrun status\n", prescaler);
+                success = false;
+            }
+            else if (transaction->status != usci::SPITransactionStatus::complete &&
+                     transaction->status != usci::SPITransactionStatus::overrun)
+            {
+                std::printf("FAIL prescaler %u: the transaction did not complete\n", prescaler);
+                success = false;
+            }
+            else if (in_time && transaction->status != usci::SPITransactionStatus::complete)
+            {
+                std::printf("FAIL prescaler %u: overrun although the ISR can keep up\n", prescaler);
+                success = false;
+            }
+        }
+        return success;
+    }
+}
+
+/// Runs queued transactions of the interrupt driven SPI master at prescalers where the ISR is too slow (1, 2) and
+/// where it keeps up (4). Fails if a transaction hangs, keeps its chip select asserted or loses characters without
+/// reporting an overrun.
+int main()
+{
+    bool success = run<1>(false);
+    success &= run<2>(false);
+    success &= run<4>(true);
+    std::puts(success ? "AsyncSPIMaster correct" : "AsyncSPIMaster failure");
+    return success ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <msp430hal/memory/block_pool.h>
+
+using namespace msp430hal;
+
+namespace
+{
+    /// \brief All blocks can be allocated once, are aligned, do not overlap and belong to the pool.
+    template<std::size_t block_size, std::size_t block_count>
+    bool allocatesEveryBlock()
+    {
+        memory::block_pool<block_size, block_count> pool;
+        void* blocks[block_count] = {};
+        bool success = true;
+        for (std::size_t i = 0; i < block_count; ++i)
+        {
+            blocks[i] = pool.allocate();
+            if (blocks[i] == nullptr || !pool.owns(blocks[i]) || reinterpret_cast<std::uintptr_t>(blocks[i]) % 2 != 0)
+            {
+                std::printf("FAIL block %zu of %zu byte blocks is invalid\n", i, block_size);
+                return false;
+            }
+            // Fill the whole block, which must neither corrupt the free list nor another block
+            std::memset(blocks[i], static_cast<int>(i + 1), block_size);
+        }
+        for (std::size_t i = 0; i < block_count; ++i)
+        {
+            auto* bytes = static_cast<std::uint8_t*>(blocks[i]);
+            for (std::size_t j = 0; j < block_size; ++j)
+                success &= bytes[j] == static_cast<std::uint8_t>(i + 1);
+        }
+        if (!success)
+            std::printf("FAIL %zu byte blocks overlap\n", block_size);
+
+        if (pool.allocate() != nullptr || pool.failed_allocations() != 1 || pool.available() != 0 ||
+            pool.in_use() != block_count)
+        {
+            std::printf("FAIL the exhausted pool of %zu byte blocks still allocated\n", block_size);
+            success = false;
+        }
+        for (void* block : blocks)
+            pool.deallocate(block);
+        if (pool.in_use() != 0 || pool.available() != block_count)
+        {
+            std::printf("FAIL not all %zu byte blocks were returned\n", block_size);
+            success = false;
+        }
+        return success;
+    }
+
+    /// \brief Freed blocks are reused last in first out, the statistics follow the allocations.
+    bool reuseAndStatistics()
+    {
+        memory::block_pool<32, 4> pool;
+        void* first = pool.allocate();
+        void* second = pool.allocate();
+        void* third = pool.allocate();
+        pool.deallocate(second);
+        pool.deallocate(nullptr);
+        bool success = pool.allocate() == second;
+        pool.deallocate(first);
+        pool.deallocate(third);
+        int on_stack = 0;
+        success &= !pool.owns(&on_stack);
+        if (!success)
+            std::puts("FAIL freed blocks were not reused");
+
+        if (pool.in_use() != 1 || pool.high_water_mark() != 3 || pool.failed_allocations() != 0)
+        {
+            std::printf("FAIL %u in use and a high water mark of %u instead of 1 and 3\n", pool.in_use(),
+                        pool.high_water_mark());
+            success = false;
+        }
+        pool.reset_statistics();
+        if (pool.high_water_mark() != 1)
+        {
+            std::puts("FAIL the high water mark was not reset to the blocks in use");
+            success = false;
+        }
+        return success;
+    }
+
+    /// \brief The failure counter saturates instead of wrapping around.
+    bool saturatingFailures()
+    {
+        memory::block_pool<4, 1> pool;
+        void* block = pool.allocate();
+        for (std::uint32_t i = 0; i < 0x10005; ++i)
+            pool.allocate();
+        bool success = pool.failed_allocations() == 0xffff;
+        pool.deallocate(block);
+        pool.reset_statistics();
+        success &= pool.failed_allocations() == 0 && pool.high_water_mark() == 0;
+        if (!success)
+            std::puts("FAIL the failure counter did not saturate");
+        return success;
+    }
+}
+
+/// Exercises the fixed block allocator with block sizes below, at and above the size of the free list link. Fails if
+/// blocks overlap or are reused wrongly, or if the counters are wrong.
+int main()
+{
+    bool success = allocatesEveryBlock<1, 5>();
+    success &= allocatesEveryBlock<sizeof(void*), 300>();
+    success &= allocatesEveryBlock<37, 8>();
+    success &= reuseAndStatistics();
+    success &= saturatingFailures();
+    std::puts(success ? "block_pool correct" : "block_pool failure");
+    return success ? 0 : 1;
+}
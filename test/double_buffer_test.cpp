@@ -0,0 +1,116 @@
+#include <cstdint>
+#include <cstdio>
+
+#include <msp430.h>
+
+#include <msp430hal/cpu/clock_module.h>
+#include <msp430hal/host/device.h>
+#include <msp430hal/memory/double_buffer.h>
+#include <msp430hal/timer/hwtimer.h>
+#include <msp430hal/timer/watchdog_timer.h>
+
+using namespace msp430hal;
+
+namespace
+{
+    /// \brief The halves are handed over in order, a missing release drops and counts the following samples.
+    bool handover()
+    {
+        memory::double_buffer<std::uint16_t, 4> buffer;
+        bool success = true;
+        for (std::uint16_t i = 0; i < 3; ++i)
+            success &= !buffer.push(i);
+        success &= !buffer.ready() && buffer.ready_block() == nullptr;
+        success &= buffer.push(3) && buffer.ready();
+        const std::uint16_t* first = buffer.ready_block();
+        success &= first != nullptr && first[0] == 0 && first[3] == 3;
+        if (!success)
+            std::puts("FAIL the first block was not handed over");
+
+        // The consumer is late: the second half fills up and waits, further samples are dropped
+        for (std::uint16_t i = 4; i < 10; ++i)
+            buffer.push(i);
+        if (buffer.ready_block() != first || buffer.overruns() != 2)
+        {
+            std::printf("FAIL %u overruns instead of 2\n", buffer.overruns());
+            success = false;
+        }
+        buffer.release();
+        // The waiting half is handed over with the next sample
+        if (!buffer.push(10) || buffer.ready_block()[0] != 4 || buffer.ready_block()[3] != 7)
+        {
+            std::puts("FAIL the waiting block was not handed over after the release");
+            success = false;
+        }
+        buffer.release();
+        buffer.clear_overruns();
+        for (std::uint16_t i = 11; i < 14; ++i)
+            buffer.push(i);
+        if (!buffer.ready() || buffer.ready_block()[0] != 10 || buffer.ready_block()[3] != 13 || buffer.overruns() != 0)
+        {
+            std::puts("FAIL the block after the waiting one is wrong");
+            success = false;
+        }
+        return success;
+    }
+
+    using Buffer = memory::double_buffer<std::uint16_t, 32>;
+    using Timer = timer::Timer_t<timer::timer_a, 0>;
+
+    Buffer* samples = nullptr;
+    std::uint16_t next_sample = 0;
+
+    /// \brief A timer ISR produces a sample every 20 µs while the main loop sleeps until a block is ready. Every sample
+    /// has to arrive in order and no sample may be dropped.
+    bool stream()
+    {
+        host::Device& device = host::device();
+        device.powerOn();
+        timer::stopWatchdog();
+        cpu::setCalibratedFrequency<cpu::calibrated_16MHz>();
+        Buffer buffer;
+        samples = &buffer;
+        next_sample = 0;
+        device.attachInterrupt(TIMER0_A0_VECTOR, []
+        {
+            if (samples->push(next_sample++))
+                __bic_SR_register_on_exit(LPM0_bits);
+        });
+        Timer::setCompareValue<0>(320 - 1);
+        Timer::enableCaptureCompareInterrupt<0>();
+        Timer::init(timer::up, timer::smclk, timer::times_1);
+
+        bool success = true;
+        std::uint16_t expected = 0;
+        for (unsigned block = 0; block < 50 && success; ++block)
+        {
+            __bis_SR_register(LPM0_bits | GIE);
+            const std::uint16_t* ready = buffer.ready_block();
+            if (ready == nullptr)
+            {
+                std::puts("FAIL woken up without a ready block");
+                return false;
+            }
+            for (std::size_t i = 0; i < Buffer::block_size_value; ++i)
+                success &= ready[i] == expected++;
+            buffer.release();
+        }
+        __disable_interrupt();
+        if (!success || buffer.overruns() != 0)
+        {
+            std::printf("FAIL samples were lost or reordered, %u overruns\n", buffer.overruns());
+            success = false;
+        }
+        return success;
+    }
+}
+
+/// Exercises the ping-pong buffer directly and with a timer ISR as producer at 16 MHz MCLK. Fails if a block is
+/// handed over too early, too late or with wrong samples, or if the overruns are not counted.
+int main()
+{
+    bool success = handover();
+    success &= stream();
+    std::puts(success ? "double_buffer correct" : "double_buffer failure");
+    return success ? 0 : 1;
+}
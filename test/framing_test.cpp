@@ -0,0 +1,114 @@
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include <msp430hal/memory/block_pool.h>
+#include <msp430hal/memory/ring_buffer.h>
+#include <msp430hal/protocol/framing.h>
+
+using namespace msp430hal;
+
+namespace
+{
+    constexpr std::size_t max_payload = 32;
+
+    using Pool = memory::block_pool<max_payload, 4>;
+    using Stream = memory::byte_ring_buffer<256>;
+
+    struct Received
+    {
+        const std::uint8_t* data;
+        std::size_t length;
+    };
+
+    const std::vector<std::vector<std::uint8_t>> payloads{
+        {0x01, 0x02, 0x03},
+        {0x00, 0xc0, 0xdb, 0x00},
+        {0x7e, 0x7f, 0x80, 0x81, 0x82, 0x83},
+    };
+
+    /// \brief Decode all frames of the stream like a receive ISR, which passes every complete frame on in its own
+    /// block of the pool.
+    template<typename Decoder>
+    std::vector<Received> decode(Stream& stream, Pool& pool)
+    {
+        std::vector<Received> received;
+        Decoder decoder(static_cast<std::uint8_t*>(pool.allocate()), max_payload);
+        std::uint8_t byte;
+        while (stream.get(byte))
+        {
+            if (decoder.push(byte) != protocol::FrameStatus::complete)
+                continue;
+            std::size_t length = decoder.length();
+            const std::uint8_t* data = decoder.setBuffer(static_cast<std::uint8_t*>(pool.allocate()), max_payload);
+            received.push_back({data, length});
+        }
+        return received;
+    }
+
+    /// \brief The payloads of earlier frames must survive the decoding of the following ones.
+    template<typename Decoder, typename Encode>
+    bool keepsCompleteFrames(const char* name, Encode encode)
+    {
+        Stream stream;
+        for (const std::vector<std::uint8_t>& payload : payloads)
+            encode(stream, payload.data(), payload.size());
+        Pool pool;
+        std::vector<Received> received = decode<Decoder>(stream, pool);
+
+        bool success = received.size() == payloads.size();
+        for (std::size_t i = 0; success && i < received.size(); ++i)
+        {
+            success &= received[i].length == payloads[i].size() &&
+                       std::vector<std::uint8_t>(received[i].data, received[i].data + received[i].length) == payloads[i];
+        }
+        if (!success)
+            std::printf("FAIL %s: the payload of a complete frame was overwritten\n", name);
+        return success;
+    }
+
+    /// \brief A frame which is in progress while the buffer is exchanged is reported as invalid, the next one is fine.
+    bool invalidatesFrameInProgress()
+    {
+        Stream stream;
+        protocol::encodeCobsFrame(stream, payloads[0].data(), payloads[0].size());
+        protocol::encodeCobsFrame(stream, payloads[1].data(), payloads[1].size());
+        std::uint8_t first[max_payload];
+        std::uint8_t second[max_payload];
+        protocol::CobsDecoder decoder(first, max_payload);
+
+        std::uint8_t byte;
+        std::vector<protocol::FrameStatus> results;
+        for (int i = 0; stream.get(byte); ++i)
+        {
+            if (i == 3)
+                decoder.setBuffer(second, max_payload);
+            protocol::FrameStatus status = decoder.push(byte);
+            if (status != protocol::FrameStatus::incomplete)
+                results.push_back(status);
+        }
+        bool success = results.size() == 2 && results[0] == protocol::FrameStatus::invalid &&
+                       results[1] == protocol::FrameStatus::complete && decoder.data() == second &&
+                       std::vector<std::uint8_t>(second, second + decoder.length()) == payloads[1];
+        if (!success)
+            std::puts("FAIL the frame received while exchanging the buffer was not rejected");
+        return success;
+    }
+}
+
+/// Decodes COBS and SLIP streams the way a receive ISR does and hands every complete frame to the main loop in its own
+/// buffer. Fails if a payload is overwritten by a following frame.
+int main()
+{
+    bool success = keepsCompleteFrames<protocol::CobsDecoder>("COBS", [](Stream& stream, const std::uint8_t* data, std::size_t length)
+    {
+        protocol::encodeCobsFrame(stream, data, length);
+    });
+    success &= keepsCompleteFrames<protocol::SlipDecoder>("SLIP", [](Stream& stream, const std::uint8_t* data, std::size_t length)
+    {
+        protocol::encodeSlipFrame(stream, data, length);
+    });
+    success &= invalidatesFrameInProgress();
+    std::puts(success ? "Frame decoders correct" : "Frame decoder failure");
+    return success ? 0 : 1;
+}
@@ -0,0 +1,276 @@
+#include <cstdint>
+#include <cstdio>
+
+#include <msp430.h>
+
+#include <msp430hal/cpu/clock_module.h>
+#include <msp430hal/host/device.h>
+#include <msp430hal/timer/hwtimer.h>
+#include <msp430hal/timer/watchdog_timer.h>
+#include <msp430hal/usci/i2c.h>
+
+using namespace msp430hal;
+
+namespace
+{
+    /// \brief A slave with 256 registers and an auto incremented register pointer.
+    struct RegisterDevice : host::I2CDevice
+    {
+        std::uint8_t registers[256] = {};
+        std::uint8_t pointer = 0;
+        bool pointer_pending = false;
+        host::Time hold = 0;
+
+        bool start(bool read) override
+        {
+            pointer_pending = !read;
+            return true;
+        }
+
+        bool write(std::uint8_t byte) override
+        {
+            if (pointer_pending)
+                pointer = byte;
+            else
+                registers[pointer++] = byte;
+            pointer_pending = false;
+            return true;
+        }
+
+        std::uint8_t read() override
+        {
+            return registers[pointer++];
+        }
+
+        host::Time holdScl() override
+        {
+            return hold;
+        }
+    };
+
+    /// \brief The pull-up resistors of SCL and SDA and a slave which holds SDA low until it saw some SCL pulses.
+    ///
+    /// The lines are sampled at every register access, which is often enough for recoverBus() as it toggles the
+    /// lines by register writes.
+    class StuckSlave : public host::AccessListener
+    {
+    public:
+        explicit StuckSlave(unsigned pulses_until_release) : m_pulses_until_release(pulses_until_release)
+        {
+            port().drive(scl, true);
+            port().drive(sda, false);
+            m_level = port().level();
+            host::addAccessListener(this);
+        }
+
+        ~StuckSlave() override
+        {
+            host::removeAccessListener(this);
+            port().release(scl | sda);
+        }
+
+        void onAccess(const host::AccessEvent&) override
+        {
+            std::uint8_t level = port().level();
+            bool scl_fell = (m_level & scl) && !(level & scl);
+            bool sda_rose = !(m_level & sda) && (level & sda);
+            if (sda_rose && (level & scl))
+                ++stops;
+            if (scl_fell && ++pulses == m_pulses_until_release)
+                port().drive(sda, true);
+            m_level = port().level();
+        }
+
+        unsigned pulses = 0;
+        unsigned stops = 0;
+
+    private:
+        static constexpr std::uint8_t scl = BIT6;
+        static constexpr std::uint8_t sda = BIT7;
+
+        static host::GpioPort& port()
+        {
+            return host::device().port(1);
+        }
+
+        unsigned m_pulses_until_release;
+        std::uint8_t m_level = 0;
+    };
+
+    constexpr std::uint8_t device_address = 0x48;
+    constexpr std::uint8_t absent_address = 0x21;
+
+    /// \brief Counts SMCLK / 8, i.e. 2 MHz.
+    using Timer = timer::Timer_t<timer::timer_a, 0>;
+    /// \brief 1 ms
+    using Timeout = usci::I2CTimeout<Timer, 2000>;
+    constexpr std::uint16_t ucbr = usci::I2CClockDivider<16000000, usci::standard_mode>::value;
+    using Master = usci::BufferedBlockingI2CMaster<0, 16, usci::smclk, ucbr, true, usci::addressing_7, false, 0x0000,
+                                                   Timeout>;
+    /// \brief A long frame takes more than the 1 ms timeout at 100 kHz.
+    using UnboundedMaster = usci::BufferedBlockingI2CMaster<0, 16, usci::smclk, ucbr, true, usci::addressing_7, false,
+                                                            0x0000, usci::I2CNoTimeout>;
+
+    constexpr host::Time microsecond = host::picoseconds_per_second / 1000000;
+
+    void powerOn(RegisterDevice& slave)
+    {
+        host::Device& device = host::device();
+        device.powerOn();
+        timer::stopWatchdog();
+        cpu::setCalibratedFrequency<cpu::calibrated_16MHz>();
+        Timer::init(timer::continuous, timer::smclk, timer::times_8);
+        device.usciB0().attachI2CDevice(device_address, &slave);
+    }
+
+    /// \brief Register writes and reads into the buffer and into the caller's memory, and an address NACK.
+    bool transfers()
+    {
+        RegisterDevice slave;
+        powerOn(slave);
+        Master master;
+        master.init();
+
+        const std::uint8_t data[] = {0x11, 0x22, 0x33};
+        std::uint8_t read[3] = {};
+        bool success = master.writeRegister(device_address, 0x40, data, sizeof(data)) == usci::I2CStatus::ok;
+        success &= master.readRegister(device_address, 0x40, read, sizeof(read)) == usci::I2CStatus::ok;
+        success &= master.readRegister(device_address, 0x41, 2) == usci::I2CStatus::ok;
+        success &= master.writeByte(absent_address, 0x00) == usci::I2CStatus::nack;
+        if (!success)
+            std::puts("FAIL a transfer ended with a wrong status");
+        std::uint8_t buffered[2] = {};
+        master.buffer.read(buffered, sizeof(buffered));
+        if (read[0] != 0x11 || read[1] != 0x22 || read[2] != 0x33 || buffered[0] != 0x22 || buffered[1] != 0x33)
+        {
+            std::puts("FAIL wrong data read from the slave");
+            success = false;
+        }
+        return success;
+    }
+
+    /// \brief A 14 byte register frame read with a repeated start takes at most 159 SCL periods.
+    ///
+    /// The bus traffic alone is 156 periods: start, address and register, repeated start, address, 14 bytes and stop.
+    bool frameRead()
+    {
+        RegisterDevice slave;
+        powerOn(slave);
+        UnboundedMaster master;
+        master.init();
+        for (std::uint8_t i = 0; i < 14; ++i)
+            slave.registers[0x3b + i] = i + 1;
+
+        std::uint8_t frame[14] = {};
+        host::Time start = host::device().now();
+        bool success = master.readRegister(device_address, 0x3b, frame, sizeof(frame)) == usci::I2CStatus::ok;
+        double periods = static_cast<double>(host::device().now() - start) / host::device().usciB0().sclPeriod();
+        std::printf("14 byte register read took %.1f SCL periods\n", periods);
+        for (std::uint8_t i = 0; i < 14; ++i)
+            success &= frame[i] == i + 1;
+        if (!success)
+            std::puts("FAIL wrong frame read");
+        if (periods > 159)
+        {
+            std::puts("FAIL the register read took too long");
+            success = false;
+        }
+        return success;
+    }
+
+    /// \brief I2CClocked_t runs the bus at exactly 400 kHz from the 16 MHz SMCLK.
+    bool fastModeClock()
+    {
+        using FastI2C = usci::I2CClocked_t<0, 16000000, usci::fast_mode>;
+        static_assert(usci::I2CClockDivider<16000000, usci::fast_mode>::value == 40);
+
+        RegisterDevice slave;
+        powerOn(slave);
+        FastI2C::init();
+        FastI2C::enable();
+        host::Time period = host::device().usciB0().sclPeriod();
+        std::printf("fast mode SCL period: %.2f us\n", static_cast<double>(period) / microsecond);
+        bool success = period == 5 * microsecond / 2;
+        if (!success)
+            std::puts("FAIL the fast mode SCL period is not 2.5 us");
+        return success;
+    }
+
+    /// \brief A slave which holds SCL low ends the transfer with a timeout, the next transfer succeeds.
+    bool stalledSlave()
+    {
+        RegisterDevice slave;
+        powerOn(slave);
+        Master master;
+        master.init();
+        slave.registers[0x30] = 0x5a;
+
+        slave.hold = host::picoseconds_per_second;
+        host::Time start = host::device().now();
+        usci::I2CStatus status = master.writeByte(device_address, 0x20);
+        host::Time elapsed = host::device().now() - start;
+        slave.hold = 0;
+        std::uint8_t value = 0;
+        usci::I2CStatus after = master.readRegister(device_address, 0x30, &value, 1);
+
+        std::printf("stalled transfer ended after %.0f us\n", static_cast<double>(elapsed) / microsecond);
+        // 1 ms deadline plus eleven SCL periods for the recovery and the register accesses around it
+        bool success = status == usci::I2CStatus::timeout && elapsed >= 1000 * microsecond &&
+                       elapsed < 1130 * microsecond;
+        success &= after == usci::I2CStatus::ok && value == 0x5a;
+        if (!success)
+            std::puts("FAIL the stalled transfer was not ended in time");
+        return success;
+    }
+
+    /// \brief recoverBus() clocks SCL until the slave releases SDA, but at most nine times, then generates a stop
+    /// condition and gives the pins back to the USCI.
+    ///
+    /// The stop condition takes one more SCL pulse. It only appears on the bus if the slave released SDA.
+    bool stuckSda(unsigned pulses_until_release, unsigned expected_pulses, unsigned expected_stops)
+    {
+        RegisterDevice slave;
+        powerOn(slave);
+        Master master;
+        master.init();
+
+        bool success = true;
+        {
+            StuckSlave stuck(pulses_until_release);
+            Master::recoverBus();
+            if (stuck.pulses != expected_pulses + 1 || stuck.stops != expected_stops)
+            {
+                std::printf("FAIL %u SCL pulses and %u stop conditions instead of %u and %u\n", stuck.pulses,
+                            stuck.stops, expected_pulses + 1, expected_stops);
+                success = false;
+            }
+        }
+        if ((P1SEL & (BIT6 | BIT7)) != (BIT6 | BIT7) || (P1SEL2 & (BIT6 | BIT7)) != (BIT6 | BIT7))
+        {
+            std::puts("FAIL the pins were not given back to the USCI");
+            success = false;
+        }
+        if (master.writeByte(device_address, 0x00) != usci::I2CStatus::ok)
+        {
+            std::puts("FAIL the bus does not work after the recovery");
+            success = false;
+        }
+        return success;
+    }
+}
+
+/// Runs the blocking I2C master at 16 MHz MCLK and 100 kHz SCL, mostly with a 1 ms timeout. Fails if data or
+/// statuses are wrong, if a register frame read needs more than 159 SCL periods, if the fast mode SCL period is not
+/// 2.5 us, if a stalled transfer is not ended by the timeout or if the bus recovery does not free SDA.
+int main()
+{
+    bool success = transfers();
+    success &= frameRead();
+    success &= fastModeClock();
+    success &= stalledSlave();
+    // The slave releases SDA after three pulses; one which never does is given up after nine
+    success &= stuckSda(3, 3, 1);
+    success &= stuckSda(100, 9, 0);
+    std::puts(success ? "BufferedBlockingI2CMaster correct" : "BufferedBlockingI2CMaster failure");
+    return success ? 0 : 1;
+}
@@ -0,0 +1,154 @@
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include <msp430.h>
+
+#include <msp430hal/cpu/clock_module.h>
+#include <msp430hal/host/device.h>
+#include <msp430hal/timer/watchdog_timer.h>
+#include <msp430hal/usci/i2c.h>
+
+using namespace msp430hal;
+
+namespace
+{
+    constexpr std::uint8_t own_address = 0x42;
+    constexpr std::uint8_t other_address = 0x43;
+
+    using I2C = usci::I2C_t<0, usci::smclk, 1, false, usci::addressing_7, false, own_address>;
+    using Slave = usci::I2CRegisterSlave<I2C, 16>;
+
+    Slave* slave = nullptr;
+    unsigned starts = 0;
+    unsigned reads = 0;
+    unsigned stops = 0;
+    std::uint8_t stop_register = 0;
+    std::uint8_t stop_written = 0;
+
+    void onStart(bool read)
+    {
+        ++starts;
+        if (read)
+            ++reads;
+    }
+
+    void onStop(std::uint8_t first_register, std::uint8_t written)
+    {
+        ++stops;
+        stop_register = first_register;
+        stop_written = written;
+    }
+
+    void powerOn()
+    {
+        host::Device& device = host::device();
+        device.powerOn();
+        timer::stopWatchdog();
+        cpu::setCalibratedFrequency<cpu::calibrated_16MHz>();
+        device.attachInterrupt(USCIAB0TX_VECTOR, [] { slave->handleDataInterrupt(); });
+        device.attachInterrupt(USCIAB0RX_VECTOR, [] { slave->handleStateInterrupt(); });
+        starts = reads = stops = 0;
+    }
+
+    /// \brief Let an external master write data and read read_size bytes at the given SCL frequency.
+    std::vector<std::uint8_t> transfer(std::uint8_t address, std::vector<std::uint8_t> data, std::size_t read_size,
+                                       std::uint32_t bit_rate)
+    {
+        host::UsciB& usci = host::device().usciB0();
+        std::size_t before = usci.slaveResponses().size();
+        usci.i2cMasterTransfer(address, data.data(), data.size(), read_size, bit_rate);
+        __enable_interrupt();
+        while (usci.slaveTransferPending())
+            host::device().execute(1600);
+        host::device().execute(1600);
+        __disable_interrupt();
+        return {usci.slaveResponses().begin() + before, usci.slaveResponses().end()};
+    }
+
+    /// \brief Register writes through the write mask, reads with the auto incremented pointer and the callbacks.
+    bool registerMap()
+    {
+        powerOn();
+        Slave register_slave(onStart, onStop);
+        slave = &register_slave;
+        for (std::uint8_t i = 0; i < 16; ++i)
+            register_slave.registers[i] = 0xa0 + i;
+        register_slave.write_mask[3] = 0x0f;
+        register_slave.write_mask[4] = 0x00;
+        register_slave.init();
+
+        bool success = true;
+        transfer(own_address, {0x02, 0x11, 0x22, 0x33}, 0, usci::fast_mode);
+        if (register_slave.registers[2] != 0x11 || register_slave.registers[3] != 0xa2 ||
+            register_slave.registers[4] != 0xa4 || register_slave.pointer() != 5)
+        {
+            std::puts("FAIL the write did not respect the write mask");
+            success = false;
+        }
+        if (starts != 1 || reads != 0 || stops != 1 || stop_register != 2 || stop_written != 3)
+        {
+            std::printf("FAIL callbacks: %u starts, %u stops, first register %u, %u written\n", starts, stops,
+                        stop_register, stop_written);
+            success = false;
+        }
+
+        // Two reads from the same register, then a read across the end of the map
+        std::vector<std::uint8_t> first = transfer(own_address, {0x00}, 3, usci::fast_mode);
+        std::vector<std::uint8_t> second = transfer(own_address, {}, 2, usci::fast_mode);
+        std::vector<std::uint8_t> wrapped = transfer(own_address, {0x0f}, 2, usci::fast_mode);
+        if (first != std::vector<std::uint8_t>{0xa0, 0xa1, 0x11} || second != std::vector<std::uint8_t>{0xa2, 0xa4} ||
+            wrapped != std::vector<std::uint8_t>{0xaf, 0xa0})
+        {
+            std::puts("FAIL wrong bytes read from the register map");
+            success = false;
+        }
+        if (reads != 3 || stops != 4 || stop_written != 0)
+        {
+            std::puts("FAIL the reads were not reported by the callbacks");
+            success = false;
+        }
+
+        // Another address must neither be acknowledged nor reach the driver
+        transfer(other_address, {0x00, 0x55}, 0, usci::fast_mode);
+        if (host::device().usciB0().i2cAddressNacks() != 1 || register_slave.registers[0] != 0xa0 || starts != 6)
+        {
+            std::puts("FAIL a transfer to another address reached the slave");
+            success = false;
+        }
+        return success;
+    }
+
+    /// \brief A 16 MHz CPU serves a 400 kHz master without holding SCL low, also in burst reads.
+    bool noStretching()
+    {
+        powerOn();
+        Slave register_slave;
+        slave = &register_slave;
+        register_slave.init();
+
+        transfer(own_address, {0x00, 1, 2, 3, 4, 5, 6, 7, 8}, 0, usci::fast_mode);
+        std::vector<std::uint8_t> burst = transfer(own_address, {0x00}, 14, usci::fast_mode);
+        host::Time stretch = host::device().usciB0().i2cStretchTime();
+        std::printf("SCL held low for %llu ps at 400 kHz\n", static_cast<unsigned long long>(stretch));
+        bool success = burst.size() == 14 && burst[0] == 1 && burst[7] == 8 && burst[8] == 0;
+        if (!success)
+            std::puts("FAIL wrong burst read");
+        if (stretch != 0)
+        {
+            std::puts("FAIL the slave stretched the clock");
+            success = false;
+        }
+        return success;
+    }
+}
+
+/// Plays an external master against the register file slave at 16 MHz MCLK and 400 kHz SCL. Fails if the write mask,
+/// the register pointer or the callbacks misbehave, or if the slave holds SCL low at all.
+int main()
+{
+    bool success = registerMap();
+    success &= noStretching();
+    std::puts(success ? "I2CRegisterSlave correct" : "I2CRegisterSlave failure");
+    return success ? 0 : 1;
+}
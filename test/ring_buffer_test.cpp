@@ -0,0 +1,264 @@
+#include <cstdint>
+#include <cstdio>
+#include <type_traits>
+
+#include <msp430hal/memory/ring_buffer.h>
+
+using namespace msp430hal;
+
+namespace
+{
+    /// \brief The free running indices wrap around many times while the buffer stays partially filled, a full buffer
+    /// rejects further bytes.
+    template<std::size_t capacity>
+    bool wrapAround()
+    {
+        memory::byte_ring_buffer<capacity> buffer;
+        bool success = true;
+        std::uint8_t next_in = 0;
+        std::uint8_t next_out = 0;
+        // Enough rounds to wrap 16 bit indices as well
+        for (std::uint32_t round = 0; round < 0x11000; ++round)
+        {
+            success &= buffer.insert(next_in++);
+            if (buffer.full())
+                success &= buffer.get() == next_out++;
+        }
+        if (!success || buffer.size() != capacity - 1)
+        {
+            std::printf("FAIL bytes were lost or reordered across the index wrap around at capacity %zu\n", capacity);
+            success = false;
+        }
+
+        success &= buffer.insert(next_in++) && buffer.full() && !buffer.overflow();
+        success &= !buffer.insert(0xff) && buffer.overflow() && buffer.size() == capacity;
+        for (std::size_t i = 0; i < capacity; ++i)
+            success &= buffer.get() == next_out++;
+        success &= buffer.empty() && buffer.get() == 0;
+        buffer.clear_overflow();
+        success &= !buffer.overflow();
+        if (!success)
+            std::printf("FAIL the full buffer of capacity %zu did not reject a byte\n", capacity);
+        return success;
+    }
+
+    /// \brief Bulk copies, peeks and reservations split at the end of the buffer memory.
+    bool bulkAndZeroCopy()
+    {
+        memory::byte_ring_buffer<16> buffer;
+        std::uint8_t data[20];
+        for (std::uint8_t i = 0; i < 20; ++i)
+            data[i] = i + 1;
+        // Move the indices close to the end of the memory
+        for (int i = 0; i < 12; ++i)
+            buffer.insert(0);
+        std::uint8_t out[20] = {};
+        bool success = buffer.read(out, 20) == 12;
+
+        // 4 bytes up to the end, 6 from the start of the memory
+        success &= buffer.write(data, 10) == 10 && !buffer.overflow();
+        auto first = buffer.peek_contiguous();
+        success &= first.size == 4 && first.data[0] == 1 && first.data[3] == 4;
+        buffer.commit(first.size);
+        auto second = buffer.peek_contiguous();
+        success &= second.size == 6 && second.data[0] == 5 && second.data[5] == 10;
+        buffer.commit(2);
+        success &= buffer.size() == 4;
+        if (!success)
+            std::puts("FAIL the peeked segments are wrong");
+
+        // Only the free space is written, the rest is dropped
+        bool bulk = buffer.write(data, 20) == 12 && buffer.overflow() && buffer.full();
+        bulk &= buffer.read(out, 20) == 16 && out[0] == 7 && out[3] == 10 && out[4] == 1 && out[15] == 12;
+        bulk &= buffer.read(out, 20) == 0;
+        if (!bulk)
+            std::puts("FAIL the bulk copies are wrong");
+
+        // The reservation ends at the end of the memory as well
+        auto free = buffer.reserve_contiguous();
+        bool reserved = free.size == 14;
+        for (std::uint8_t i = 0; i < free.size; ++i)
+            free.data[i] = 0x80 + i;
+        buffer.publish(free.size);
+        reserved &= buffer.size() == free.size && buffer.get() == 0x80;
+        if (!reserved)
+            std::puts("FAIL the reservation is wrong");
+        return success && bulk && reserved;
+    }
+
+    /// \brief Two bytes, which must be stored word aligned nevertheless.
+    struct Pair
+    {
+        std::uint8_t low;
+        std::uint8_t high;
+    };
+
+    /// \brief Elements other than bytes keep their values, an empty buffer leaves the destination unchanged.
+    bool elementTypes()
+    {
+        memory::ring_buffer<Pair, 8> pairs;
+        bool success = true;
+        for (std::uint8_t i = 0; i < 5; ++i)
+            success &= pairs.insert(Pair{i, static_cast<std::uint8_t>(0x10 + i)});
+        auto peeked = pairs.peek_contiguous();
+        success &= reinterpret_cast<std::uintptr_t>(peeked.data) % 2 == 0;
+        Pair pair{};
+        for (std::uint8_t i = 0; i < 5; ++i)
+            success &= pairs.get(pair) && pair.low == i && pair.high == 0x10 + i;
+        pair = Pair{0xaa, 0xbb};
+        success &= !pairs.get(pair) && pair.low == 0xaa && pair.high == 0xbb;
+
+        memory::ring_buffer<std::uint16_t, 4> words;
+        const std::uint16_t captures[] = {0x1234, 0xfffe, 0x8000};
+        success &= words.write(captures, 3) == 3;
+        std::uint16_t read[3] = {};
+        success &= words.read(read, 3) == 3 && read[0] == 0x1234 && read[1] == 0xfffe && read[2] == 0x8000;
+        success &= words.get() == 0;
+        if (!success)
+            std::puts("FAIL elements other than bytes were corrupted");
+        return success;
+    }
+
+    /// \brief Ranges which wrap around the end of the memory are returned as two segments and released in one go.
+    bool segments()
+    {
+        memory::byte_ring_buffer<8> buffer;
+        const std::uint8_t data[11] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+        std::uint8_t out[8] = {};
+        buffer.write(data, 6);
+        buffer.read(out, 4);
+        buffer.write(data + 6, 5);
+
+        auto unread = buffer.peek_segments();
+        bool success = unread.first.size == 4 && unread.first.data[0] == 4 && unread.first.data[3] == 7;
+        success &= unread.second.size == 3 && unread.second.data[0] == 8 && unread.second.data[2] == 10;
+        // Part of the second segment is consumed as well
+        success &= buffer.commit(5) && buffer.size() == 2;
+
+        auto free = buffer.reserve_segments();
+        success &= free.first.size == 5 && free.second.size == 1;
+        for (std::uint8_t i = 0; i < free.first.size; ++i)
+            free.first.data[i] = static_cast<std::uint8_t>(20 + i);
+        free.second.data[0] = 25;
+        buffer.publish(6);
+        success &= buffer.full() && buffer.read(out, 8) == 8 && out[0] == 9 && out[1] == 10 && out[2] == 20 &&
+                   out[7] == 25;
+        if (!success)
+            std::puts("FAIL split segments did not cover the wrapped range");
+        return success;
+    }
+
+    /// \brief Skipped bytes are removed without being copied, at most the unread ones.
+    bool skip()
+    {
+        memory::byte_ring_buffer<8> buffer;
+        const std::uint8_t data[5] = {0, 1, 2, 3, 4};
+        buffer.write(data, 5);
+        bool success = buffer.skip(3) == 3 && buffer.get() == 3;
+        success &= buffer.skip(10) == 1 && buffer.empty();
+        if (!success)
+            std::puts("FAIL skip removed the wrong bytes");
+        return success;
+    }
+
+    /// \brief The newest bytes survive, a peek which was overwritten in the meantime is reported by commit().
+    bool overwriteOldest()
+    {
+        memory::byte_ring_buffer<8, memory::OverflowPolicy::overwrite_oldest> buffer;
+        std::uint8_t data[12];
+        for (std::uint8_t i = 0; i < 12; ++i)
+            data[i] = i;
+        bool success = buffer.write(data, 6) == 6;
+        auto peeked = buffer.peek_contiguous();
+        success &= peeked.size == 6 && peeked.data[0] == 0;
+        // The producer needs three more bytes than are free and advances the reader past the peeked bytes 0 to 2
+        success &= buffer.write(data + 6, 5) == 5 && buffer.dropped() == 3 && buffer.full();
+        success &= !buffer.commit(2) && buffer.size() == 8 && buffer.get() == 3;
+        // Committing beyond the overwritten bytes moves the reader further
+        peeked = buffer.peek_contiguous();
+        success &= buffer.insert(11) && buffer.insert(12) && buffer.dropped() == 4;
+        success &= !buffer.commit(3) && buffer.get() == 7;
+        if (!success)
+            std::puts("FAIL overwriting the oldest bytes confused the reader");
+
+        // More bytes than the capacity in one write, only the last ones are kept
+        buffer.clear();
+        std::uint8_t out[8] = {};
+        bool newest = buffer.dropped() == 0 && buffer.write(data, 12) == 8 && buffer.dropped() == 4;
+        newest &= buffer.read(out, 8) == 8 && out[0] == 4 && out[7] == 11;
+        if (!newest)
+            std::puts("FAIL an oversized write did not keep the newest bytes");
+        return success && newest;
+    }
+
+    void drainOne();
+
+    using BlockingBuffer = memory::ring_buffer<std::uint8_t, 4, memory::OverflowPolicy::block, drainOne>;
+
+    BlockingBuffer* blocked = nullptr;
+    unsigned waits = 0;
+
+    /// \brief Plays the consumer while the producer waits, one byte per call.
+    void drainOne()
+    {
+        ++waits;
+        blocked->get();
+    }
+
+    /// \brief A full buffer makes the producer wait and call the callback until the consumer made room.
+    bool block()
+    {
+        BlockingBuffer buffer;
+        blocked = &buffer;
+        waits = 0;
+        const std::uint8_t data[6] = {1, 2, 3, 4, 5, 6};
+        bool success = buffer.write(data, 6) == 6 && waits == 2 && buffer.dropped() == 0;
+        success &= buffer.insert(7) && waits == 3;
+        std::uint8_t out[4] = {};
+        success &= buffer.read(out, 4) == 4 && out[0] == 4 && out[3] == 7;
+        if (!success)
+            std::printf("FAIL the blocking buffer waited %u times instead of 3\n", waits);
+        return success;
+    }
+
+    /// \brief The drop counter saturates instead of wrapping around.
+    bool saturatingDrops()
+    {
+        memory::byte_ring_buffer<2> buffer;
+        buffer.insert(1);
+        buffer.insert(2);
+        for (std::uint32_t i = 0; i < 0x10005; ++i)
+            buffer.insert(0);
+        std::uint8_t data[4] = {};
+        buffer.write(data, 4);
+        bool success = buffer.dropped() == 0xffff && buffer.overflow() && buffer.get() == 1;
+        buffer.clear_overflow();
+        success &= buffer.dropped() == 0 && !buffer.overflow();
+        if (!success)
+            std::puts("FAIL the drop counter did not saturate");
+        return success;
+    }
+}
+
+/// Exercises the SPSC ring buffer from a single thread, including the bulk and zero-copy access and the overflow
+/// policies. Fails if bytes get lost, reordered or duplicated, or if the buffer state or the drops are reported
+/// wrongly.
+int main()
+{
+    // Up to 128 bytes the indices are 8 bit wide, the difference of 256 would not fit into them
+    static_assert(std::is_same_v<memory::byte_ring_buffer<128>::index_type, std::uint8_t>);
+    static_assert(std::is_same_v<memory::byte_ring_buffer<256>::index_type, std::uint16_t>);
+
+    bool success = wrapAround<1>();
+    success &= wrapAround<128>();
+    success &= wrapAround<256>();
+    success &= bulkAndZeroCopy();
+    success &= elementTypes();
+    success &= segments();
+    success &= skip();
+    success &= overwriteOldest();
+    success &= block();
+    success &= saturatingDrops();
+    std::puts(success ? "ring_buffer correct" : "ring_buffer failure");
+    return success ? 0 : 1;
+}
@@ -0,0 +1,179 @@
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include <msp430.h>
+
+#include <msp430hal/cpu/clock_module.h>
+#include <msp430hal/host/device.h>
+#include <msp430hal/timer/watchdog_timer.h>
+#include <msp430hal/usci/spi.h>
+
+using namespace msp430hal;
+
+namespace
+{
+    using Spi = usci::SPI_t<usci::UsciModule::usci_b, 0, usci::slave_4pin_active_low>;
+    using SelectPin = gpio::GPIOPin<gpio::port_1, gpio::p_4, gpio::Mode::input>;
+    using Slave = usci::SPISlave<Spi, SelectPin, 64, 4>;
+
+    Slave* slave = nullptr;
+
+    /// \brief Power on at 16 MHz MCLK with a released chip select and attach the ISRs of the slave.
+    void powerOn()
+    {
+        host::Device& device = host::device();
+        device.powerOn();
+        timer::stopWatchdog();
+        cpu::setCalibratedFrequency<cpu::calibrated_16MHz>();
+        device.port(1).drive(BIT4, true);
+        device.attachInterrupt(USCIAB0RX_VECTOR, [] { slave->handleRxInterrupt(); });
+        device.attachInterrupt(USCIAB0TX_VECTOR, [] { slave->handleTxInterrupt(); });
+        device.attachInterrupt(PORT1_VECTOR, [] { slave->handleSelectInterrupt(); });
+    }
+
+    /// \brief Run until the external master finished all frames.
+    void finish()
+    {
+        host::Device& device = host::device();
+        __enable_interrupt();
+        while (device.usciB0().slaveTransferPending())
+            device.execute(10);
+        device.execute(200);
+        __disable_interrupt();
+    }
+
+    std::vector<std::uint8_t> takeFrame()
+    {
+        Slave::FrameView view = slave->frame();
+        std::vector<std::uint8_t> frame(view.first.data, view.first.data + view.first.size);
+        frame.insert(frame.end(), view.second.data, view.second.data + view.second.size);
+        slave->releaseFrame();
+        return frame;
+    }
+
+    const std::vector<std::uint8_t> frame_a{0x10, 0x11, 0x12, 0x13, 0x14};
+    const std::vector<std::uint8_t> frame_b{0x20, 0x21};
+    const std::vector<std::uint8_t> frame_c{0x30};
+
+    void sendFrames(std::uint32_t bit_rate)
+    {
+        host::UsciB& usci = host::device().usciB0();
+        for (const std::vector<std::uint8_t>* frame : {&frame_a, &frame_b, &frame_c})
+            usci.slaveTransfer(frame->data(), frame->size(), bit_rate);
+    }
+
+    /// \brief Back to back frames whose chip select is released for 100 MCLK cycles (one bit at 160 kHz) are
+    /// separated, and the response is sent in the first one.
+    bool separatesFrames()
+    {
+        powerOn();
+        Slave spi_slave;
+        spi_slave.init();
+        slave = &spi_slave;
+        const std::uint8_t response[] = {0xa0, 0xa1};
+        spi_slave.setResponse(response, sizeof(response), 0x5a);
+        sendFrames(160000);
+        finish();
+
+        bool success = spi_slave.frames() == 3 && spi_slave.missedBoundaries() == 0;
+        success &= takeFrame() == frame_a && takeFrame() == frame_b && takeFrame() == frame_c;
+        const std::vector<std::uint8_t>& sent = host::device().usciB0().slaveResponses();
+        success &= sent.size() == 8 && sent[0] == 0xa0 && sent[1] == 0xa1 && sent[2] == 0x5a;
+        if (!success)
+            std::puts("FAIL frames with the minimum chip select high time were not separated");
+        return success;
+    }
+
+    /// \brief A response set between two frames is sent from the first character of the next frame on, a frame
+    /// without a new response only gets the fill character.
+    bool responseBetweenFrames()
+    {
+        powerOn();
+        Slave spi_slave;
+        spi_slave.init();
+        slave = &spi_slave;
+        host::UsciB& usci = host::device().usciB0();
+        const std::uint8_t first[] = {0xa0, 0xa1};
+        spi_slave.setResponse(first, sizeof(first), 0x5a);
+        usci.slaveTransfer(frame_b.data(), frame_b.size(), 160000);
+        finish();
+
+        // The end of the previous frame preloaded the fill character already
+        const std::uint8_t second[] = {0xb0, 0xb1, 0xb2};
+        spi_slave.setResponse(second, sizeof(second), 0x6b);
+        usci.slaveTransfer(frame_a.data(), frame_a.size(), 160000);
+        usci.slaveTransfer(frame_c.data(), frame_c.size(), 160000);
+        finish();
+
+        const std::vector<std::uint8_t> expected{0xa0, 0xa1, 0xb0, 0xb1, 0xb2, 0x6b, 0x6b, 0x6b};
+        bool success = usci.slaveResponses() == expected && spi_slave.frames() == 3;
+        if (!success)
+        {
+            std::printf("FAIL responses:");
+            for (std::uint8_t byte : usci.slaveResponses())
+                std::printf(" %02x", byte);
+            std::puts("");
+        }
+        return success;
+    }
+
+    /// \brief At 4 MHz the chip select is released for only 4 MCLK cycles. No frame may contain characters of two
+    /// frames, the missed boundary is counted and the next frame after a pause is received again.
+    bool discardsMergedFrames()
+    {
+        powerOn();
+        Slave spi_slave;
+        spi_slave.init();
+        slave = &spi_slave;
+        sendFrames(4000000);
+        finish();
+
+        bool success = spi_slave.missedBoundaries() != 0;
+        while (spi_slave.frames() != 0)
+        {
+            std::vector<std::uint8_t> frame = takeFrame();
+            success &= frame == frame_a || frame == frame_b || frame == frame_c;
+        }
+        host::device().usciB0().slaveTransfer(frame_b.data(), frame_b.size(), 4000000);
+        finish();
+        success &= spi_slave.frames() == 1 && takeFrame() == frame_b;
+        std::printf("missed boundaries at 4 MHz: %u\n", spi_slave.missedBoundaries());
+        if (!success)
+            std::puts("FAIL frames separated by a too short chip select high time were merged");
+        return success;
+    }
+
+    /// \brief A frame arriving while max_frames frames wait is dropped and counted without occupying a slot.
+    bool countsDroppedFrames()
+    {
+        powerOn();
+        Slave spi_slave;
+        spi_slave.init();
+        slave = &spi_slave;
+        for (std::uint8_t i = 0; i < 5; ++i)
+            host::device().usciB0().slaveTransfer(&i, 1, 100000);
+        finish();
+
+        bool success = spi_slave.frames() == 4 && spi_slave.droppedFrames() == 1;
+        for (std::uint8_t i = 0; i < 4; ++i)
+            success &= takeFrame() == std::vector<std::uint8_t>{i};
+        success &= spi_slave.frames() == 0;
+        if (!success)
+            std::puts("FAIL the dropped frame was not counted");
+        return success;
+    }
+}
+
+/// Feeds frames of an external master into the interrupt driven SPI slave at 16 MHz MCLK. Fails if frames are not
+/// separated at the documented minimum chip select high time, if characters of two frames end up in one frame, or if
+/// dropped frames are not counted.
+int main()
+{
+    bool success = separatesFrames();
+    success &= responseBetweenFrames();
+    success &= discardsMergedFrames();
+    success &= countsDroppedFrames();
+    std::puts(success ? "SPISlave correct" : "SPISlave failure");
+    return success ? 0 : 1;
+}
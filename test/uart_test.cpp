@@ -0,0 +1,305 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <msp430.h>
+
+#include <msp430hal/cpu/clock_module.h>
+#include <msp430hal/gpio/pin.h>
+#include <msp430hal/host/device.h>
+#include <msp430hal/timer/watchdog_timer.h>
+#include <msp430hal/usci/uart.h>
+
+using namespace msp430hal;
+
+namespace
+{
+    using Uart = usci::UART_t<0, 115200, 16000000, usci::smclk>;
+
+    template<typename Driver>
+    Driver* driver = nullptr;
+    unsigned rx_interrupts = 0;
+
+    /// \brief Power on at 16 MHz MCLK and attach the receive and transmit ISRs of the driver.
+    template<typename Driver>
+    void powerOn()
+    {
+        host::Device& device = host::device();
+        device.powerOn();
+        timer::stopWatchdog();
+        cpu::setCalibratedFrequency<cpu::calibrated_16MHz>();
+        rx_interrupts = 0;
+        device.attachInterrupt(USCIAB0RX_VECTOR, []
+        {
+            ++rx_interrupts;
+            driver<Driver>->handleRxInterrupt();
+        });
+        device.attachInterrupt(USCIAB0TX_VECTOR, [] { driver<Driver>->handleTxInterrupt(); });
+    }
+
+    /// \brief Run with interrupts enabled for the given number of characters.
+    void run(std::size_t characters)
+    {
+        __enable_interrupt();
+        // A character takes 1389 MCLK cycles at 115200 baud
+        host::device().execute(1400 * static_cast<std::uint32_t>(characters + 1));
+        __disable_interrupt();
+    }
+
+    /// \brief Let an external device send the characters and run until they were received.
+    void receive(const char* data)
+    {
+        host::device().usciA0().receive(reinterpret_cast<const std::uint8_t*>(data), std::strlen(data));
+        run(std::strlen(data));
+    }
+
+    using Buffered = usci::BufferedUART<Uart, 16>;
+
+    /// \brief The driver only configures the USCI in init(), then moves bytes in both directions.
+    bool bufferedUart()
+    {
+        powerOn<Buffered>();
+        Buffered uart;
+        driver<Buffered> = &uart;
+        bool success = (UCA0CTL1 & UCSWRST) && !(IE2 & UCA0RXIE);
+        if (!success)
+            std::puts("FAIL constructing BufferedUART changed the USCI");
+        uart.init();
+
+        const char hello[] = "hello";
+        uart.write(reinterpret_cast<const std::uint8_t*>(hello), 5);
+        run(5);
+        const std::vector<std::uint8_t>& sent = host::device().usciA0().transmitted();
+        receive("world");
+        char received[8] = {};
+        std::size_t length = uart.read(reinterpret_cast<std::uint8_t*>(received), sizeof(received));
+        if (std::string(sent.begin(), sent.end()) != hello || length != 5 || std::string(received) != "world")
+        {
+            std::puts("FAIL BufferedUART lost or corrupted bytes");
+            success = false;
+        }
+        return success;
+    }
+
+    using MultiprocessorUart = usci::MultiprocessorUART<usci::UART_t<0, 115200, 16000000, usci::smclk, false, false,
+                                                                      false, false, false, false,
+                                                                      usci::address_bit_multiprocessor>, 16>;
+
+    /// \brief Only data after the own address is received, characters for other nodes cause no interrupt. Address
+    /// characters are sent with the address bit at their place in the transmit buffer.
+    bool multiprocessorUart()
+    {
+        powerOn<MultiprocessorUart>();
+        MultiprocessorUart uart(0x12);
+        driver<MultiprocessorUart> = &uart;
+        uart.init();
+
+        host::UsciA& usci = host::device().usciA0();
+        const host::UartFrame frames[] = {{0x34, true}, {'x'}, {'y'}, {0x12, true}, {'a'}, {'b'},
+                                          {0x56, true}, {'z'}, {0x12, true}, {'c'}};
+        for (const host::UartFrame& frame : frames)
+            usci.receive(frame);
+        // An address character has twelve bits
+        run(2 * std::size(frames));
+        char received[8] = {};
+        uart.read(reinterpret_cast<std::uint8_t*>(received), sizeof(received));
+        bool success = std::string(received) == "abc" && uart.selected();
+        // The four address characters and the three data characters after the own address
+        if (!success || rx_interrupts != 7)
+        {
+            std::printf("FAIL MultiprocessorUART received \"%s\" with %u interrupts\n", received, rx_interrupts);
+            success = false;
+        }
+
+        uart.write('p');
+        uart.writeAddress(0x21);
+        uart.write('q');
+        run(4);
+        const std::vector<host::UartFrame>& sent = usci.transmittedFrames();
+        if (sent.size() != 3 || sent[0].data != 'p' || sent[0].address || sent[1].data != 0x21 || !sent[1].address ||
+            sent[2].data != 'q' || sent[2].address)
+        {
+            std::puts("FAIL MultiprocessorUART sent the address at the wrong place");
+            success = false;
+        }
+        return success;
+    }
+
+    using Rts = gpio::GPIOPin<gpio::port_2, gpio::p_0>;
+    using Cts = gpio::GPIOPin<gpio::port_2, gpio::p_1, gpio::Mode::input>;
+    using FlowUart = usci::FlowControlledUART<Uart, Rts, Cts, 16>;
+
+    /// \brief RTS follows the watermarks of the receive buffer, a deasserted CTS stops the transmitter until it is
+    /// asserted again.
+    bool flowControlledUart()
+    {
+        powerOn<FlowUart>();
+        host::device().attachInterrupt(PORT2_VECTOR, [] { driver<FlowUart>->handleCtsInterrupt(); });
+        FlowUart uart;
+        driver<FlowUart> = &uart;
+        host::GpioPort& port = host::device().port(2);
+        port.drive(Cts::pins_value, false);
+        uart.init();
+
+        // RTS is deasserted at 12 bytes and asserted again once no more than 4 are left
+        bool success = uart.requestToSend();
+        receive("0123456789ab");
+        success &= !uart.requestToSend() && (port.level() & Rts::pins_value);
+        std::uint8_t data[7];
+        uart.read(data, sizeof(data));
+        success &= !uart.requestToSend();
+        uart.read(data[0]);
+        success &= uart.requestToSend() && !(port.level() & Rts::pins_value) && uart.available() == 4;
+        if (!success)
+            std::puts("FAIL RTS does not follow the watermarks");
+
+        const std::vector<std::uint8_t>& sent = host::device().usciA0().transmitted();
+        const char text[] = "flow control";
+        uart.write(reinterpret_cast<const std::uint8_t*>(text), 12);
+        run(3);
+        port.drive(Cts::pins_value, true);
+        std::size_t stopped_at = sent.size();
+        run(12);
+        // The characters in the transmit and shift register still go out
+        bool stopped = sent.size() <= stopped_at + 2 && sent.size() < 12;
+        port.drive(Cts::pins_value, false);
+        run(12);
+        if (!stopped || std::string(sent.begin(), sent.end()) != text)
+        {
+            std::printf("FAIL CTS did not stop the transmitter, %zu of 12 characters sent\n", sent.size());
+            success = false;
+        }
+        return success;
+    }
+
+    using AutoBaudUart = usci::UART_t<0, 9600, 16000000, usci::smclk, false, false, false, false, false, false,
+                                      usci::uart_automatic_baud>;
+
+    /// \brief A break/synch sequence from a master running 2 % fast reprograms the divider, an overlong break is
+    /// reported as timeout.
+    bool automaticBaudRate()
+    {
+        host::Device& device = host::device();
+        device.powerOn();
+        timer::stopWatchdog();
+        cpu::setCalibratedFrequency<cpu::calibrated_16MHz>();
+        AutoBaudUart::init();
+        AutoBaudUart::enable();
+        AutoBaudUart::enableAutomaticBaudRateDetection();
+
+        // The synch field measures 16 MHz / 9800 baud = 1632.65 BRCLK periods per bit, in eighths 13061
+        device.usciA0().receiveBreakSync(9800);
+        device.execute(45000);
+        usci::BaudRateSetting measured = AutoBaudUart::readBaudRateSetting();
+        bool success = UCA0BR0 == 0x60 && UCA0BR1 == 0x06 && UCA0MCTL == (5 << 1);
+        success &= measured.ucbr == 1632 && measured.ucbrs == 5 && !measured.oversampling;
+        success &= !AutoBaudUart::breakTimeoutError() && !AutoBaudUart::syncTimeoutError();
+        if (!success)
+            std::printf("FAIL measured UCBR %u UCBRS %u instead of 1632 and 5\n", measured.ucbr, measured.ucbrs);
+
+        AutoBaudUart::restoreBaudRate();
+        success &= UCA0BR0 == (AutoBaudUart::ucbr_value() & 0xff) && UCA0BR1 == (AutoBaudUart::ucbr_value() >> 8) &&
+                   UCA0MCTL == (AutoBaudUart::ucbrs_value() << 1);
+        device.usciA0().receiveBreakSync(9800, 30);
+        device.execute(60000);
+        if (!AutoBaudUart::breakTimeoutError())
+        {
+            std::puts("FAIL a 30 bit break was not reported");
+            success = false;
+        }
+        return success;
+    }
+
+    /// \brief A row of the USCI_A baud rate table for UCOS16 = 0 in the family user's guide.
+    struct TableRow
+    {
+        std::uint32_t brclk;
+        std::uint32_t baud_rate;
+        std::uint16_t ucbr;
+        std::uint8_t ucbrs;
+    };
+
+    /// \brief The search finds the prescaler of the table, and the table's UCBRSx or one with a smaller error.
+    ///
+    /// The table does not always pick the UCBRSx with the smallest worst case error, e.g. 115200 baud from 1 MHz has
+    /// UCBRS 6 with a receive error of 16.1 % while UCBRS 5 stays at 14.8 %.
+    bool baudRateTable()
+    {
+        const TableRow table[] = {{1048576, 9600, 109, 2}, {1000000, 9600, 104, 1}, {1000000, 19200, 52, 0},
+                                  {1000000, 38400, 26, 0}, {1000000, 56000, 17, 7}, {1000000, 115200, 8, 6},
+                                  {4000000, 9600, 416, 6}, {8000000, 9600, 833, 2}, {8000000, 115200, 69, 4},
+                                  {12000000, 9600, 1250, 0}, {12000000, 115200, 104, 1}, {16000000, 9600, 1666, 6},
+                                  {16000000, 38400, 416, 6}, {16000000, 57600, 277, 7}, {16000000, 115200, 138, 7},
+                                  {16000000, 230400, 69, 4}};
+        bool success = true;
+        for (const TableRow& row : table)
+        {
+            usci::BaudRateSetting found = usci::findBaudRateSetting(row.brclk, row.baud_rate, 10, false);
+            double table_error = usci::baudRateError(row.brclk, row.baud_rate, 10, row.ucbr, row.ucbrs, 0, false);
+            if (found.ucbr != row.ucbr || found.oversampling || found.max_error_percent > table_error)
+            {
+                std::printf("FAIL %lu baud from %lu Hz: UCBR %u UCBRS %u (%.2f %%) instead of %u %u (%.2f %%)\n",
+                            static_cast<unsigned long>(row.baud_rate), static_cast<unsigned long>(row.brclk),
+                            found.ucbr, found.ucbrs, found.max_error_percent, row.ucbr, row.ucbrs, table_error);
+                success = false;
+            }
+        }
+
+        // The default limit accepts the fast rates from 16 MHz, but not 115200 baud from 1 MHz
+        static_assert(usci::UART_t<0, 230400, 16000000>::ucbr_value() == 69);
+        static_assert(usci::UART_t<0, 230400, 16000000>::ucbrs_value() == 4);
+        static_assert(usci::findBaudRateSetting(1000000, 115200, 10, false).max_error_percent > 5);
+        return success;
+    }
+
+    using LineUart = usci::LineBufferedUART<Uart, 32, 2, 32, '\n', 4>;
+
+    std::string takeLine(LineUart& uart)
+    {
+        LineUart::LineView view = uart.line();
+        std::string line(view.first.data, view.first.data + view.first.size);
+        line.append(view.second.data, view.second.data + view.second.size);
+        uart.releaseLine();
+        return line;
+    }
+
+    /// \brief Lines beyond max_lines are dropped and counted, overlong lines are truncated.
+    bool lineBufferedUart()
+    {
+        powerOn<LineUart>();
+        LineUart line_uart;
+        line_uart.init();
+        driver<LineUart> = &line_uart;
+
+        receive("ab\ncd\nef\n");
+        bool success = line_uart.lines() == 2 && line_uart.droppedLines() == 1;
+        success &= takeLine(line_uart) == "ab";
+        receive("123456\n");
+        success &= line_uart.lines() == 2 && line_uart.droppedLines() == 1 && line_uart.truncatedLines() == 1;
+        success &= takeLine(line_uart) == "cd" && takeLine(line_uart) == "1234" && line_uart.lines() == 0;
+        line_uart.clearStatistics();
+        success &= line_uart.droppedLines() == 0 && line_uart.truncatedLines() == 0;
+        if (!success)
+            std::puts("FAIL LineBufferedUART lost, merged or miscounted lines");
+        return success;
+    }
+}
+
+/// Feeds received characters into the interrupt driven UART drivers at 16 MHz MCLK and checks what the main loop
+/// gets out of them, including the statistics of dropped and truncated data, and how the drivers control the
+/// transmitter with addresses and RTS/CTS. Also checks the automatic baud rate detection and compares the baud rate
+/// search with the table of the user's guide.
+int main()
+{
+    bool success = bufferedUart();
+    success &= multiprocessorUart();
+    success &= flowControlledUart();
+    success &= lineBufferedUart();
+    success &= automaticBaudRate();
+    success &= baudRateTable();
+    std::puts(success ? "UART drivers correct" : "UART driver failure");
+    return success ? 0 : 1;
+}